@@ -1229,3 +1229,67 @@ BM_Action_trx_sig_digest(benchmark::State& state) {
     state.SetItemsProcessed(state.iterations());
 }
 BENCHMARK(BM_Action_trx_sig_digest)->Range(1, 8 << 10);
+
+static void
+BM_Action_packed_trx_sig_digest(benchmark::State& state) {
+    auto tester = create_tester();
+
+    auto newdomain_var = fc::json::from_string(ndjson);
+    auto newdom        = newdomain_var.as<newdomain>();
+    newdom.name        = get_nonce_name("");
+    newdom.creator     = evt::testing::tester::get_public_key("evt");
+
+    newdom.issue.authorizers[0].ref.set_account(evt::testing::tester::get_public_key("evt"));
+    newdom.manage.authorizers[0].ref.set_account(evt::testing::tester::get_public_key("evt"));
+    newdom.transfer.authorizers[0].ref.set_account(evt::testing::tester::get_public_key("evt"));
+
+    auto trx = signed_transaction();
+
+    for(auto _ : state) {
+        state.PauseTiming();
+
+        for(int i = 0; i < state.range(0); i++) {
+            newdom.name = get_nonce_name("");
+            trx.actions.push_back(action(newdom.name, N128(.create), newdom));
+        }
+
+        auto chain_id = tester->control->get_chain_id();
+        auto ptrx     = packed_transaction(trx);
+
+        state.ResumeTiming();
+
+        auto digest = ptrx.sig_digest(chain_id);
+        (void)digest;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Action_packed_trx_sig_digest)->Range(1, 8 << 10);
+
+static void
+BM_Action_trx_id(benchmark::State& state) {
+    auto tester = create_tester();
+
+    auto newdomain_var = fc::json::from_string(ndjson);
+    auto newdom        = newdomain_var.as<newdomain>();
+    newdom.name        = get_nonce_name("");
+    newdom.creator     = evt::testing::tester::get_public_key("evt");
+
+    newdom.issue.authorizers[0].ref.set_account(evt::testing::tester::get_public_key("evt"));
+    newdom.manage.authorizers[0].ref.set_account(evt::testing::tester::get_public_key("evt"));
+    newdom.transfer.authorizers[0].ref.set_account(evt::testing::tester::get_public_key("evt"));
+
+    auto trx = signed_transaction();
+    for(int i = 0; i < state.range(0); i++) {
+        newdom.name = get_nonce_name("");
+        trx.actions.push_back(action(newdom.name, N128(.create), newdom));
+    }
+    auto packed = fc::raw::pack(packed_transaction(trx));
+
+    // unpacking includes hashing the id from the packed bytes
+    for(auto _ : state) {
+        auto ptrx = fc::raw::unpack<packed_transaction>(packed);
+        benchmark::DoNotOptimize(ptrx.id());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Action_trx_id)->Range(1, 8 << 10);
@@ -68,3 +68,45 @@ BM_ECC_VerifySignature(benchmark::State& state) {
     state.SetItemsProcessed(state.iterations());
 }
 BENCHMARK(BM_ECC_VerifySignature);
+
+static void
+BM_ECC_RecoverSignatures(benchmark::State& state) {
+    auto n      = (size_t)state.range(0);
+    auto digest = sha256::hash(std::string("recover"));
+    auto sigs   = std::vector<signature>();
+    for(auto i = 0u; i < n; i++) {
+        sigs.emplace_back(private_key::generate().sign(digest));
+    }
+
+    // measure the recovering itself
+    set_recovery_cache_capacity(0);
+    for(auto _ : state) {
+        for(auto& sig : sigs) {
+            benchmark::DoNotOptimize(public_key(sig, digest));
+        }
+    }
+    set_recovery_cache_capacity(64 * 1024);
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_ECC_RecoverSignatures)->Range(1, 256);
+
+static void
+BM_ECC_RecoverSignaturesCached(benchmark::State& state) {
+    auto n      = (size_t)state.range(0);
+    auto digest = sha256::hash(std::string("recover"));
+    auto sigs   = std::vector<signature>();
+    for(auto i = 0u; i < n; i++) {
+        sigs.emplace_back(private_key::generate().sign(digest));
+    }
+
+    // all hits after the first iteration
+    for(auto _ : state) {
+        for(auto& sig : sigs) {
+            benchmark::DoNotOptimize(public_key(sig, digest));
+        }
+    }
+    auto m = get_recovery_cache_metrics();
+    state.counters["hit_rate"] = (double)m.hit / (m.hit + m.miss);
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_ECC_RecoverSignaturesCached)->Range(1, 256);
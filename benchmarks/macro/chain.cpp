@@ -0,0 +1,240 @@
+/**
+ *  @file
+ *  @copyright defined in evt/LICENSE.txt
+ */
+#include <benchmark/benchmark.h>
+#include <sstream>
+#include <evt/chain/snapshot.hpp>
+#include <evt/chain/token_database.hpp>
+#include "synthetic_chain.hpp"
+
+/*
+ * End-to-end benchmarks of a node upon the synthetic chain
+ */
+
+using namespace evt::chain;
+
+static fc::path
+reset_node_dir(const char* name) {
+    auto dir = get_synthetic_chain().config().dir / name;
+    if(fc::exists(dir)) {
+        fc::remove_all(dir);
+    }
+    fc::create_directories(dir);
+    return dir;
+}
+
+static std::unique_ptr<controller>
+open_node(const controller::config& cfg, const snapshot_reader_ptr& snapshot = nullptr) {
+    auto node = std::make_unique<controller>(cfg);
+    node->add_indices();
+    node->startup(snapshot);
+    return node;
+}
+
+static void
+BM_Chain_PushTransaction(benchmark::State& state) {
+    auto& chain = get_synthetic_chain();
+    auto  n     = chain.config().trxs_per_block;
+
+    for(auto _ : state) {
+        state.PauseTiming();
+        auto trxs = chain.make_transfers(n);
+        state.ResumeTiming();
+
+        auto failed = chain.push_transactions(trxs);
+
+        state.PauseTiming();
+        chain.produce_block();
+        if(failed > 0) {
+            state.SkipWithError("transactions failed");
+            break;
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_Chain_PushTransaction)->Unit(benchmark::kMillisecond);
+
+static void
+BM_Chain_ApplyBlock(benchmark::State& state) {
+    auto& chain = get_synthetic_chain();
+    auto  n     = chain.config().trxs_per_block;
+
+    // validating node catches up the synthetic chain first
+    auto dir  = reset_node_dir("validator");
+    auto node = open_node(chain.node_config(dir));
+    auto sync = [&] {
+        for(auto i = node->head_block_num() + 1; i <= chain.control().head_block_num(); i++) {
+            node->push_block(chain.control().fetch_block_by_number(i));
+        }
+    };
+    sync();
+
+    for(auto _ : state) {
+        state.PauseTiming();
+        auto failed = chain.push_transactions(chain.make_transfers(n));
+        auto block  = chain.produce_block();
+        if(failed > 0) {
+            state.SkipWithError("transactions failed");
+            break;
+        }
+        state.ResumeTiming();
+
+        node->push_block(block);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.counters["blocks_per_second"] = benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Chain_ApplyBlock)->Unit(benchmark::kMillisecond);
+
+static void
+BM_Chain_Replay(benchmark::State& state) {
+    auto& chain = get_synthetic_chain();
+
+    // block log is flushed on every appending, so it's safe to copy while the chain is open
+    auto src    = chain.blocks_dir();
+    auto blocks = uint32_t(0);
+
+    for(auto _ : state) {
+        state.PauseTiming();
+        auto dir = reset_node_dir("replay");
+        fc::create_directories(dir / "blocks");
+        fc::copy(src / "blocks.log", dir / "blocks" / "blocks.log");
+        fc::copy(src / "blocks.index", dir / "blocks" / "blocks.index");
+        state.ResumeTiming();
+
+        auto node = open_node(chain.node_config(dir));
+
+        state.PauseTiming();
+        blocks = node->head_block_num();
+        node.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * blocks);
+    state.counters["blocks"] = blocks;
+}
+BENCHMARK(BM_Chain_Replay)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void
+BM_Chain_SnapshotWrite(benchmark::State& state) {
+    auto& chain = get_synthetic_chain();
+    chain.control().abort_block();
+
+    auto bytes = size_t(0);
+    for(auto _ : state) {
+        auto ss     = std::stringstream();
+        auto writer = std::make_shared<chunked_snapshot_writer>(ss);
+        chain.control().write_snapshot(writer);
+        writer->finalize();
+
+        bytes = ss.tellp();
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_Chain_SnapshotWrite)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void
+BM_Chain_SnapshotRead(benchmark::State& state) {
+    auto& chain = get_synthetic_chain();
+    chain.control().abort_block();
+
+    auto snapshot = std::string();
+    {
+        auto ss     = std::stringstream();
+        auto writer = std::make_shared<chunked_snapshot_writer>(ss);
+        chain.control().write_snapshot(writer);
+        writer->finalize();
+        snapshot = ss.str();
+    }
+
+    for(auto _ : state) {
+        state.PauseTiming();
+        auto dir    = reset_node_dir("snapshot");
+        auto ss     = std::stringstream(snapshot);
+        auto reader = make_snapshot_reader(ss);
+        state.ResumeTiming();
+
+        auto node = open_node(chain.node_config(dir), reader);
+
+        state.PauseTiming();
+        node.reset();
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(state.iterations() * snapshot.size());
+}
+BENCHMARK(BM_Chain_SnapshotRead)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void
+BM_Chain_TokenDB_Read(benchmark::State& state) {
+    auto& chain   = get_synthetic_chain();
+    auto& cfg     = chain.config();
+    auto& tokendb = chain.control().token_db();
+
+    auto rng    = std::mt19937_64(cfg.seed);
+    auto domain = std::uniform_int_distribution<uint32_t>(0, cfg.domains - 1);
+    auto token  = std::uniform_int_distribution<uint32_t>(0, cfg.tokens - 1);
+
+    auto str = std::string();
+    for(auto _ : state) {
+        auto d = name128(std::string("syndomain") + std::to_string(domain(rng)));
+        tokendb.read_token(token_type::token, d, name128::from_number(token(rng)), str);
+        benchmark::DoNotOptimize(str);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Chain_TokenDB_Read);
+
+// puts `n` random tokens of synthetic domains with their current values
+static void
+put_random_tokens(token_database& tokendb, std::mt19937_64& rng, size_t n) {
+    auto& cfg    = get_synthetic_chain().config();
+    auto  domain = std::uniform_int_distribution<uint32_t>(0, cfg.domains - 1);
+    auto  token  = std::uniform_int_distribution<uint32_t>(0, cfg.tokens - 1);
+
+    auto str = std::string();
+    for(auto i = 0u; i < n; i++) {
+        auto d = name128(std::string("syndomain") + std::to_string(domain(rng)));
+        auto t = name128::from_number(token(rng));
+        tokendb.read_token(token_type::token, d, t, str);
+        tokendb.put_token(token_type::token, action_op::update, d, t, str);
+    }
+}
+
+static void
+BM_Chain_TokenDB_Write(benchmark::State& state) {
+    auto& chain   = get_synthetic_chain();
+    auto& tokendb = chain.control().token_db();
+    auto  rng     = std::mt19937_64(chain.config().seed);
+    chain.control().abort_block();
+
+    for(auto _ : state) {
+        auto session = tokendb.new_savepoint_session();
+        put_random_tokens(tokendb, rng, state.range(0));
+
+        state.PauseTiming();
+        session.undo();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Chain_TokenDB_Write)->Range(64, 8 << 10);
+
+static void
+BM_Chain_TokenDB_Rollback(benchmark::State& state) {
+    auto& chain   = get_synthetic_chain();
+    auto& tokendb = chain.control().token_db();
+    auto  rng     = std::mt19937_64(chain.config().seed);
+    chain.control().abort_block();
+
+    for(auto _ : state) {
+        state.PauseTiming();
+        auto session = tokendb.new_savepoint_session();
+        put_random_tokens(tokendb, rng, state.range(0));
+        state.ResumeTiming();
+
+        session.undo();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Chain_TokenDB_Rollback)->Range(64, 8 << 10);
@@ -0,0 +1,69 @@
+/**
+ *  @file
+ *  @copyright defined in evt/LICENSE.txt
+ */
+#include <string>
+#include <string_view>
+#include <benchmark/benchmark.h>
+#include "synthetic_chain.hpp"
+
+/*
+ * Shape of the synthetic chain is set by the `--chain_*` options below,
+ * all the other options are passed to google benchmark.
+ * Use `--benchmark_format=json` (or `--benchmark_out=<file>`) for machine-readable results,
+ * the chain options are recorded in the context of the output.
+ */
+
+static bool
+parse_chain_option(std::string_view arg) {
+    auto& cfg = get_synthetic_chain_config();
+
+    auto opts = {
+        std::make_pair("--chain_domains=", &cfg.domains),
+        std::make_pair("--chain_tokens=", &cfg.tokens),
+        std::make_pair("--chain_holders=", &cfg.holders),
+        std::make_pair("--chain_groups=", &cfg.groups),
+        std::make_pair("--chain_trxs_per_block=", &cfg.trxs_per_block),
+        std::make_pair("--chain_seed=", &cfg.seed)
+    };
+    for(auto& opt : opts) {
+        auto prefix = std::string_view(opt.first);
+        if(arg.substr(0, prefix.size()) == prefix) {
+            *opt.second = std::stoul(std::string(arg.substr(prefix.size())));
+            return true;
+        }
+    }
+
+    auto prefix = std::string_view("--chain_dir=");
+    if(arg.substr(0, prefix.size()) == prefix) {
+        cfg.dir = std::string(arg.substr(prefix.size()));
+        return true;
+    }
+    return false;
+}
+
+int
+main(int argc, char** argv) {
+    auto n = 1;
+    for(auto i = 1; i < argc; i++) {
+        if(!parse_chain_option(argv[i])) {
+            argv[n++] = argv[i];
+        }
+    }
+    argc = n;
+
+    auto& cfg = get_synthetic_chain_config();
+    benchmark::AddCustomContext("chain_domains", std::to_string(cfg.domains));
+    benchmark::AddCustomContext("chain_tokens", std::to_string(cfg.tokens));
+    benchmark::AddCustomContext("chain_holders", std::to_string(cfg.holders));
+    benchmark::AddCustomContext("chain_groups", std::to_string(cfg.groups));
+    benchmark::AddCustomContext("chain_trxs_per_block", std::to_string(cfg.trxs_per_block));
+    benchmark::AddCustomContext("chain_seed", std::to_string(cfg.seed));
+
+    benchmark::Initialize(&argc, argv);
+    if(benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
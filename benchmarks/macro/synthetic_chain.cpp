@@ -0,0 +1,323 @@
+/**
+ *  @file
+ *  @copyright defined in evt/LICENSE.txt
+ */
+#include "synthetic_chain.hpp"
+
+#include <fc/io/json.hpp>
+#include <evt/chain/contracts/types.hpp>
+
+using namespace evt::chain;
+using namespace evt::chain::contracts;
+using evt::testing::tester;
+
+static const char* ndjson = R"=====(
+{
+  "name" : "cookie",
+  "creator" : "EVT546WaW3zFAxEEEkYKjDiMvg3CHRjmWX2XdNxEhi69RpdKuQRSK",
+  "issue" : {
+    "name" : "issue",
+    "threshold" : 1,
+    "authorizers": [{
+        "ref": "[A] EVT546WaW3zFAxEEEkYKjDiMvg3CHRjmWX2XdNxEhi69RpdKuQRSK",
+        "weight": 1
+      }
+    ]
+  },
+  "transfer": {
+    "name": "transfer",
+    "threshold": 1,
+    "authorizers": [{
+        "ref": "[G] .OWNER",
+        "weight": 1
+      }
+    ]
+  },
+  "manage": {
+    "name": "manage",
+    "threshold": 1,
+    "authorizers": [{
+        "ref": "[A] EVT546WaW3zFAxEEEkYKjDiMvg3CHRjmWX2XdNxEhi69RpdKuQRSK",
+        "weight": 1
+      }
+    ]
+  }
+}
+)=====";
+
+static const char* ngjson = R"=====(
+{
+  "name" : "5jxX",
+  "group" : {
+    "name": "5jxXg",
+    "key": "EVT6MRyAjQq8ud7hVNYcfnVPJqcVpscN5So8BhtHuGYqET5GDW5CV",
+    "root": {
+      "threshold": 6,
+      "weight": 0,
+      "nodes": [{
+          "type": "branch",
+          "threshold": 1,
+          "weight": 3,
+          "nodes": [{
+              "key": "EVT6MRyAjQq8ud7hVNYcfnVPJqcVpscN5So8BhtHuGYqET5GDW5CV",
+              "weight": 1
+            },{
+              "key": "EVT8MGU4aKiVzqMtWi9zLpu8KuTHZWjQQrX475ycSxEkLd6aBpraX",
+              "weight": 1
+            }
+          ]
+        },{
+          "key": "EVT8MGU4aKiVzqMtWi9zLpu8KuTHZWjQQrX475ycSxEkLd6aBpraX",
+          "weight": 3
+        },{
+          "threshold": 1,
+          "weight": 3,
+          "nodes": [{
+              "key": "EVT6MRyAjQq8ud7hVNYcfnVPJqcVpscN5So8BhtHuGYqET5GDW5CV",
+              "weight": 1
+            },{
+              "key": "EVT8MGU4aKiVzqMtWi9zLpu8KuTHZWjQQrX475ycSxEkLd6aBpraX",
+              "weight": 2
+            }
+          ]
+        }
+      ]
+    }
+  }
+}
+)=====";
+
+static const char* nfjson = R"=====(
+{
+  "name": "SYN",
+  "sym_name": "SYN",
+  "sym": "5,S#3",
+  "creator": "EVT6MRyAjQq8ud7hVNYcfnVPJqcVpscN5So8BhtHuGYqET5GDW5CV",
+  "issue" : {
+    "name" : "issue",
+    "threshold" : 1,
+    "authorizers": [{
+        "ref": "[A] EVT546WaW3zFAxEEEkYKjDiMvg3CHRjmWX2XdNxEhi69RpdKuQRSK",
+        "weight": 1
+      }
+    ]
+  },
+  "manage": {
+    "name": "manage",
+    "threshold": 1,
+    "authorizers": [{
+        "ref": "[A] EVT546WaW3zFAxEEEkYKjDiMvg3CHRjmWX2XdNxEhi69RpdKuQRSK",
+        "weight": 1
+      }
+    ]
+  },
+  "total_supply":"1000000000.00000 S#3"
+}
+)=====";
+
+synthetic_chain::synthetic_chain(const synthetic_chain_config& cfg)
+    : cfg_(cfg)
+    , rng_(cfg.seed)
+    , sym_(5, 3) {
+    fc::logger::get().set_log_level(fc::log_level(fc::log_level::error));
+
+    auto dir = cfg_.dir / "chain";
+    if(fc::exists(dir)) {
+        fc::remove_all(dir);
+    }
+    fc::create_directories(dir);
+
+    auto ccfg = controller::config();
+
+    ccfg.blocks_dir            = dir / "blocks";
+    ccfg.state_dir             = dir / "state";
+    ccfg.db_config.db_path     = dir / "tokendb";
+    ccfg.state_size            = 1024 * 1024 * 1024;
+    ccfg.reversible_cache_size = 1024 * 1024 * 256;
+    ccfg.contracts_console     = false;
+    ccfg.charge_free_mode      = true;
+    ccfg.loadtest_mode         = true;
+
+    ccfg.genesis.initial_timestamp = fc::time_point::from_iso_string("2020-01-01T00:00:00.000");
+    ccfg.genesis.initial_key       = tester::get_public_key(N(evt));
+
+    tester_ = std::make_unique<tester>(ccfg);
+    tester_->block_signing_private_keys.insert(std::make_pair(ccfg.genesis.initial_key, tester::get_private_key(N(evt))));
+
+    build();
+}
+
+controller::config
+synthetic_chain::node_config(const fc::path& dir) const {
+    auto ccfg = tester_->get_config();
+
+    ccfg.blocks_dir        = dir / "blocks";
+    ccfg.state_dir         = dir / "state";
+    ccfg.db_config.db_path = dir / "tokendb";
+
+    return ccfg;
+}
+
+signed_transaction
+synthetic_chain::make_trx(action&& act) {
+    auto trx = signed_transaction();
+    trx.actions.emplace_back(std::move(act));
+    tester_->set_transaction_headers(trx, address(), 1'000'000, 3000);
+    trx.sign(tester::get_private_key(N(evt)), tester_->control->get_chain_id());
+
+    return trx;
+}
+
+size_t
+synthetic_chain::push_transactions(const std::vector<transaction_metadata_ptr>& trxs) {
+    auto& control = *tester_->control;
+    if(!control.pending_block_state()) {
+        control.start_block(control.head_block_time() + fc::microseconds(config::block_interval_us));
+    }
+
+    auto failed = 0u;
+    for(auto& trx : trxs) {
+        auto trace = control.push_transaction(trx, fc::time_point::maximum());
+        if(trace->except || trace->except_ptr) {
+            failed++;
+        }
+    }
+    return failed;
+}
+
+signed_block_ptr
+synthetic_chain::produce_block() {
+    return tester_->produce_block();
+}
+
+std::vector<transaction_metadata_ptr>
+synthetic_chain::make_transfers(size_t n) {
+    auto key    = tester::get_public_key(N(evt));
+    auto domain = std::uniform_int_distribution<size_t>(0, domains_.size() - 1);
+    auto token  = std::uniform_int_distribution<uint32_t>(0, cfg_.tokens - 1);
+    auto holder = std::uniform_int_distribution<size_t>(0, holders_.size() - 1);
+
+    auto trxs = std::vector<transaction_metadata_ptr>();
+    trxs.reserve(n);
+
+    for(auto i = 0u; i < n; i++) {
+        auto memo = std::to_string(nonce_++);
+        auto act  = action();
+
+        // half of them transfer tokens back to the owner and the others pay fungibles to holders
+        if(rng_() % 2 == 0) {
+            auto tt   = transfer();
+            tt.domain = domains_[domain(rng_)];
+            tt.name   = name128::from_number(token(rng_));
+            tt.to     = { address(key) };
+            tt.memo   = memo;
+
+            act = action(tt.domain, tt.name, tt);
+        }
+        else {
+            auto tf   = transferft();
+            tf.from   = address(key);
+            tf.to     = holders_[holder(rng_)];
+            tf.number = asset(1, sym_);
+            tf.memo   = memo;
+
+            act = action(N128(.fungible), name128::from_number(sym_.id()), tf);
+        }
+        trxs.emplace_back(std::make_shared<transaction_metadata>(make_trx(std::move(act))));
+    }
+    return trxs;
+}
+
+void
+synthetic_chain::build() {
+    auto key  = tester::get_public_key(N(evt));
+    auto trxs = std::vector<transaction_metadata_ptr>();
+
+    auto flush = [&](bool force) {
+        if(trxs.empty() || (!force && trxs.size() < cfg_.trxs_per_block)) {
+            return;
+        }
+        auto failed = push_transactions(trxs);
+        EVT_ASSERT(failed == 0, chain_exception, "${n} trxs failed when building synthetic chain", ("n",failed));
+        produce_block();
+        trxs.clear();
+    };
+    auto add = [&](action&& act) {
+        trxs.emplace_back(std::make_shared<transaction_metadata>(make_trx(std::move(act))));
+        flush(false);
+    };
+
+    auto nd    = fc::json::from_string(ndjson).as<newdomain>();
+    nd.creator = key;
+    nd.issue.authorizers[0].ref.set_account(key);
+    nd.manage.authorizers[0].ref.set_account(key);
+
+    for(auto i = 0u; i < cfg_.domains; i++) {
+        nd.name = name128(std::string("syndomain") + std::to_string(i));
+        domains_.emplace_back(nd.name);
+        add(action(nd.name, N128(.create), nd));
+    }
+    flush(true);
+
+    // at most 1000 tokens in one issuing
+    for(auto& d : domains_) {
+        for(auto i = 0u; i < cfg_.tokens; i += 1000) {
+            auto it   = issuetoken();
+            it.domain = d;
+            it.owner  = { address(key) };
+            for(auto j = i; j < std::min(cfg_.tokens, i + 1000); j++) {
+                it.names.emplace_back(name128::from_number(j));
+            }
+            add(action(d, N128(.issue), it));
+        }
+    }
+    flush(true);
+
+    auto ng          = fc::json::from_string(ngjson).as<newgroup>();
+    ng.group.key_    = key;
+    for(auto i = 0u; i < cfg_.groups; i++) {
+        ng.name        = name128(std::string("syngroup") + std::to_string(i));
+        ng.group.name_ = ng.name;
+        add(action(N128(.group), ng.name, ng));
+    }
+    flush(true);
+
+    auto nf    = fc::json::from_string(nfjson).as<newfungible>();
+    nf.creator = key;
+    nf.issue.authorizers[0].ref.set_account(key);
+    nf.manage.authorizers[0].ref.set_account(key);
+    add(action(N128(.fungible), name128::from_number(sym_.id()), nf));
+    flush(true);
+
+    // owner keeps the most for the transfers in workloads
+    auto isf    = issuefungible();
+    isf.address = address(key);
+    isf.number  = asset(500'000'000'00000, sym_);
+    add(action(N128(.fungible), name128::from_number(sym_.id()), isf));
+
+    // holders are generated addresses, they only receive fungibles
+    auto amount = std::uniform_int_distribution<int64_t>(1, 100'00000);
+    for(auto i = 0u; i < cfg_.holders; i++) {
+        holders_.emplace_back(address(N(.bench), name128::from_number(i), 0));
+
+        isf.address = holders_.back();
+        isf.number  = asset(amount(rng_), sym_);
+        add(action(N128(.fungible), name128::from_number(sym_.id()), isf));
+    }
+    flush(true);
+
+    // makes all the synthetic blocks irreversible and written into block log
+    tester_->produce_blocks(2);
+}
+
+synthetic_chain_config&
+get_synthetic_chain_config() {
+    static auto cfg = synthetic_chain_config();
+    return cfg;
+}
+
+synthetic_chain&
+get_synthetic_chain() {
+    static auto chain = synthetic_chain(get_synthetic_chain_config());
+    return chain;
+}
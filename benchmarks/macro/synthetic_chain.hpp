@@ -0,0 +1,68 @@
+/**
+ *  @file
+ *  @copyright defined in evt/LICENSE.txt
+ */
+#pragma once
+#include <memory>
+#include <random>
+#include <vector>
+#include <evt/chain/controller.hpp>
+#include <evt/chain/transaction_metadata.hpp>
+#include <evt/testing/tester.hpp>
+
+/*
+ * Chain filled with synthetic state for the macro benchmarks,
+ * same config and seed always build the same chain and workloads
+ */
+
+struct synthetic_chain_config {
+    uint32_t domains        = 10;
+    uint32_t tokens         = 1000;   // tokens per domain
+    uint32_t holders        = 10000;  // holders of the synthetic fungible
+    uint32_t groups         = 10;
+    uint32_t trxs_per_block = 1000;
+    uint32_t seed           = 0;
+    fc::path dir            = "/tmp/evt_macro_benchmarks";
+};
+
+class synthetic_chain {
+public:
+    explicit synthetic_chain(const synthetic_chain_config& cfg);
+
+public:
+    // signed transactions transferring the synthetic tokens and fungibles, all valid on current state
+    std::vector<evt::chain::transaction_metadata_ptr> make_transfers(size_t n);
+
+    // pushes `trxs` into pending block and returns the number of failed ones
+    size_t push_transactions(const std::vector<evt::chain::transaction_metadata_ptr>& trxs);
+
+    evt::chain::signed_block_ptr produce_block();
+
+    // config of a new node of the same chain whose data is in `dir`
+    evt::chain::controller::config node_config(const fc::path& dir) const;
+
+    const synthetic_chain_config& config() const { return cfg_; }
+    const fc::path& blocks_dir() const { return tester_->get_config().blocks_dir; }
+
+    evt::chain::controller& control() { return *tester_->control; }
+
+private:
+    void build();
+
+    evt::chain::signed_transaction make_trx(evt::chain::action&& act);
+
+private:
+    synthetic_chain_config                     cfg_;
+    std::unique_ptr<evt::testing::tester>      tester_;
+    std::mt19937_64                            rng_;
+    uint64_t                                   nonce_ = 0;  // makes transactions unique
+    std::vector<evt::chain::name128>           domains_;
+    std::vector<evt::chain::address>           holders_;
+    evt::chain::symbol                         sym_;
+};
+
+// options from command line, should be set before the chain is built
+synthetic_chain_config& get_synthetic_chain_config();
+
+// shared by all the benchmarks in the process and built on first use
+synthetic_chain& get_synthetic_chain();
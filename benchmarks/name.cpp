@@ -0,0 +1,132 @@
+/**
+ *  @file
+ *  @copyright defined in evt/LICENSE.txt
+ */
+
+#include <benchmark/benchmark.h>
+#include <evt/chain/name.hpp>
+#include <evt/chain/name128.hpp>
+
+/*
+ * Benchmarks for the name and name128 codec compared with the legacy one
+ */
+
+using namespace evt::chain;
+
+namespace legacy {
+
+std::string
+name128_to_string(uint128_t value) {
+    static const char* charmap = ".-0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+    auto str  = std::string(21, '.');
+    auto stop = 0u;
+    auto tmp  = value >> 2;
+    auto tag  = (int)value & 0x03;
+
+    switch(tag) {
+    case name128::i32: stop = 5; break;
+    case name128::i64: stop = 10; break;
+    case name128::i96: stop = 15; break;
+    case name128::i128: stop = 21; break;
+    }
+
+    for(auto i = 0u; i < stop; ++i, tmp >>= 6) {
+        str[i] = charmap[tmp & 0x3f];
+    }
+
+    str.erase(str.find_last_not_of('.', stop) + 1);
+    return str;
+}
+
+// string to name128 with the round-trip normalization check
+bool
+name128_set(const std::string& str, uint128_t& value) {
+    value = string_to_name128(str.c_str());
+    return name128_to_string(value) == str;
+}
+
+std::string
+name_to_string(uint64_t value) {
+    static const char* charmap = ".abcdefghijklmnopqrstuvwxyz12345";
+
+    auto str = std::string(13, '.');
+    auto tmp = value;
+    str[12]  = charmap[tmp & 0x0f];
+    tmp >>= 4;
+
+    for(auto i = 1u; i <= 12; ++i, tmp >>= 5) {
+        str[12 - i] = charmap[tmp & 0x1f];
+    }
+
+    str.erase(str.find_last_not_of('.') + 1);
+    return str;
+}
+
+}  // namespace legacy
+
+static const std::string names128[] = { "evt", ".fungible", "tokendomain12", "abcdefghijk.lmnopq-123" };
+static const std::string names[]    = { "evt", "transfer", "everitoken123" };
+
+static void
+BM_Name128_Set_Legacy(benchmark::State& state) {
+    auto i = 0u;
+    for(auto _ : state) {
+        auto v = uint128_t();
+        benchmark::DoNotOptimize(legacy::name128_set(names128[i++ % 4], v));
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Name128_Set_Legacy);
+
+static void
+BM_Name128_Set(benchmark::State& state) {
+    auto i = 0u;
+    for(auto _ : state) {
+        auto n = name128(names128[i++ % 4]);
+        benchmark::DoNotOptimize(n);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Name128_Set);
+
+static void
+BM_Name128_ToString_Legacy(benchmark::State& state) {
+    auto i = 0u;
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(legacy::name128_to_string(string_to_name128(names128[i++ % 4].c_str())));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Name128_ToString_Legacy);
+
+static void
+BM_Name128_ToString(benchmark::State& state) {
+    auto i = 0u;
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(name128(string_to_name128(names128[i++ % 4].c_str())).to_string());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Name128_ToString);
+
+static void
+BM_Name_ToString_Legacy(benchmark::State& state) {
+    auto i = 0u;
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(legacy::name_to_string(string_to_name(names[i++ % 3].c_str())));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Name_ToString_Legacy);
+
+static void
+BM_Name_ToString(benchmark::State& state) {
+    auto i = 0u;
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(name(string_to_name(names[i++ % 3].c_str())).to_string());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Name_ToString);
@@ -84,3 +84,22 @@ BM_SHA256_CGMINER(benchmark::State& state) {
     state.SetItemsProcessed(state.iterations());
 }
 BENCHMARK(BM_SHA256_CGMINER);
+
+static void
+BM_SHA256_OPENSSL(benchmark::State& state) {
+    auto buf = std::string();
+
+    auto dre  = std::default_random_engine(std::chrono::system_clock::now().time_since_epoch().count());
+    auto dist = std::uniform_int_distribution<int>(0, std::numeric_limits<char>::max());
+
+    for(auto i = 0u; i < 256; i++) {
+        buf.push_back((char)dist(dre));
+    }
+
+    uint32_t result[8];
+    for(auto _ : state) {
+        sha256::openssl::hash(buf.data(), buf.size(), result);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SHA256_OPENSSL);
@@ -0,0 +1,11 @@
+#include "sha256.hpp"
+#include <openssl/sha.h>
+
+namespace sha256 { namespace openssl {
+
+void
+hash(const char* input, size_t len, uint32_t result[8]) {
+    SHA256((const uint8_t*)input, len, (uint8_t*)result);
+}
+
+}}  // namespace sha256::openssl
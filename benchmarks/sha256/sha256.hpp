@@ -20,4 +20,8 @@ namespace cgminer {
 void hash(const char* input, size_t len, uint32_t result[8]);
 }
 
+namespace openssl {
+void hash(const char* input, size_t len, uint32_t result[8]);
+}
+
 } // namespace sha256::intrinsics
\ No newline at end of file
@@ -0,0 +1,379 @@
+/**
+ *  @file
+ *  @copyright defined in evt/LICENSE.txt
+ */
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <random>
+#include <fc/log/logger.hpp>
+#include <evt/chain/token_database.hpp>
+#include <evt/chain/token_database_cache.hpp>
+#include <evt/chain/contracts/types.hpp>
+#include <evt/testing/tester.hpp>
+
+/*
+ * Benchmarks for token database and its object cache
+ * Most of them are parameterized by the number of tokens in database and the storage profile
+ */
+
+using namespace evt::chain;
+using namespace evt::chain::contracts;
+
+namespace __internal {
+
+const auto kDomain           = N128(benchdomain);
+const auto kPutsPerIteration = 1000;
+const auto kPutsPerSavepoint = 100;
+const auto kHotKeysPercent   = 20;  // 80% of the reads in cache benchmarks hit the hot keys
+
+struct bench_tokendb {
+    storage_profile                 profile;
+    std::unique_ptr<token_database> db;
+    std::vector<name128>            keys;
+    std::vector<std::string>        values;
+    size_t                          total_bytes = 0;
+    int64_t                         seq         = 0;
+
+    // declared after `db`, caches watch the rollbacks of db and should be destroyed first
+    std::map<int64_t, std::unique_ptr<token_database_cache>> caches;
+};
+
+// only one database is opened at the same time, it's rebuilt when the parameters change
+bench_tokendb&
+get_tokendb(int64_t size, storage_profile profile) {
+    static auto current = std::unique_ptr<bench_tokendb>();
+    if(current && current->keys.size() == (size_t)size && current->profile == profile) {
+        return *current;
+    }
+    current.reset();
+
+    fc::logger::get().set_log_level(fc::log_level(fc::log_level::error));
+
+    auto dir = fc::path("/tmp/evt_tokendb_benchmarks");
+    if(fc::exists(dir)) {
+        fc::remove_all(dir);
+    }
+    fc::create_directories(dir);
+
+    auto cfg    = token_database::config();
+    cfg.profile = profile;
+    cfg.db_path = dir / "tokendb";
+
+    auto b     = std::make_unique<bench_tokendb>();
+    b->profile = profile;
+    b->db      = std::make_unique<token_database>(cfg);
+    b->db->open();
+
+    // keys are ingested in the order of their bytes in database
+    b->keys.reserve(size);
+    for(auto i = 0; i < size; i++) {
+        b->keys.emplace_back(name128::from_number(i));
+    }
+    std::sort(b->keys.begin(), b->keys.end(), [](auto& lhs, auto& rhs) {
+        return memcmp(&lhs, &rhs, sizeof(name128)) < 0;
+    });
+
+    auto owner = address(evt::testing::tester::get_public_key(N(evt)));
+    b->values.reserve(size);
+    for(auto& k : b->keys) {
+        auto v = make_db_value(token_def(kDomain, k, { owner }));
+        b->values.emplace_back(v.as_string_view());
+        b->total_bytes += v.size();
+    }
+
+    auto i = 0u;
+    b->db->ingest_tokens(token_type::token, kDomain, [&](auto& key, auto& value) {
+        if(i == b->keys.size()) {
+            return false;
+        }
+        key.assign((const char*)&b->keys[i], sizeof(name128));
+        value = b->values[i];
+        i++;
+        return true;
+    });
+
+    current = std::move(b);
+    return *current;
+}
+
+bench_tokendb&
+get_tokendb(const benchmark::State& state) {
+    return get_tokendb(state.range(0), (storage_profile)state.range(1));
+}
+
+void
+put_random_tokens(bench_tokendb& b, std::mt19937_64& rng, int n) {
+    auto dist = std::uniform_int_distribution<size_t>(0, b.keys.size() - 1);
+    for(auto i = 0; i < n; i++) {
+        auto j = dist(rng);
+        b.db->put_token(token_type::token, action_op::update, kDomain, b.keys[j], b.values[j]);
+    }
+}
+
+void
+add_savepoints(bench_tokendb& b, std::mt19937_64& rng, int depth) {
+    for(auto i = 0; i < depth; i++) {
+        b.db->add_savepoint(++b.seq);
+        put_random_tokens(b, rng, kPutsPerSavepoint);
+    }
+}
+
+void
+rollback_savepoints(bench_tokendb& b) {
+    while(b.db->savepoints_size() > 0) {
+        b.db->rollback_to_latest_savepoint();
+    }
+}
+
+double
+ratio(uint64_t hit, uint64_t miss) {
+    return (hit + miss) > 0 ? (double)hit / (hit + miss) : 0;
+}
+
+}  // namespace __internal
+
+using namespace __internal;
+
+static void
+StateArgs(benchmark::internal::Benchmark* b) {
+    b->ArgsProduct({
+        { 10'000, 100'000, 1'000'000 },
+        { (int64_t)storage_profile::disk, (int64_t)storage_profile::memory }
+    });
+    b->ArgNames({ "tokens", "profile" });
+}
+
+static void
+SavepointArgs(benchmark::internal::Benchmark* b) {
+    b->ArgsProduct({
+        { 100'000 },
+        { (int64_t)storage_profile::disk, (int64_t)storage_profile::memory },
+        { 1, 4, 16, 64 }
+    });
+    b->ArgNames({ "tokens", "profile", "depth" });
+}
+
+static void
+BM_TokenDB_Read(benchmark::State& state) {
+    auto& b    = get_tokendb(state);
+    auto  rng  = std::mt19937_64(0);
+    auto  dist = std::uniform_int_distribution<size_t>(0, b.keys.size() - 1);
+    auto  m1   = b.db->get_metrics();
+
+    auto str = std::string();
+    for(auto _ : state) {
+        b.db->read_token(token_type::token, kDomain, b.keys[dist(rng)], str);
+        benchmark::DoNotOptimize(str);
+    }
+
+    auto m2 = b.db->get_metrics();
+    state.SetItemsProcessed(state.iterations());
+    state.counters["block_cache_hit_ratio"] = ratio(m2.block_cache_hit - m1.block_cache_hit, m2.block_cache_miss - m1.block_cache_miss);
+}
+BENCHMARK(BM_TokenDB_Read)->Apply(StateArgs);
+
+static void
+BM_TokenDB_ReadMissing(benchmark::State& state) {
+    auto& b   = get_tokendb(state);
+    auto  rng = std::mt19937_64(0);
+
+    // keys out of the ingested numbers are never in database
+    auto dist = std::uniform_int_distribution<uint64_t>(b.keys.size(), b.keys.size() * 2);
+    for(auto _ : state) {
+        auto r = b.db->exists_token(token_type::token, kDomain, name128::from_number(dist(rng)));
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TokenDB_ReadMissing)->Apply(StateArgs);
+
+static void
+BM_TokenDB_Scan(benchmark::State& state) {
+    auto& b   = get_tokendb(state);
+    auto  len = state.range(2);
+
+    for(auto _ : state) {
+        auto n = 0;
+        b.db->read_tokens_range(token_type::token, kDomain, 0, [&](auto& key, auto&& value) {
+            benchmark::DoNotOptimize(value);
+            return ++n < len;
+        });
+    }
+    state.SetItemsProcessed(state.iterations() * len);
+}
+BENCHMARK(BM_TokenDB_Scan)
+    ->ArgsProduct({
+        { 10'000, 100'000, 1'000'000 },
+        { (int64_t)storage_profile::disk, (int64_t)storage_profile::memory },
+        { 100, 10'000 }
+    })
+    ->ArgNames({ "tokens", "profile", "length" });
+
+static void
+BM_TokenDB_Put(benchmark::State& state) {
+    auto& b   = get_tokendb(state);
+    auto  rng = std::mt19937_64(0);
+
+    for(auto _ : state) {
+        auto session = b.db->new_savepoint_session();
+        put_random_tokens(b, rng, kPutsPerIteration);
+
+        state.PauseTiming();
+        session.undo();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * kPutsPerIteration);
+}
+BENCHMARK(BM_TokenDB_Put)->Apply(StateArgs);
+
+static void
+BM_TokenDB_SavepointAdd(benchmark::State& state) {
+    auto& b     = get_tokendb(state);
+    auto  rng   = std::mt19937_64(0);
+    auto  depth = state.range(2);
+
+    for(auto _ : state) {
+        add_savepoints(b, rng, depth);
+
+        state.PauseTiming();
+        rollback_savepoints(b);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * depth);
+}
+BENCHMARK(BM_TokenDB_SavepointAdd)->Apply(SavepointArgs);
+
+static void
+BM_TokenDB_SavepointRollback(benchmark::State& state) {
+    auto& b     = get_tokendb(state);
+    auto  rng   = std::mt19937_64(0);
+    auto  depth = state.range(2);
+
+    for(auto _ : state) {
+        state.PauseTiming();
+        add_savepoints(b, rng, depth);
+        state.ResumeTiming();
+
+        rollback_savepoints(b);
+    }
+    state.SetItemsProcessed(state.iterations() * depth);
+}
+BENCHMARK(BM_TokenDB_SavepointRollback)->Apply(SavepointArgs);
+
+static void
+BM_TokenDB_SavepointSquash(benchmark::State& state) {
+    auto& b     = get_tokendb(state);
+    auto  rng   = std::mt19937_64(0);
+    auto  depth = state.range(2);
+
+    for(auto _ : state) {
+        state.PauseTiming();
+        add_savepoints(b, rng, depth + 1);
+        state.ResumeTiming();
+
+        for(auto i = 0; i < depth; i++) {
+            b.db->squash();
+        }
+
+        state.PauseTiming();
+        rollback_savepoints(b);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * depth);
+}
+BENCHMARK(BM_TokenDB_SavepointSquash)->Apply(SavepointArgs);
+
+// popped values are written by background flusher, only the cost in foreground is measured
+static void
+BM_TokenDB_SavepointPop(benchmark::State& state) {
+    auto& b     = get_tokendb(state);
+    auto  rng   = std::mt19937_64(0);
+    auto  depth = state.range(2);
+
+    for(auto _ : state) {
+        state.PauseTiming();
+        add_savepoints(b, rng, depth);
+        state.ResumeTiming();
+
+        b.db->pop_savepoints(b.seq + 1);
+    }
+    state.SetItemsProcessed(state.iterations() * depth);
+}
+BENCHMARK(BM_TokenDB_SavepointPop)->Apply(SavepointArgs);
+
+static token_database_cache&
+get_cache(bench_tokendb& b, int64_t percent) {
+    auto it = b.caches.find(percent);
+    if(it == b.caches.end()) {
+        auto size = std::max<size_t>(b.total_bytes * percent / 100, 1);
+        it = b.caches.emplace(percent, std::make_unique<token_database_cache>(*b.db, size)).first;
+    }
+    return *it->second;
+}
+
+// picks hot keys most of the time so that hit ratio depends on cache capacity
+static size_t
+skewed_index(bench_tokendb& b, std::mt19937_64& rng) {
+    auto hot = std::max<size_t>(b.keys.size() * kHotKeysPercent / 100, 1);
+    if(rng() % 100 < 80) {
+        return rng() % hot;
+    }
+    return rng() % b.keys.size();
+}
+
+static void
+CacheArgs(benchmark::internal::Benchmark* b) {
+    b->ArgsProduct({
+        { 100'000, 1'000'000 },
+        { (int64_t)storage_profile::disk, (int64_t)storage_profile::memory },
+        { 1, 10, 50, 100 }
+    });
+    b->ArgNames({ "tokens", "profile", "cache_percent" });
+}
+
+static void
+BM_TokenDB_CacheRead(benchmark::State& state) {
+    auto& b     = get_tokendb(state);
+    auto& cache = get_cache(b, state.range(2));
+    auto  rng   = std::mt19937_64(0);
+    auto  m1    = cache.get_metrics();
+
+    for(auto _ : state) {
+        auto tk = cache.read_token<token_def>(token_type::token, kDomain, b.keys[skewed_index(b, rng)]);
+        benchmark::DoNotOptimize(tk);
+    }
+
+    auto m2 = cache.get_metrics();
+    state.SetItemsProcessed(state.iterations());
+    state.counters["hit_ratio"] = ratio(m2.hit - m1.hit, m2.miss - m1.miss);
+}
+BENCHMARK(BM_TokenDB_CacheRead)->Apply(CacheArgs);
+
+static void
+BM_TokenDB_CachePut(benchmark::State& state) {
+    auto& b     = get_tokendb(state);
+    auto& cache = get_cache(b, state.range(2));
+    auto  rng   = std::mt19937_64(0);
+    auto  m1    = cache.get_metrics();
+
+    for(auto _ : state) {
+        auto session = b.db->new_savepoint_session();
+        for(auto i = 0; i < kPutsPerIteration; i++) {
+            auto j  = skewed_index(b, rng);
+            auto tk = cache.read_token<token_def>(token_type::token, kDomain, b.keys[j]);
+            cache.put_token(token_type::token, action_op::update, kDomain, b.keys[j], *tk);
+        }
+
+        state.PauseTiming();
+        session.undo();
+        state.ResumeTiming();
+    }
+
+    auto m2 = cache.get_metrics();
+    state.SetItemsProcessed(state.iterations() * kPutsPerIteration);
+    state.counters["hit_ratio"] = ratio(m2.hit - m1.hit, m2.miss - m1.miss);
+}
+BENCHMARK(BM_TokenDB_CachePut)->Apply(CacheArgs);
@@ -1,9 +1,24 @@
 #include <libevt/evt.h>
+#include "evt_impl.hpp"
+
 #include <string.h>
 #include <stdlib.h>
+#include <thread>
 #include <evt/chain/version.hpp>
 #include <evt/chain/contracts/evt_contract_abi.hpp>
 
+size_t
+get_batch_threads() {
+    static auto threads = (size_t)std::max(std::thread::hardware_concurrency(), 1u);
+    return threads;
+}
+
+boost::asio::thread_pool&
+get_batch_thread_pool() {
+    static boost::asio::thread_pool pool(get_batch_threads());
+    return pool;
+}
+
 extern "C" {
 
 int
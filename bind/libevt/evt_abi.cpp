@@ -169,6 +169,45 @@ evt_trx_json_to_digest(void* evt_abi, const char* json,  evt_chain_id_t* chain_i
     return EVT_OK;
 }
 
+int
+evt_abi_json_to_bin_batch(void* evt_abi, const char** actions, const char** jsons, size_t n, evt_bin_t** bins /* out */) {
+    if(evt_abi == nullptr) {
+        return EVT_INVALID_ARGUMENT;
+    }
+    if(actions == nullptr) {
+        return EVT_INVALID_ARGUMENT;
+    }
+    if(jsons == nullptr) {
+        return EVT_INVALID_ARGUMENT;
+    }
+    if(bins == nullptr) {
+        return EVT_INVALID_ARGUMENT;
+    }
+    // abi serializer and execution context are read-only here, shared by all the workers
+    return run_batch(n, bins, [&](auto i) {
+        return evt_abi_json_to_bin(evt_abi, actions[i], jsons[i], &bins[i]);
+    });
+}
+
+int
+evt_trx_json_to_digest_batch(void* evt_abi, const char** jsons, size_t n, evt_chain_id_t* chain_id, evt_checksum_t** digests /* out */) {
+    if(evt_abi == nullptr) {
+        return EVT_INVALID_ARGUMENT;
+    }
+    if(jsons == nullptr) {
+        return EVT_INVALID_ARGUMENT;
+    }
+    if(chain_id == nullptr) {
+        return EVT_INVALID_ARGUMENT;
+    }
+    if(digests == nullptr) {
+        return EVT_INVALID_ARGUMENT;
+    }
+    return run_batch(n, digests, [&](auto i) {
+        return evt_trx_json_to_digest(evt_abi, jsons[i], chain_id, &digests[i]);
+    });
+}
+
 int
 evt_chain_id_from_string(const char* str, evt_chain_id_t** chain_id /* out */) {
     return evt_checksum_from_string(str, chain_id);
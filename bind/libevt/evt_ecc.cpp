@@ -90,6 +90,22 @@ evt_sign_hash(evt_private_key_t* priv_key, evt_checksum_t* hash, evt_signature_t
     return EVT_OK;
 }
 
+int
+evt_sign_hash_batch(evt_private_key_t** priv_keys, evt_checksum_t** hashes, size_t n, evt_signature_t** signs /* out */) {
+    if(priv_keys == nullptr) {
+        return EVT_INVALID_ARGUMENT;
+    }
+    if(hashes == nullptr) {
+        return EVT_INVALID_ARGUMENT;
+    }
+    if(signs == nullptr) {
+        return EVT_INVALID_ARGUMENT;
+    }
+    return run_batch(n, signs, [&](auto i) {
+        return evt_sign_hash(priv_keys[i], hashes[i], &signs[i]);
+    });
+}
+
 int
 evt_recover(evt_signature_t* sign, evt_checksum_t* hash, evt_public_key_t** pub_key /* out */) {
     if(sign == nullptr) {
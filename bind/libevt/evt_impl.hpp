@@ -6,9 +6,12 @@
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
+#include <algorithm>
 #include <string>
+#include <vector>
 #include <libevt/evt.h>
 #include <fc/io/raw.hpp>
+#include <evt/chain/thread_utils.hpp>
 
 #define CATCH_AND_RETURN(err)         \
     catch(fc::exception& e) {         \
@@ -54,3 +57,59 @@ strdup(const std::string& str) {
     s[str.size()] = '\0';
     return s;
 }
+
+// shared by all the batch apis, sized by the number of hardware threads
+boost::asio::thread_pool& get_batch_thread_pool();
+size_t                    get_batch_threads();
+
+// runs `f(i)` for each `i` in [0, n) on the batch thread pool, `f` fills `outs[i]` and returns its error code.
+// if any item fails, all the `outs` are freed and reset and the error of the first failed item is returned
+template <typename T, typename F>
+int
+run_batch(size_t n, T** outs, F&& f) {
+    auto rcs  = std::vector<int>(n, EVT_OK);
+    auto errs = std::vector<int>(n, 0);
+
+    auto run = [&](size_t begin, size_t end) {
+        for(auto i = begin; i < end; i++) {
+            // last error is thread local, collect it from the worker
+            evt_set_last_error(0);
+            rcs[i]  = f(i);
+            errs[i] = evt_last_error();
+        }
+    };
+
+    for(auto i = 0u; i < n; i++) {
+        outs[i] = nullptr;
+    }
+
+    auto threads = std::min(get_batch_threads(), n);
+    if(threads <= 1) {
+        run(0, n);
+    }
+    else {
+        auto chunk   = (n + threads - 1) / threads;
+        auto futures = std::vector<std::future<void>>();
+        futures.reserve(threads);
+        for(auto begin = 0u; begin < n; begin += chunk) {
+            auto end = std::min(begin + chunk, n);
+            futures.emplace_back(evt::chain::async_thread_pool(get_batch_thread_pool(), [&run, begin, end] { run(begin, end); }));
+        }
+        evt::chain::wait_all_futures(futures);
+    }
+
+    for(auto i = 0u; i < n; i++) {
+        if(rcs[i] == EVT_OK) {
+            continue;
+        }
+        for(auto j = 0u; j < n; j++) {
+            free(outs[j]);
+            outs[j] = nullptr;
+        }
+        if(errs[i] != 0) {
+            evt_set_last_error(errs[i]);
+        }
+        return rcs[i];
+    }
+    return EVT_OK;
+}
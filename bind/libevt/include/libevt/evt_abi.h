@@ -21,6 +21,8 @@ void  evt_free_abi(void* abi);
 int evt_abi_json_to_bin(void* evt_abi, const char* action, const char* json, evt_bin_t** bin /* out */);
 int evt_abi_bin_to_json(void* evt_abi, const char* action, evt_bin_t* bin, char** json /* out */);
 int evt_trx_json_to_digest(void* evt_abi, const char* json, evt_chain_id_t* chain_id, evt_checksum_t** digest /* out */);
+int evt_abi_json_to_bin_batch(void* evt_abi, const char** actions, const char** jsons, size_t n, evt_bin_t** bins /* out */);
+int evt_trx_json_to_digest_batch(void* evt_abi, const char** jsons, size_t n, evt_chain_id_t* chain_id, evt_checksum_t** digests /* out */);
 int evt_chain_id_from_string(const char* str, evt_chain_id_t** chain_id /* out */);
 int evt_block_id_from_string(const char* str, evt_block_id_t** block_id /* out */);
 int evt_ref_block_num(evt_block_id_t* block_id, uint16_t* ref_block_num);
@@ -17,6 +17,7 @@ typedef evt_data_t evt_checksum_t;
 int evt_generate_new_pair(evt_public_key_t** pub_key /* out */, evt_private_key_t** priv_key /* out */);
 int evt_get_public_key(evt_private_key_t* priv_key, evt_public_key_t** pub_key /* out */);
 int evt_sign_hash(evt_private_key_t* priv_key, evt_checksum_t* hash, evt_signature_t** sign /* out */);
+int evt_sign_hash_batch(evt_private_key_t** priv_keys, evt_checksum_t** hashes, size_t n, evt_signature_t** signs /* out */);
 int evt_recover(evt_signature_t* sign, evt_checksum_t* hash, evt_public_key_t** pub_key /* out */);
 int evt_hash(const char* buf, size_t sz, evt_checksum_t** hash /* out */);
 
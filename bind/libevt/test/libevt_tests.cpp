@@ -193,6 +193,19 @@ TEST_CASE("evtecc") {
     REQUIRE(pubkey3 != nullptr);
     REQUIRE(evt_equals(pubkey, pubkey3) == EVT_OK);
 
+    evt_private_key_t* privkeys[] = { privkey, privkey, privkey };
+    evt_checksum_t*    hashes[]   = { hash, hash2, hash };
+    evt_signature_t*   signs[3];
+    auto r6 = evt_sign_hash_batch(privkeys, hashes, 3, signs);
+    REQUIRE(r6 == EVT_OK);
+    for(auto s : signs) {
+        evt_public_key_t* pubkey5 = nullptr;
+        REQUIRE(evt_recover(s, hash, &pubkey5) == EVT_OK);
+        CHECK(evt_equals(pubkey, pubkey5) == EVT_OK);
+        evt_free(pubkey5);
+        evt_free(s);
+    }
+
     evt_free(pubkey);
     evt_free(privkey);
     evt_free(pubkey2);
@@ -344,6 +357,35 @@ TEST_CASE("evtabi") {
     REQUIRE(r9 == EVT_OK);
     REQUIRE(digest2 != nullptr);
 
+    const char*     jsons[] = { j2, j4, j2, j4 };
+    evt_checksum_t* digests[4];
+    auto r10 = evt_trx_json_to_digest_batch(abi, jsons, 4, chain_id, digests);
+    REQUIRE(r10 == EVT_OK);
+    CHECK(evt_equals(digests[0], digest) == EVT_OK);
+    CHECK(evt_equals(digests[1], digest2) == EVT_OK);
+    CHECK(evt_equals(digests[2], digest) == EVT_OK);
+    CHECK(evt_equals(digests[3], digest2) == EVT_OK);
+    for(auto d : digests) {
+        evt_free(d);
+    }
+
+    const char* actions[] = { "newdomain", "aprvsuspend" };
+    const char* jsons2[]  = { j1, j3 };
+    evt_bin_t*  bins[2];
+    auto r13 = evt_abi_json_to_bin_batch(abi, actions, jsons2, 2, bins);
+    REQUIRE(r13 == EVT_OK);
+    CHECK(evt_equals(bins[0], bin) == EVT_OK);
+    CHECK(evt_equals(bins[1], bin3) == EVT_OK);
+    evt_free(bins[0]);
+    evt_free(bins[1]);
+
+    // failed item makes the whole batch fail
+    jsons2[1] = "aprvsuspend";
+    auto r14 = evt_abi_json_to_bin_batch(abi, actions, jsons2, 2, bins);
+    REQUIRE(r14 == EVT_INVALID_JSON);
+    CHECK(bins[0] == nullptr);
+    CHECK(bins[1] == nullptr);
+
     REQUIRE(abi != nullptr);
 
     evt_free(bin);
@@ -42,6 +42,36 @@ def trx_json_to_digest(json, chain_id):
     return EvtData(digest_c[0])
 
 
+def _new_str_array(evt, strs):
+    # keep the buffers referenced by the array alive along with it
+    bufs = [evt.ffi.new('char[]', bytes(s, encoding='utf-8')) for s in strs]
+    return evt.ffi.new('const char*[]', bufs), bufs
+
+
+# Batch apis run on the thread pool inside libevt, and cffi releases the GIL
+# during the call, so other python threads keep running meanwhile.
+def json_to_bin_batch(actions, jsons):
+    evt = libevt.check_lib_init()
+    assert len(actions) == len(jsons)
+    actions_c, actions_bufs = _new_str_array(evt, actions)
+    jsons_c, jsons_bufs = _new_str_array(evt, jsons)
+    bins_c = evt.ffi.new('evt_bin_t*[]', len(jsons))
+    ret = evt.lib.evt_abi_json_to_bin_batch(
+        evt.abi, actions_c, jsons_c, len(jsons), bins_c)
+    evt_exception.evt_exception_raiser(ret)
+    return [EvtData(bins_c[i]) for i in range(len(jsons))]
+
+
+def trx_json_to_digest_batch(jsons, chain_id):
+    evt = libevt.check_lib_init()
+    jsons_c, jsons_bufs = _new_str_array(evt, jsons)
+    digests_c = evt.ffi.new('evt_checksum_t*[]', len(jsons))
+    ret = evt.lib.evt_trx_json_to_digest_batch(
+        evt.abi, jsons_c, len(jsons), chain_id.data, digests_c)
+    evt_exception.evt_exception_raiser(ret)
+    return [EvtData(digests_c[i]) for i in range(len(jsons))]
+
+
 class ChainId(EvtData):
     def __init__(self, data):
         super().__init__(data)
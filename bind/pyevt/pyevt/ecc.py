@@ -65,6 +65,9 @@ class PrivateKey(EvtData):
         evt_exception.evt_exception_raiser(ret)
         return Signature(signature_c[0])
 
+    def sign_hashes(self, hashes):
+        return sign_hash_batch([self] * len(hashes), hashes)
+
     @staticmethod
     def from_string(str):
         evt = libevt.check_lib_init()
@@ -119,6 +122,19 @@ class Checksum(EvtData):
         return Checksum(evt_hash[0])
 
 
+def sign_hash_batch(priv_keys, hashes):
+    evt = libevt.check_lib_init()
+    assert len(priv_keys) == len(hashes)
+    priv_keys_c = evt.ffi.new('evt_private_key_t*[]',
+                              [k.data for k in priv_keys])
+    hashes_c = evt.ffi.new('evt_checksum_t*[]', [h.data for h in hashes])
+    signatures_c = evt.ffi.new('evt_signature_t*[]', len(hashes))
+    ret = evt.lib.evt_sign_hash_batch(
+        priv_keys_c, hashes_c, len(hashes), signatures_c)
+    evt_exception.evt_exception_raiser(ret)
+    return [Signature(signatures_c[i]) for i in range(len(hashes))]
+
+
 def generate_new_pair():
     evt = libevt.check_lib_init()
     public_key_c = evt.ffi.new('evt_public_key_t**')
@@ -38,6 +38,12 @@ class TestPyEVT(unittest.TestCase):
         pub_key_string3 = pub_key3.to_string()
         self.assertTrue(pub_key_string3 == pub_key_string)
 
+        hashes = [Checksum.from_string(str(i)) for i in range(10)]
+        signs = priv_key.sign_hashes(hashes)
+        for sign, hash in zip(signs, hashes):
+            pub_key4 = PublicKey.recover(sign, hash)
+            self.assertEqual(pub_key4.to_string(), pub_key_string)
+
     def test_evtabi(self):
         j = r'''
         {
@@ -93,6 +99,12 @@ class TestPyEVT(unittest.TestCase):
             'bb248d6319e51ad38502cc8ef8fe607eb5ad2cd0be2bdc0e6e30a506761b8636')
         digest = abi.trx_json_to_digest(j2, chain_id)
 
+        digests = abi.trx_json_to_digest_batch([j2, j2], chain_id)
+        for d in digests:
+            self.assertEqual(d.to_hex_string(), digest.to_hex_string())
+        bins = abi.json_to_bin_batch(['newdomain'], [j])
+        self.assertEqual(bins[0].to_hex_string(), bin.to_hex_string())
+
         block_id = BlockId.from_string(
             '000000cabd11d7f8163d5586a4bb4ef6bb8d0581f03db67a04c285bbcb83f921')
         self.assertEqual(
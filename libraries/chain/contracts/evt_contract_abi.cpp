@@ -478,6 +478,19 @@ evt_contract_abi() {
         }
     });
 
+    evt_abi.structs.emplace_back( struct_def {
+        "setpsvbonus_v3", "", {
+           {"sym_id", "symbol_id_type"},
+           {"rate", "percent_slim"},
+           {"base_charge", "asset"},
+           {"charge_threshold", "asset?"},
+           {"minimum_charge", "asset?"},
+           {"dist_threshold", "asset"},
+           {"rules", "dist_rule_v2[]"},
+           {"methods", "passive_method[]"}
+        }
+    });
+
     evt_abi.structs.emplace_back( struct_def {
         "distpsvbonus", "", {
            {"sym_id", "symbol_id_type"},
@@ -486,6 +499,14 @@ evt_contract_abi() {
         }
     });
 
+    evt_abi.structs.emplace_back( struct_def {
+        "distpsvbonus_v2", "", {
+           {"sym_id", "symbol_id_type"},
+           {"deadline", "time_point"},
+           {"final_receiver", "address?"}
+        }
+    });
+
     // abi_def fields
     evt_abi.structs.emplace_back( struct_def {
         "field_def", "", {
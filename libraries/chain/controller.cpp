@@ -21,6 +21,7 @@
 #include <evt/chain/token_database.hpp>
 #include <evt/chain/token_database_cache.hpp>
 #include <evt/chain/token_database_snapshot.hpp>
+#include <evt/chain/thread_utils.hpp>
 #include <evt/chain/transaction_context.hpp>
 #include <evt/chain/contracts/abi_serializer.hpp>
 #include <evt/chain/contracts/evt_contract_abi.hpp>
@@ -145,6 +146,8 @@ struct controller_impl {
     chain_id_type            chain_id;
     evt_execution_context    exec_ctx;
 
+    mutable optional<boost::asio::thread_pool> thread_pool;
+
 
     bool                     replaying = false;
     optional<fc::time_point> replay_head_time;
@@ -152,6 +155,7 @@ struct controller_impl {
     bool                     in_trx_requiring_checks = false; ///< if true, checks that are normally skipped on replay (e.g. auth checks) cannot be skipped
     bool                     trusted_producer_light_validation = false;
     uint32_t                 snapshot_head_block = 0;
+    optional<block_id_type>  last_snapshot_block_id;  ///< base of next delta snapshot
     abi_serializer           system_api;
 
     /**
@@ -202,9 +206,16 @@ struct controller_impl {
         fork_db.irreversible.connect([&](auto b) {
             on_irreversible(b);
         });
+
+        EVT_ASSERT(cfg.thread_pool_size > 0, plugin_config_exception,
+                   "thread_pool_size ${n} must be greater than 0", ("n", cfg.thread_pool_size));
+        thread_pool.emplace(cfg.thread_pool_size);
     }
 
     ~controller_impl() {
+        thread_pool->stop();
+        thread_pool->join();
+
         pending.reset();
         db.flush();
         reversible_blocks.flush();
@@ -350,7 +361,7 @@ struct controller_impl {
 
 
     void
-    init(const snapshot_reader_ptr& snapshot) {
+    init(const snapshot_reader_ptr& snapshot, const std::vector<snapshot_reader_ptr>& deltas) {
         token_db.open();
 
         bool report_integrity_hash = !!snapshot;
@@ -358,7 +369,7 @@ struct controller_impl {
             EVT_ASSERT(!head, fork_database_exception, "");
             snapshot->validate();
 
-            read_from_snapshot(snapshot);
+            read_from_snapshot(snapshot, deltas);
 
             auto end = blog.read_head();
             if(!end) {
@@ -434,14 +445,25 @@ struct controller_impl {
     }
 
     void
-    add_to_snapshot(const snapshot_writer_ptr& snapshot) const {
+    add_to_snapshot(const snapshot_writer_ptr& snapshot, bool delta = false) const {
         snapshot->write_section<chain_snapshot_header>([this](auto& section) {
             section.add_row(chain_snapshot_header(), db);
         });
 
-        snapshot->write_section<genesis_state>([this](auto& section) {
-            section.add_row(conf.genesis, db);
-        });
+        if(delta) {
+            snapshot->write_section<delta_snapshot_header>([this](auto& section) {
+                auto header = delta_snapshot_header {
+                    .base_block_id = *last_snapshot_block_id,
+                    .head_block_id = fork_db.head()->id
+                };
+                section.add_row(header, db);
+            });
+        }
+        else {
+            snapshot->write_section<genesis_state>([this](auto& section) {
+                section.add_row(conf.genesis, db);
+            });
+        }
 
         snapshot->write_section<block_state>([this](auto& section) {
             section.template add_row<block_header_state>(*fork_db.head(), db);
@@ -457,18 +479,58 @@ struct controller_impl {
             });
         });
 
-        token_database_snapshot::add_to_snapshot(snapshot, token_db);
+        if(delta) {
+            token_database_snapshot::add_delta_to_snapshot(snapshot, token_db);
+        }
+        else {
+            token_database_snapshot::add_to_snapshot(snapshot, token_db, &*thread_pool);
+        }
+    }
+
+    void
+    validate_deltas(const snapshot_reader_ptr& snapshot, const std::vector<snapshot_reader_ptr>& deltas) {
+        auto id = block_id_type();
+        snapshot->read_section<block_state>([this, &id](auto& section) {
+            block_header_state head_header_state;
+            section.read_row(head_header_state, db);
+            id = head_header_state.id;
+        });
+
+        for(auto& delta : deltas) {
+            delta->validate();
+            delta->read_section<chain_snapshot_header>([this](auto& section) {
+                chain_snapshot_header header;
+                section.read_row(header, db);
+                header.validate();
+            });
+            delta->read_section<delta_snapshot_header>([this, &id](auto& section) {
+                delta_snapshot_header header;
+                section.read_row(header, db);
+                EVT_ASSERT(header.base_block_id == id, snapshot_validation_exception,
+                           "Delta snapshot is based on ${base} but previous snapshot is at ${id}",
+                           ("base", header.base_block_id)("id", id));
+                id = header.head_block_id;
+            });
+        }
     }
 
     void
-    read_from_snapshot(const snapshot_reader_ptr& snapshot) {
+    read_from_snapshot(const snapshot_reader_ptr& snapshot, const std::vector<snapshot_reader_ptr>& deltas) {
         snapshot->read_section<chain_snapshot_header>([this](auto& section) {
             chain_snapshot_header header;
             section.read_row(header, db);
             header.validate();
         });
 
-        snapshot->read_section<block_state>([this](auto& section) {
+        if(!deltas.empty()) {
+            validate_deltas(snapshot, deltas);
+        }
+
+        // chain states are restored from the latest delta
+        // and token database is restored from base snapshot plus all the deltas in order
+        auto& state = deltas.empty() ? snapshot : deltas.back();
+
+        state->read_section<block_state>([this](auto& section) {
             block_header_state head_header_state;
             section.read_row(head_header_state, db);
 
@@ -481,10 +543,10 @@ struct controller_impl {
             snapshot_head_block = head->block_num;
         });
 
-        controller_index_set::walk_indices([this, &snapshot](auto utils) {
+        controller_index_set::walk_indices([this, &state](auto utils) {
             using value_t = typename decltype(utils)::index_t::value_type;
 
-            snapshot->read_section<value_t>([this](auto& section) {
+            state->read_section<value_t>([this](auto& section) {
                 bool more = !section.empty();
                 while(more) {
                     decltype(utils)::create(db, [this, &section, &more](auto& row) {
@@ -494,18 +556,26 @@ struct controller_impl {
             });
         });
 
-        token_database_snapshot::read_from_snapshot(snapshot, token_db);
+        token_database_snapshot::read_from_snapshot(snapshot, token_db, &*thread_pool);
+        for(auto& delta : deltas) {
+            token_database_snapshot::read_delta_from_snapshot(delta, token_db);
+        }
         db.set_revision(head->block_num);
+
+        // following delta snapshots can be based on the loaded one
+        if(conf.delta_snapshots) {
+            token_db.reset_changes();
+        }
+        last_snapshot_block_id = head->id;
     }
 
     sha256
     calculate_integrity_hash() const {
-        auto enc = sha256::encoder();
-        auto hash_writer = std::make_shared<integrity_hash_snapshot_writer>(enc);
+        // sections are hashed separately and token sections are hashed on thread pool
+        auto hash_writer = std::make_shared<merkle_hash_snapshot_writer>();
         add_to_snapshot(hash_writer);
-        hash_writer->finalize();
 
-        return enc.result();
+        return hash_writer->finalize();
     }
 
     /**
@@ -866,6 +936,43 @@ struct controller_impl {
         static_cast<signed_block_header&>(*p->block) = p->header;
     }  /// sign_block
 
+    std::vector<transaction_metadata_ptr>
+    prepare_block_transactions(const signed_block_ptr& b) {
+        auto recover = !self.skip_auth_check();
+
+        auto futures = std::vector<std::future<transaction_metadata_ptr>>();
+        futures.reserve(b->transactions.size());
+        for(const auto& receipt : b->transactions) {
+            if(receipt.type != transaction_receipt::input) {
+                continue;
+            }
+            futures.emplace_back(async_thread_pool(*thread_pool, [&pt = receipt.trx, recover, this] {
+                auto mtrx = std::make_shared<transaction_metadata>(std::make_shared<packed_transaction>(pt));
+                if(recover) {
+                    try {
+                        mtrx->recover_keys(chain_id);
+                    }
+                    catch(...) {
+                        // keys are recovered again in `push_transaction`, which reports the failure in trace
+                    }
+                }
+                return mtrx;
+            }));
+        }
+
+        // cannot use `wait_all_futures` here because results are needed
+        for(auto& f : futures) {
+            f.wait();
+        }
+
+        auto mtrxs = std::vector<transaction_metadata_ptr>();
+        mtrxs.reserve(futures.size());
+        for(auto& f : futures) {
+            mtrxs.emplace_back(f.get());
+        }
+        return mtrxs;
+    }
+
     void
     apply_block(const signed_block_ptr& b, controller::block_status s) {
         try {
@@ -874,14 +981,16 @@ struct controller_impl {
                 auto producer_block_id = b->id();
                 start_block(b->timestamp, b->confirmed, s, producer_block_id);
 
+                // unpacking, hashing and recovering keys only touch the transaction itself
+                // so they're done in parallel ahead, transactions are still executed in the order of block
+                auto mtrxs = prepare_block_transactions(b);
+
                 auto num_pending_receipts = pending->_pending_block_state->block->transactions.size();
+                auto mtrx_it = mtrxs.begin();
                 for(const auto& receipt : b->transactions) {
                     auto trace = transaction_trace_ptr();
                     if(receipt.type == transaction_receipt::input) {
-                        auto& pt    = receipt.trx;
-                        auto  mtrx  = std::make_shared<transaction_metadata>(std::make_shared<packed_transaction>(pt));
-                        
-                        trace = push_transaction(mtrx, fc::time_point::maximum());
+                        trace = push_transaction(*mtrx_it++, fc::time_point::maximum());
                     }
                     else if(receipt.type == transaction_receipt::suspend) {
                         // suspend transaction is executed in its parent transaction
@@ -1089,23 +1198,31 @@ struct controller_impl {
 
     void
     set_action_merkle() {
-        vector<digest_type> action_digests;
-        action_digests.reserve(pending->_actions.size());
-        for(const auto& a : pending->_actions) {
-            action_digests.emplace_back(a.digest());
-        }
+        // same as `action_receipt::digest()` of each action, but hashed in one batch
+        auto action_digests = digest_type::hash_many(pending->_actions);
 
         pending->_pending_block_state->header.action_mroot = merkle(move(action_digests));
     }
 
     void
     set_trx_merkle() {
-        vector<digest_type> trx_digests;
-        const auto&         trxs = pending->_pending_block_state->block->transactions;
-        trx_digests.reserve(trxs.size());
-        for(const auto& trx : trxs) {
-            trx_digests.emplace_back(trx.digest());
-        }
+        const auto& trxs = pending->_pending_block_state->block->transactions;
+
+        // batched version of `transaction_receipt::digest()` and `packed_transaction::packed_digest()`
+        // every stage must pack the same fields in the same order as them
+        auto prunable_digests = digest_type::hash_many(trxs.size(), [&](auto& ds, size_t i) {
+            fc::raw::pack(ds, trxs[i].trx.get_signatures());
+        });
+        auto packed_digests = digest_type::hash_many(trxs.size(), [&](auto& ds, size_t i) {
+            fc::raw::pack(ds, trxs[i].trx.get_compression());
+            fc::raw::pack(ds, trxs[i].trx.get_packed_transaction());
+            fc::raw::pack(ds, prunable_digests[i]);
+        });
+        auto trx_digests = digest_type::hash_many(trxs.size(), [&](auto& ds, size_t i) {
+            fc::raw::pack(ds, trxs[i].status);
+            fc::raw::pack(ds, trxs[i].type);
+            fc::raw::pack(ds, packed_digests[i]);
+        });
 
         pending->_pending_block_state->header.transaction_mroot = merkle(move(trx_digests));
     }
@@ -1165,7 +1282,7 @@ controller::add_indices() {
 }
 
 void
-controller::startup(const snapshot_reader_ptr& snapshot) {
+controller::startup(const snapshot_reader_ptr& snapshot, const std::vector<snapshot_reader_ptr>& deltas) {
     my->head = my->fork_db.head();
     if(snapshot) {
         ilog("Starting initialization from snapshot, this may take a significant amount of time");
@@ -1175,7 +1292,7 @@ controller::startup(const snapshot_reader_ptr& snapshot) {
     }
 
     try {
-        my->init(snapshot);
+        my->init(snapshot, deltas);
     }
     catch(boost::interprocess::bad_alloc& e) {
         if(snapshot) {
@@ -1188,6 +1305,11 @@ controller::startup(const snapshot_reader_ptr& snapshot) {
     }
 }
 
+boost::asio::thread_pool&
+controller::get_thread_pool() const {
+    return *my->thread_pool;
+}
+
 chainbase::database&
 controller::db() const {
     return my->db;
@@ -1467,7 +1589,27 @@ controller::calculate_integrity_hash() const {
 void
 controller::write_snapshot(const snapshot_writer_ptr& snapshot) const {
     EVT_ASSERT(!my->pending.has_value(), block_validate_exception, "cannot take a consistent snapshot with a pending block");
-    return my->add_to_snapshot(snapshot);
+    my->add_to_snapshot(snapshot);
+
+    // start tracking changes for the delta snapshots
+    if(my->conf.delta_snapshots) {
+        my->token_db.reset_changes();
+    }
+    my->last_snapshot_block_id = my->head->id;
+}
+
+void
+controller::write_delta_snapshot(const snapshot_writer_ptr& snapshot) const {
+    EVT_ASSERT(!my->pending.has_value(), block_validate_exception, "cannot take a consistent snapshot with a pending block");
+    EVT_ASSERT(my->conf.delta_snapshots, snapshot_exception, "cannot take a delta snapshot when delta snapshots are not enabled");
+    EVT_ASSERT(my->last_snapshot_block_id.has_value(), snapshot_exception,
+               "cannot take a delta snapshot without a base snapshot written or loaded before");
+    EVT_ASSERT(my->token_db.is_tracking_changes(), snapshot_exception,
+               "too many changes since the base snapshot, take a full snapshot instead");
+    my->add_to_snapshot(snapshot, true /* delta */);
+
+    my->token_db.reset_changes();
+    my->last_snapshot_block_id = my->head->id;
 }
 
 void
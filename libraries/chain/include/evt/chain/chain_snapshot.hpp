@@ -4,6 +4,7 @@
  */
 #pragma once
 
+#include <evt/chain/types.hpp>
 #include <evt/chain/exceptions.hpp>
 
 namespace evt { namespace chain {
@@ -30,6 +31,16 @@ struct chain_snapshot_header {
     }
 };
 
+/**
+ * Delta snapshot only contains the changes of token database since its base snapshot,
+ * it needs to be applied upon the base snapshot or the previous delta in the chain.
+ */
+struct delta_snapshot_header {
+    block_id_type base_block_id;  ///< head block of the snapshot which this delta based on
+    block_id_type head_block_id;
+};
+
 }}  // namespace evt::chain
 
-FC_REFLECT(evt::chain::chain_snapshot_header, (version))
\ No newline at end of file
+FC_REFLECT(evt::chain::chain_snapshot_header, (version))
+FC_REFLECT(evt::chain::delta_snapshot_header, (base_block_id)(head_block_id))
\ No newline at end of file
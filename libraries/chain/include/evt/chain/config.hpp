@@ -19,12 +19,15 @@ const static auto default_token_database_dir_name  = "tokendb";
 const static auto default_reversible_cache_size    = 340*1024*1024ll;  /// 1MB * 340 blocks based on 21 producer BFT delay
 const static auto default_reversible_guard_size    = 2*1024*1024ll;    /// 1MB * 2 blocks based on 21 producer BFT delay
 const static auto token_database_persisit_filename = "savepoints.log";
+const static auto token_database_journal_filename  = "savepoints.journal";
 
 const static auto default_state_dir_name        = "state";
 const static auto forkdb_filename               = "forkdb.dat";
 const static auto default_state_size            = 1*1024*1024*1024ll;
 const static auto default_state_guard_size      = 128*1024*1024ll;
 
+const static uint16_t default_controller_thread_pool_size = 2;
+
 const static uint128_t system_account_name = N128(evt);
 
 const static int      block_interval_ms     = 500;
@@ -73,6 +76,8 @@ const static int irreversible_threshold_percent = 70 * percent_1;
 
 const static int default_evt_link_expired_secs = 20;  // 20s -> total: 40s
 
+const static uint64_t psvbonus_acc_scale = 1'000'000'000'000;  // scale of bonus accumulated per unit of holding
+
 }}}  // namespace evt::chain::config
 
 template <typename Number>
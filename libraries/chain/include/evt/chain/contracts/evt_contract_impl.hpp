@@ -165,7 +165,7 @@ get_db_key<evt_link_object>(const evt_link_object& v) {
     return v.link_id;
 }
 
-enum psvbonus_type { kPsvBonus = 0, kPsvBonusSlim };
+enum psvbonus_type { kPsvBonus = 0, kPsvBonusSlim, kPsvBonusHolders };
 
 name128
 get_psvbonus_db_key(symbol_id_type id, uint64_t nonce) {
@@ -186,6 +186,34 @@ get_db_key<passive_bonus_slim>(const passive_bonus_slim& pbs) {
     return get_psvbonus_db_key(pbs.sym_id, kPsvBonusSlim);
 }
 
+template<>
+name128
+get_db_key<fungible_holders>(const fungible_holders& fh) {
+    return get_psvbonus_db_key(fh.sym_id, kPsvBonusHolders);
+}
+
+// holder bonus is stored along with the distributions of rounds
+name128
+get_holder_bonus_db_key(symbol_id_type sym_id, const address& addr) {
+    char buf[sizeof(sym_id) + sizeof(fc::ecc::public_key_shim)];
+    memcpy(buf, &sym_id, sizeof(sym_id));
+    addr.to_bytes(buf + sizeof(sym_id), addr.get_bytes_size());
+
+    auto h = fc::sha256::hash(buf, sizeof(buf));
+    auto v = uint128_t();
+    memcpy(&v, h.data(), sizeof(v));
+
+    // keys of rounds never have the highest bit set
+    v |= ((uint128_t)1 << 127);
+    return v;
+}
+
+template<>
+name128
+get_db_key<holder_bonus>(const holder_bonus& hb) {
+    return get_holder_bonus_db_key(hb.sym_id, hb.addr);
+}
+
 template<typename T>
 std::optional<name128>
 get_db_prefix(const T& v) {
@@ -627,6 +655,108 @@ calculate_passive_bonus(token_database_cache& tokendb_cache,
     return std::make_pair(amount, 0l);
 }
 
+void
+apply_holder_change(fungible_holders& fh, int64_t before, int64_t after) {
+    fh.total += after - before;
+    fh.count += (after > 0) - (before > 0);
+
+    for(auto& b : fh.buckets) {
+        if(before > 0 && before >= b.threshold) {
+            b.total -= before;
+            b.count--;
+        }
+        if(after > 0 && after >= b.threshold) {
+            b.total += after;
+            b.count++;
+        }
+    }
+}
+
+// bonus accumulated since last settlement, `balance` is the one held since then
+int64_t
+get_unsettled_bonus(int64_t threshold, const holder_reward& reward, const holder_bonus_entry& entry, int64_t balance) {
+    if(balance <= 0 || balance < threshold) {
+        return 0;
+    }
+    return (int64_t)((uint128_t)balance * (reward.acc - entry.acc) / config::psvbonus_acc_scale);
+}
+
+// settle the bonus of holder with the balance it holds before the change
+void
+settle_holder_bonus(token_database_cache& tokendb_cache, const fungible_holders& fh, const address& addr, int64_t balance) {
+    auto hb = make_empty_cache_ptr<holder_bonus>();
+    READ_DB_TOKEN_NO_THROW(token_type::psvbonus_dist, std::nullopt, get_holder_bonus_db_key(fh.sym_id, addr), hb);
+
+    auto nhb   = holder_bonus();
+    nhb.addr   = addr;
+    nhb.sym_id = fh.sym_id;
+
+    auto& h = (hb != nullptr) ? *hb : nhb;
+    EVT_ASSERT2(h.addr == addr, bonus_exception, "Conflict keys of holder bonus between {} and {}", h.addr, addr);
+
+    for(auto& b : fh.buckets) {
+        for(auto& r : b.rewards) {
+            auto it = std::find_if(h.entries.begin(), h.entries.end(), [&](auto& e) {
+                return e.threshold == b.threshold && e.bonus_sym_id == r.bonus_sym_id;
+            });
+            if(it == h.entries.end()) {
+                // holders never settled are the ones held since the bucket was built
+                h.entries.emplace_back(holder_bonus_entry {
+                    .threshold    = b.threshold,
+                    .bonus_sym_id = r.bonus_sym_id,
+                    .acc          = 0,
+                    .pending      = 0
+                });
+                it = std::prev(h.entries.end());
+            }
+
+            it->pending += get_unsettled_bonus(b.threshold, r, *it, balance);
+            it->acc      = r.acc;
+        }
+    }
+    PUT_DB_TOKEN(token_type::psvbonus_dist, h);
+}
+
+struct holder_change {
+    const address* addr;
+    int64_t        before;
+    int64_t        after;
+};
+using holder_changes = small_vector<holder_change, 4>;
+
+// holders aggregate only exists for the fungibles used by `ftholders` receivers
+void
+update_fungible_holders(token_database_cache& tokendb_cache, symbol_id_type sym_id, const holder_changes& changes) {
+    auto fh = make_empty_cache_ptr<fungible_holders>();
+    READ_DB_TOKEN_NO_THROW(token_type::psvbonus, std::nullopt, get_psvbonus_db_key(sym_id, kPsvBonusHolders), fh);
+
+    if(fh == nullptr) {
+        return;
+    }
+
+    // one address may be changed more than once (ex. payer is the producer in `paycharge`),
+    // merge them into one from its first balance to the last written one
+    auto merged = holder_changes();
+    for(auto& c : changes) {
+        auto it = std::find_if(merged.begin(), merged.end(), [&](auto& m) { return *m.addr == *c.addr; });
+        if(it != merged.end()) {
+            it->after = c.after;
+            continue;
+        }
+        merged.emplace_back(c);
+    }
+
+    // only needs to settle after any lazy distribution
+    auto lazy = std::any_of(fh->buckets.cbegin(), fh->buckets.cend(), [](auto& b) { return !b.rewards.empty(); });
+    for(auto& c : merged) {
+        if(lazy) {
+            settle_holder_bonus(tokendb_cache, *fh, *c.addr, c.before);
+        }
+        apply_holder_change(*fh, c.before, c.after);
+    }
+    UPD_DB_TOKEN(token_type::psvbonus, *fh);
+}
+
 void
 transfer_fungible(apply_context& context,
                   const address& from,
@@ -670,6 +800,8 @@ transfer_fungible(apply_context& context,
     auto r2 = checked::add<int64_t>(pto.amount, receive_amount);
     EVT_ASSERT(!r1.exception() && !r2.exception(), math_overflow_exception, "Opeartions resulted in overflows.");
     
+    auto from_before = pfrom.amount, to_before = pto.amount;
+
     // update payee and payer
     pfrom.amount -= actual_amount;
     pto.amount   += receive_amount;
@@ -677,6 +809,17 @@ transfer_fungible(apply_context& context,
     PUT_DB_ASSET(to, pto);
     PUT_DB_ASSET(from, pfrom);
 
+    auto changes = holder_changes();
+    if(pfrom.sym != pto.sym) {
+        // evt2pevt: evt is paid and pevt is received
+        update_fungible_holders(tokendb_cache, pto.sym.id(), { holder_change { &to, to_before, pto.amount } });
+    }
+    else if(from != to) {
+        changes.emplace_back(holder_change { &to, to_before, pto.amount });
+    }
+    // when `from` equals to `to`, balance of `from` is the one written at last
+    changes.emplace_back(holder_change { &from, from_before, pfrom.amount });
+
     // update bonus if needed
     if(bonus_amount > 0) {
         auto addr = get_psvbonus_address(sym.id(), 0);
@@ -687,6 +830,8 @@ transfer_fungible(apply_context& context,
         auto r = checked::add<int64_t>(pbonus.amount, bonus_amount);
         EVT_ASSERT2(!r.exception(), math_overflow_exception, "Opeartions resulted in overflows.");
 
+        changes.emplace_back(holder_change { &addr, pbonus.amount, pbonus.amount + bonus_amount });
+
         pbonus.amount += bonus_amount;
         PUT_DB_ASSET(addr, pbonus);
 
@@ -697,6 +842,8 @@ transfer_fungible(apply_context& context,
         context.add_generated_action(action(N128(.fungible), name128::from_number(sym.id()), pbact))
             .set_index(context.exec_ctx.index_of<paybonus>());
     }
+
+    update_fungible_holders(tokendb_cache, pfrom.sym.id(), changes);
 }
 
 }  // namespace __internal
@@ -1323,10 +1470,13 @@ EVT_ACTION_IMPL_BEGIN(paycharge) {
         READ_DB_ASSET_NO_THROW_NO_NEW(pcact.payer, pevt_sym(), pevt);
         auto paid = std::min((int64_t)pcact.charge, pevt.amount);
         if(paid > 0) {
+            update_fungible_holders(tokendb_cache, PEVT_SYM_ID, { holder_change { &pcact.payer, pevt.amount, pevt.amount - paid } });
+
             pevt.amount -= paid;
             PUT_DB_ASSET(pcact.payer, pevt);
         }
 
+        auto changes = holder_changes();
         if(paid < pcact.charge) {
             READ_DB_ASSET_NO_THROW_NO_NEW(pcact.payer, evt_sym(), evt);
             auto remain = pcact.charge - paid;
@@ -1334,6 +1484,8 @@ EVT_ACTION_IMPL_BEGIN(paycharge) {
                 EVT_THROW2(charge_exceeded_exception,"There are only {} and {} left, but charge is {}",
                     asset(evt.amount, evt_sym()), asset(pevt.amount, pevt_sym()), asset(pcact.charge, evt_sym()));
             }
+            changes.emplace_back(holder_change { &pcact.payer, evt.amount, evt.amount - remain });
+
             evt.amount -= remain;
             PUT_DB_ASSET(pcact.payer, evt);
         }
@@ -1341,11 +1493,17 @@ EVT_ACTION_IMPL_BEGIN(paycharge) {
         auto  pbs  = context.control.pending_block_state();
         auto& prod = pbs->get_scheduled_producer(pbs->header.timestamp).block_signing_key;
 
+        auto prod_addr = address(prod);
+
         property bp;
-        READ_DB_ASSET_NO_THROW(address(prod), evt_sym(), bp);
+        READ_DB_ASSET_NO_THROW(prod_addr, evt_sym(), bp);
         // give charge to producer
+        changes.emplace_back(holder_change { &prod_addr, bp.amount, bp.amount + pcact.charge });
+
         bp.amount += pcact.charge;
-        PUT_DB_ASSET(prod, bp);
+        PUT_DB_ASSET(prod_addr, bp);
+
+        update_fungible_holders(tokendb_cache, EVT_SYM_ID, changes);
     }
     EVT_CAPTURE_AND_RETHROW(tx_apply_exception);
 }
@@ -2054,6 +2212,122 @@ to_rules_v2(const dist_rules& rules_v1) {
     return rules;
 }
 
+std::optional<dist_stack_receiver>
+get_ftholders_receiver(const dist_rule_v2& rule) {
+    auto ftrev = std::optional<dist_stack_receiver>();
+
+    switch(rule.type()) {
+    case dist_rule_type::fixed: {
+        auto& fr = rule.template get<dist_fixed_rule>();
+        if(fr.receiver.type() == dist_receiver_type::ftholders) {
+            ftrev = fr.receiver.template get<dist_stack_receiver>();
+        }
+        break;
+    }
+    case dist_rule_type::percent:
+    case dist_rule_type::remaining_percent: {
+        rule.visit([&ftrev](auto& pr) {
+            if(pr.receiver.type() == dist_receiver_type::ftholders) {
+                ftrev = pr.receiver.template get<dist_stack_receiver>();
+            }
+        });
+        break;
+    }
+    }  // switch
+
+    return ftrev;
+}
+
+// amounts of each rule when distributing `total`, rules are already checked in `setpsvbonus`
+small_vector<int64_t, 4>
+calculate_rule_amounts(const dist_rules_v2& rules, int64_t total) {
+    auto amounts = small_vector<int64_t, 4>();
+    amounts.reserve(rules.size());
+
+    auto remain = total;
+    for(auto& rule : rules) {
+        switch(rule.type()) {
+        case dist_rule_type::fixed: {
+            auto& fr = rule.template get<dist_fixed_rule>();
+            amounts.emplace_back(fr.amount.amount());
+            remain -= fr.amount.amount();
+            break;
+        }
+        case dist_rule_type::percent: {
+            auto& pr = rule.template get<dist_rule_type::percent>();
+            auto  p  = (percent_type)pr.percent;
+            auto  v  = (int64_t)boost::multiprecision::floor(p * real_type(total));
+            amounts.emplace_back(v);
+            remain -= v;
+            break;
+        }
+        case dist_rule_type::remaining_percent: {
+            // remaining-percent rules are all behind the others and share the same remains
+            auto& pr = rule.template get<dist_rule_type::remaining_percent>();
+            auto  p  = (percent_type)pr.percent;
+            amounts.emplace_back((int64_t)boost::multiprecision::floor(p * real_type(remain)));
+            break;
+        }
+        }  // switch
+    }
+
+    return amounts;
+}
+
+// holders aggregate is built by scanning all the holders only once when it's first used
+// and then it's kept up to date by `update_fungible_holders`
+// the scan cannot be avoided: total of a bucket depends on the balance of each holder against its threshold,
+// which any aggregate maintained before the threshold is known cannot provide
+void
+add_holders_bucket(const token_database& tokendb, token_database_cache& tokendb_cache, const asset& threshold) {
+    auto sym_id = threshold.symbol_id();
+
+    auto fh = make_empty_cache_ptr<fungible_holders>();
+    READ_DB_TOKEN_NO_THROW(token_type::psvbonus, std::nullopt, get_psvbonus_db_key(sym_id, kPsvBonusHolders), fh);
+
+    auto exists = (fh != nullptr);
+    if(exists) {
+        auto it = std::find_if(fh->buckets.cbegin(), fh->buckets.cend(), [&](auto& b) { return b.threshold == threshold.amount(); });
+        if(it != fh->buckets.cend()) {
+            return;
+        }
+    }
+
+    auto nfh   = fungible_holders();
+    nfh.sym_id = sym_id;
+    nfh.total  = 0;
+    nfh.count  = 0;
+
+    auto& h = exists ? *fh : nfh;
+    auto  b = holder_bucket {
+        .threshold = threshold.amount(),
+        .total     = 0,
+        .count     = 0,
+        .rewards   = holder_rewards()
+    };
+    tokendb.read_assets_range(sym_id, 0, [&](auto& k, auto&& v) {
+        property prop;
+        extract_db_value(v, prop);
+
+        if(!exists) {
+            apply_holder_change(h, 0, prop.amount);
+        }
+        if(prop.amount > 0 && prop.amount >= b.threshold) {
+            b.total += prop.amount;
+            b.count++;
+        }
+        return true;
+    });
+    h.buckets.emplace_back(b);
+
+    if(exists) {
+        UPD_DB_TOKEN(token_type::psvbonus, h);
+    }
+    else {
+        ADD_DB_TOKEN(token_type::psvbonus, h);
+    }
+}
+
 } // namespace __internal
 
 EVT_ACTION_IMPL_BEGIN(setpsvbonus) {
@@ -2121,6 +2395,17 @@ EVT_ACTION_IMPL_BEGIN(setpsvbonus) {
             pb.rules = std::move(spbact.rules);
         }
 
+        if constexpr (EVT_ACTION_VER() >= 3) {
+            // holders aggregate is only maintained since version 3
+            // so that blocks applied by earlier versions keep the same tokens
+            for(auto& rule : pb.rules) {
+                auto ftrev = get_ftholders_receiver(rule);
+                if(ftrev.has_value()) {
+                    add_holders_bucket(tokendb, tokendb_cache, ftrev->threshold);
+                }
+            }
+        }
+
         check_passive_methods(context.control.get_execution_context(), spbact.methods);
         pb.methods = std::move(spbact.methods);
         
@@ -2205,6 +2490,17 @@ build_holder_dist(const token_database& tokendb, symbol sym, holder_dist& dist)
 
 using holder_dists = small_vector<holder_dist, 4>;
 
+// constant sized snapshot of the holders for one `ftholders` rule in lazy distribution
+struct holder_snapshot {
+    symbol_id_type sym_id;
+    int64_t        threshold;
+    int64_t        total;   // total balance of the holders reached threshold
+    uint32_t       count;
+    int64_t        amount;  // bonus for the holders in this round
+    uint128_t      acc;     // accumulated bonus per unit after this round
+};
+using holder_snapshots = small_vector<holder_snapshot, 4>;
+
 struct bonusdist {
     uint32_t          created_at;    // utc seconds
     uint32_t          created_index; // action index at that time
@@ -2214,6 +2510,25 @@ struct bonusdist {
     optional<address> final_receiver;
 };
 
+// share of each holder is derived from the snapshots and the settled `holder_bonus`
+struct bonusdist_lazy {
+    uint32_t          created_at;    // utc seconds
+    uint32_t          created_index; // action index at that time
+    int64_t           total;         // total amount for bonus
+    holder_snapshots  holders;
+    time_point_sec    deadline;
+    optional<address> final_receiver;
+};
+
+using bonusdist_variant = fc::static_variant<bonusdist, bonusdist_lazy>;
+
+// rounds distributed by `distpsvbonus` v2 and later are stored tagged
+// leading zero tells them apart from the untagged `bonusdist` of v1, whose `created_at` is never zero
+struct bonusdist_tagged {
+    uint32_t          zero = 0;
+    bonusdist_variant dist;
+};
+
 name128
 get_psvbonus_dist_db_key(uint64_t sym_id, uint64_t round) {
     uint128_t v = round;
@@ -2221,6 +2536,49 @@ get_psvbonus_dist_db_key(uint64_t sym_id, uint64_t round) {
     return v;
 }
 
+bool
+has_holders_bucket(token_database_cache& tokendb_cache, const asset& threshold) {
+    auto fh = make_empty_cache_ptr<fungible_holders>();
+    READ_DB_TOKEN_NO_THROW(token_type::psvbonus, std::nullopt, get_psvbonus_db_key(threshold.symbol_id(), kPsvBonusHolders), fh);
+    if(fh == nullptr) {
+        return false;
+    }
+
+    return std::any_of(fh->buckets.cbegin(), fh->buckets.cend(), [&](auto& b) { return b.threshold == threshold.amount(); });
+}
+
+// distribute `amount` of bonus to the holders in O(1)
+// share of each holder is settled when its balance changes or derived when it's queried
+holder_snapshot
+accumulate_holders_bonus(token_database_cache& tokendb_cache, const asset& threshold, symbol_id_type bonus_sym_id, int64_t amount) {
+    auto fh = make_empty_cache_ptr<fungible_holders>();
+    READ_DB_TOKEN(token_type::psvbonus, std::nullopt, get_psvbonus_db_key(threshold.symbol_id(), kPsvBonusHolders), fh,
+        unknown_bonus_exception, "Cannot find holders of fungible with sym id: {}", threshold.symbol_id());
+
+    auto bit = std::find_if(fh->buckets.begin(), fh->buckets.end(), [&](auto& b) { return b.threshold == threshold.amount(); });
+    assert(bit != fh->buckets.end());
+
+    auto rit = std::find_if(bit->rewards.begin(), bit->rewards.end(), [&](auto& r) { return r.bonus_sym_id == bonus_sym_id; });
+    if(rit == bit->rewards.end()) {
+        bit->rewards.emplace_back(holder_reward { .bonus_sym_id = bonus_sym_id, .acc = 0 });
+        rit = std::prev(bit->rewards.end());
+    }
+    // amount is not accumulated when no holder reaches the threshold, caller takes it over
+    if(bit->total > 0) {
+        rit->acc += (uint128_t)amount * config::psvbonus_acc_scale / bit->total;
+    }
+    UPD_DB_TOKEN(token_type::psvbonus, *fh);
+
+    return holder_snapshot {
+        .sym_id    = fh->sym_id,
+        .threshold = bit->threshold,
+        .total     = bit->total,
+        .count     = bit->count,
+        .amount    = amount,
+        .acc       = rit->acc
+    };
+}
+
 }  // namespace __internal
 
 EVT_ACTION_IMPL_BEGIN(distpsvbonus) {
@@ -2244,50 +2602,76 @@ EVT_ACTION_IMPL_BEGIN(distpsvbonus) {
         EVT_ASSERT2(pbonus.amount >= pb->dist_threshold.amount(), bonus_unreached_dist_threshold,
             "Distribution threshold: {} is unreached, current: {}", pb->dist_threshold, asset(pbonus.amount, sym));
 
-        auto bd = bonusdist();
-        for(auto& rule : pb->rules) {
-            auto ftrev = std::optional<dist_stack_receiver>();
+        auto fill_round = [&](auto& bd) {
+            bd.created_at     = context.control.pending_block_time().sec_since_epoch();
+            bd.created_index  = context.get_index_of_trx();
+            bd.deadline       = spbact.deadline;
+            bd.final_receiver = spbact.final_receiver;
+        };
+
+        // bonuses registered with holders aggregates are distributed lazily since version 2
+        auto lazy = false;
+        if constexpr (EVT_ACTION_VER() >= 2) {
+            lazy = std::all_of(pb->rules.cbegin(), pb->rules.cend(), [&](auto& rule) {
+                auto ftrev = get_ftholders_receiver(rule);
+                return !ftrev.has_value() || has_holders_bucket(tokendb_cache, ftrev->threshold);
+            });
+        }
+
+        auto bd          = bonusdist_tagged();
+        auto unallocated = int64_t(0);
+        if(lazy) {
+            auto lbd  = bonusdist_lazy();
+            lbd.total = pbonus.amount;
 
-            switch(rule.type()) {
-            case dist_rule_type::fixed: {
-                auto& fr = rule.template get<dist_fixed_rule>();
-                if(fr.receiver.type() == dist_receiver_type::ftholders) {
-                    ftrev = fr.receiver.template get<dist_stack_receiver>();
+            auto amounts = calculate_rule_amounts(pb->rules, pbonus.amount);
+            for(auto i = 0u; i < pb->rules.size(); i++) {
+                auto ftrev = get_ftholders_receiver(pb->rules[i]);
+                if(!ftrev.has_value()) {
+                    continue;
                 }
-                break;
-            }
-            case dist_rule_type::percent:
-            case dist_rule_type::remaining_percent: {
-                rule.visit([&ftrev](auto& pr) {
-                    if(pr.receiver.type() == dist_receiver_type::ftholders) {
-                        ftrev = pr.receiver.template get<dist_stack_receiver>();
-                    }
-                });
-                break;
-            }
-            }  // switch
 
-            if(ftrev.has_value()) {
-                auto dist = holder_dist();
-                build_holder_dist(tokendb, ftrev->threshold.sym(), dist);
-                bd.holders.emplace_back(std::move(dist));
+                auto hs = accumulate_holders_bonus(tokendb_cache, ftrev->threshold, spbact.sym_id, amounts[i]);
+                if(hs.total == 0) {
+                    // no holder reaches the threshold, the amount goes to final receiver
+                    EVT_ASSERT2(spbact.final_receiver.has_value(), bonus_receiver_exception,
+                        "There's no holders reached threshold: {}, final receiver is required", ftrev->threshold);
+                    unallocated += hs.amount;
+                }
+                lbd.holders.emplace_back(std::move(hs));
             }
+            fill_round(lbd);
+
+            bd.dist = std::move(lbd);
         }
+        else {
+            auto ebd = bonusdist();
+            for(auto& rule : pb->rules) {
+                auto ftrev = get_ftholders_receiver(rule);
+                if(ftrev.has_value()) {
+                    auto dist = holder_dist();
+                    build_holder_dist(tokendb, ftrev->threshold.sym(), dist);
+                    ebd.holders.emplace_back(std::move(dist));
+                }
+            }
+            fill_round(ebd);
 
-        bd.created_at     = context.control.pending_block_time().sec_since_epoch();
-        bd.created_index  = context.get_index_of_trx();
-        bd.deadline       = spbact.deadline;
-        bd.final_receiver = spbact.final_receiver;
+            bd.dist = std::move(ebd);
+        }
 
         pb->round++;
         pb->deadline = spbact.deadline;
         UPD_DB_TOKEN(token_type::psvbonus, *pb);
 
-        auto dbv = make_db_value(bd);
+        // rounds distributed by version 1 are stored untagged
+        auto dbv = (EVT_ACTION_VER() == 1) ? make_db_value(bd.dist.template get<bonusdist>()) : make_db_value(bd);
         tokendb_cache.put_token(token_type::psvbonus_dist, action_op::add, std::nullopt, get_psvbonus_db_key(spbact.sym_id, pb->round), dbv);
 
         // transfer all the FTs from cllected address to distribute address of current round
         transfer_fungible(context, get_psvbonus_address(spbact.sym_id, 0), get_psvbonus_address(spbact.sym_id, pb->round), asset(pbonus.amount, pbonus.sym), N(distpsvbonus), false /* pay bonus */);
+        if(unallocated > 0) {
+            transfer_fungible(context, get_psvbonus_address(spbact.sym_id, pb->round), *spbact.final_receiver, asset(unallocated, pbonus.sym), N(distpsvbonus), false /* pay bonus */);
+        }
     }
     EVT_CAPTURE_AND_RETHROW(tx_apply_exception);
 }
@@ -2297,3 +2681,6 @@ EVT_ACTION_IMPL_END()
 
 FC_REFLECT(evt::chain::contracts::__internal::holder_dist, (sym_id)(slim)(coll)(total));
 FC_REFLECT(evt::chain::contracts::__internal::bonusdist, (created_at)(created_index)(holders)(deadline)(final_receiver));
+FC_REFLECT(evt::chain::contracts::__internal::holder_snapshot, (sym_id)(threshold)(total)(count)(amount)(acc));
+FC_REFLECT(evt::chain::contracts::__internal::bonusdist_lazy, (created_at)(created_index)(total)(holders)(deadline)(final_receiver));
+FC_REFLECT(evt::chain::contracts::__internal::bonusdist_tagged, (zero)(dist));
@@ -298,6 +298,45 @@ struct passive_bonus_slim {
     passive_methods   methods;
 };
 
+// bonus accumulated for each unit of balance held, scaled by `config::psvbonus_acc_scale`
+struct holder_reward {
+    symbol_id_type bonus_sym_id;
+    uint128_t      acc;
+};
+using holder_rewards = small_vector<holder_reward, 2>;
+
+struct holder_bucket {
+    int64_t        threshold;  // only holders whose balance is not less than threshold are counted
+    int64_t        total;
+    uint32_t       count;
+    holder_rewards rewards;    // only for the bonuses distributed lazily
+};
+using holder_buckets = small_vector<holder_bucket, 4>;
+
+// pre-aggregated holders of one fungible, kept up to date when balances change
+struct fungible_holders {
+    symbol_id_type sym_id;
+    int64_t        total;
+    uint32_t       count;    // holders with positive balance
+    holder_buckets buckets;  // one for each threshold used by `ftholders` receivers
+};
+
+struct holder_bonus_entry {
+    int64_t        threshold;
+    symbol_id_type bonus_sym_id;
+    uint128_t      acc;      // `acc` of reward when settled at last time
+    int64_t        pending;  // settled but not paid bonus
+};
+
+using holder_bonus_entries = small_vector<holder_bonus_entry, 2>;
+
+// bonus of one holder, settled before each change of its balance
+struct holder_bonus {
+    address              addr;
+    symbol_id_type       sym_id;
+    holder_bonus_entries entries;
+};
+
 struct newdomain {
     domain_name name;
     user_id     creator;
@@ -597,6 +636,19 @@ struct setpsvbonus_v2 {
     EVT_ACTION_VER2(setpsvbonus, setpsvbonus_v2);
 };
 
+struct setpsvbonus_v3 {
+    symbol_id_type  sym_id;
+    percent_slim    rate;
+    asset           base_charge;
+    optional<asset> charge_threshold;
+    optional<asset> minimum_charge;
+    asset           dist_threshold;
+    dist_rules_v2   rules;
+    passive_methods methods;
+
+    EVT_ACTION_VER3(setpsvbonus, setpsvbonus_v3);
+};
+
 struct distpsvbonus {
     symbol_id_type    sym_id;
     time_point        deadline;
@@ -605,6 +657,14 @@ struct distpsvbonus {
     EVT_ACTION_VER1(distpsvbonus);
 };
 
+struct distpsvbonus_v2 {
+    symbol_id_type    sym_id;
+    time_point        deadline;
+    optional<address> final_receiver;
+
+    EVT_ACTION_VER2(distpsvbonus, distpsvbonus_v2);
+};
+
 struct recvpsvbonus {
     symbol_id_type                   sym_id;
     small_vector<public_key_type, 2> receivers;
@@ -645,6 +705,11 @@ FC_REFLECT_ENUM(evt::chain::contracts::passive_method_type, (within_amount)(outs
 FC_REFLECT(evt::chain::contracts::passive_method, (action)(method));
 FC_REFLECT(evt::chain::contracts::passive_bonus, (sym_id)(rate)(base_charge)(charge_threshold)(minimum_charge)(dist_threshold)(rules)(methods)(round)(deadline));
 FC_REFLECT(evt::chain::contracts::passive_bonus_slim, (sym_id)(rate)(base_charge)(charge_threshold)(minimum_charge)(methods));
+FC_REFLECT(evt::chain::contracts::holder_reward, (bonus_sym_id)(acc));
+FC_REFLECT(evt::chain::contracts::holder_bucket, (threshold)(total)(count)(rewards));
+FC_REFLECT(evt::chain::contracts::fungible_holders, (sym_id)(total)(count)(buckets));
+FC_REFLECT(evt::chain::contracts::holder_bonus_entry, (threshold)(bonus_sym_id)(acc)(pending));
+FC_REFLECT(evt::chain::contracts::holder_bonus, (addr)(sym_id)(entries));
 
 FC_REFLECT(evt::chain::contracts::newdomain, (name)(creator)(issue)(transfer)(manage));
 FC_REFLECT(evt::chain::contracts::issuetoken, (domain)(names)(owner));
@@ -680,4 +745,6 @@ FC_REFLECT(evt::chain::contracts::aprvlock, (name)(approver)(data));
 FC_REFLECT(evt::chain::contracts::tryunlock, (name)(executor));
 FC_REFLECT(evt::chain::contracts::setpsvbonus, (sym)(rate)(base_charge)(charge_threshold)(minimum_charge)(dist_threshold)(rules)(methods));
 FC_REFLECT(evt::chain::contracts::setpsvbonus_v2, (sym_id)(rate)(base_charge)(charge_threshold)(minimum_charge)(dist_threshold)(rules)(methods));
+FC_REFLECT(evt::chain::contracts::setpsvbonus_v3, (sym_id)(rate)(base_charge)(charge_threshold)(minimum_charge)(dist_threshold)(rules)(methods));
 FC_REFLECT(evt::chain::contracts::distpsvbonus, (sym_id)(deadline)(final_receiver));
+FC_REFLECT(evt::chain::contracts::distpsvbonus_v2, (sym_id)(deadline)(final_receiver));
@@ -15,6 +15,10 @@ namespace chainbase {
 class database;
 }
 
+namespace boost { namespace asio {
+class thread_pool;
+}}  // namespace boost::asio
+
 namespace evt { namespace chain {
 
 using unapplied_transactions_type = map<transaction_id_type, transaction_metadata_ptr>;
@@ -70,6 +74,8 @@ public:
         bool     loadtest_mode          = false;
         bool     charge_free_mode       = false;
         bool     contracts_console      = false;
+        bool     delta_snapshots        = false;  // track changes of token database for delta snapshots
+        uint16_t thread_pool_size       = chain::config::default_controller_thread_pool_size;
 
         std::chrono::microseconds max_serialization_time = std::chrono::milliseconds(chain::config::default_abi_serializer_max_time_ms);
 
@@ -94,7 +100,8 @@ public:
     ~controller();
 
     void add_indices();
-    void startup(const std::shared_ptr<snapshot_reader>& snapshot = nullptr);
+    void startup(const std::shared_ptr<snapshot_reader>& snapshot = nullptr,
+                 const std::vector<std::shared_ptr<snapshot_reader>>& deltas = {});
 
     /**
      * Starts a new pending block session upon which new transactions can
@@ -135,6 +142,8 @@ public:
 
     charge_manager get_charge_manager() const;
 
+    boost::asio::thread_pool& get_thread_pool() const;
+
     execution_context& get_execution_context() const;
 
     const global_property_object&         get_global_properties() const;
@@ -175,6 +184,8 @@ public:
 
     fc::sha256 calculate_integrity_hash() const;
     void write_snapshot(const std::shared_ptr<snapshot_writer>& snapshot) const;
+    // only writes the changes of token database since the latest snapshot written or loaded
+    void write_delta_snapshot(const std::shared_ptr<snapshot_writer>& snapshot) const;
 
     bool is_producing_block() const;
 
@@ -236,6 +247,7 @@ FC_REFLECT(evt::chain::controller::config,
            (loadtest_mode)
            (charge_free_mode)
            (contracts_console)
+           (delta_snapshots)
            (trusted_producers)
            (db_config)
            (genesis)
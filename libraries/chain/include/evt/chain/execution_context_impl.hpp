@@ -240,7 +240,9 @@ using evt_execution_context = execution_context_impl<
                                   contracts::tryunlock,
                                   contracts::setpsvbonus,
                                   contracts::setpsvbonus_v2,
-                                  contracts::distpsvbonus
+                                  contracts::setpsvbonus_v3,
+                                  contracts::distpsvbonus,
+                                  contracts::distpsvbonus_v2
                               >;
 
 }}  // namespace evt::chain
@@ -42,7 +42,13 @@ string_to_name(const char* str) {
     return name;
 }
 
-#define N(X) evt::chain::string_to_name(#X)
+template<uint64_t V>
+struct name_literal {
+    static constexpr uint64_t value = V;
+};
+
+// always evaluated at compile-time
+#define N(X) (evt::chain::name_literal<evt::chain::string_to_name(#X)>::value)
 
 struct name {
     uint64_t value = 0;
@@ -54,6 +54,7 @@ public:
 
     void set(const char* str);
     void set(const std::string& str);
+    void set(const char* str, size_t len);
 
     static name128 from_number(uint64_t v);
 
@@ -178,7 +179,13 @@ string_to_name128(const char* str) {
     return name;
 }
 
-#define N128(X) evt::chain::string_to_name128(#X)
+template<uint128_t V>
+struct name128_literal {
+    static constexpr uint128_t value = V;
+};
+
+// always evaluated at compile-time
+#define N128(X) (evt::chain::name128_literal<evt::chain::string_to_name128(#X)>::value)
 
 inline std::vector<name128>
 sort_names(std::vector<name128>&& names) {
@@ -8,7 +8,11 @@
 #include <evt/chain/exceptions.hpp>
 #include <fc/variant_object.hpp>
 #include <boost/core/demangle.hpp>
+#include <map>
+#include <mutex>
 #include <ostream>
+#include <sstream>
+#include <thread>
 
 namespace evt { namespace chain {
 /**
@@ -213,6 +217,9 @@ public:
         write_section(detail::snapshot_section_traits<T>::section_name(), f);
     }
 
+    // whether different sections can be written from multiple threads at the same time
+    virtual bool concurrent() const { return false; }
+
     virtual ~snapshot_writer(){};
 
 protected:
@@ -402,6 +409,9 @@ public:
     virtual size_t get_section_size(const string& section_name) = 0;
     virtual std::vector<std::string> get_section_names(const std::string& prefix) const = 0;
 
+    // whether different sections can be read from multiple threads at the same time
+    virtual bool concurrent() const { return false; }
+
     virtual ~snapshot_reader(){};
 
 protected:
@@ -510,6 +520,116 @@ private:
     std::vector<section_index> section_indexes;
 };
 
+struct snapshot_chunk {
+    std::string name;       // name of section this chunk belongs to
+    uint32_t    index;      // index of chunk in its section
+    uint64_t    pos;        // offset from the header of snapshot
+    uint64_t    size;
+    uint64_t    row_count;
+    uint64_t    checksum;   // city_hash64 of the chunk data
+};
+
+/**
+ * Chunked binary snapshot
+ * Every section is stored as one or more independent checksummed chunks and a chunk table is appended
+ * at the end of snapshot. Sections are buffered per thread so different sections can be written
+ * concurrently, chunks are appended into the underlying stream in the order they are completed.
+ *
+ * Layout: magic | version | chunk data... | chunk table | table position | magic
+ */
+class chunked_snapshot_writer : public snapshot_writer {
+public:
+    explicit chunked_snapshot_writer(std::ostream& snapshot, size_t max_chunk_size = default_max_chunk_size);
+
+    bool concurrent() const override { return true; }
+
+    void write_start_section(const std::string& section_name) override;
+    void write_row(const detail::abstract_snapshot_row_writer& row_writer) override;
+    void write_end_section() override;
+    void finalize();
+
+    static const uint32_t magic_number           = 0x30510551;
+    static const size_t   default_max_chunk_size = 16 * 1024 * 1024;
+
+private:
+    struct pending_section {
+        pending_section(const std::string& name)
+            : name(name), wrapper(buf), chunk_index(0), row_count(0) {}
+
+        std::string             name;
+        std::ostringstream      buf;
+        detail::ostream_wrapper wrapper;
+        uint32_t                chunk_index;
+        uint64_t                row_count;
+    };
+
+    pending_section& current_section();
+    void flush_chunk(pending_section& section);
+
+private:
+    detail::ostream_wrapper snapshot;
+    std::streampos          header_pos;
+    size_t                  max_chunk_size;
+
+    std::mutex                                 mutex;
+    std::map<std::thread::id, pending_section> pendings;
+    std::vector<snapshot_chunk>                chunks;
+};
+
+class chunked_snapshot_reader : public snapshot_reader {
+public:
+    struct section_index {
+        std::string                 name;
+        std::vector<snapshot_chunk> chunks;
+        uint64_t                    row_count = 0;
+        uint64_t                    size      = 0;
+    };
+
+public:
+    explicit chunked_snapshot_reader(std::istream& snapshot);
+
+    static bool is_chunked_snapshot(std::istream& snapshot);
+
+    bool concurrent() const override { return true; }
+
+    void validate() const override;
+    std::vector<std::string> get_section_names(const std::string& prefix) const override;
+    bool has_section(const string& section_name) override;
+    void set_section(const string& section_name) override;
+    size_t get_section_size(const string& section_name) override;
+    bool read_row(detail::abstract_snapshot_row_reader& row_reader) override;
+    bool empty() override;
+    bool eof() override;
+    void clear_section() override;
+
+private:
+    struct cursor {
+        const section_index* section    = nullptr;
+        size_t               next_chunk = 0;
+        uint64_t             chunk_rows = 0;  // rows left in current loaded chunk
+        uint64_t             cur_row    = 0;
+        std::istringstream   buf;
+    };
+
+    void build_section_indexes() override;
+    const section_index& find_section(const string& section_name) const;
+    cursor& current_cursor();
+    void load_chunk(cursor& c);
+
+private:
+    std::istream&   snapshot;
+    std::streampos  header_pos;
+    uint32_t        version;
+    uint64_t        table_pos;
+
+    mutable std::mutex                    mutex;
+    std::map<std::string, section_index> section_indexes;
+    std::map<std::thread::id, cursor>    cursors;
+};
+
+// create binary snapshot reader according to the magic number in the stream
+snapshot_reader_ptr make_snapshot_reader(std::istream& snapshot);
+
 class integrity_hash_snapshot_writer : public snapshot_writer {
 public:
     explicit integrity_hash_snapshot_writer(fc::sha256::encoder& enc);
@@ -523,4 +643,37 @@ private:
     fc::sha256::encoder& enc;
 };
 
+/**
+ * Hashes every section separately and combines the digests of all the sections,
+ * ordered by name, into a merkle root. Sections can be hashed from multiple threads.
+ */
+class merkle_hash_snapshot_writer : public snapshot_writer {
+public:
+    bool concurrent() const override { return true; }
+
+    void write_start_section(const std::string& section_name) override;
+    void write_row(const detail::abstract_snapshot_row_writer& row_writer) override;
+    void write_end_section() override;
+    fc::sha256 finalize();
+
+    const std::map<std::string, fc::sha256>& section_digests() const { return digests; }
+
+private:
+    struct pending_section {
+        pending_section(const std::string& name) : name(name) {}
+
+        std::string         name;
+        fc::sha256::encoder enc;
+    };
+
+    pending_section& current_section();
+
+private:
+    std::mutex                                 mutex;
+    std::map<std::thread::id, pending_section> pendings;
+    std::map<std::string, fc::sha256>          digests;
+};
+
 }}  // namespace evt::chain
+
+FC_REFLECT(evt::chain::snapshot_chunk, (name)(index)(pos)(size)(row_count)(checksum));
@@ -0,0 +1,36 @@
+/**
+ *  @file
+ *  @copyright defined in evt/LICENSE.txt
+ */
+#pragma once
+#include <future>
+#include <memory>
+#include <vector>
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+
+namespace evt { namespace chain {
+
+// post `f` into thread pool and return the future of its result
+template <typename F>
+auto
+async_thread_pool(boost::asio::thread_pool& thread_pool, F&& f) {
+    auto task = std::make_shared<std::packaged_task<decltype(f())()>>(std::forward<F>(f));
+    boost::asio::post(thread_pool, [task]() { (*task)(); });
+    return task->get_future();
+}
+
+// wait for all the futures first and then rethrow the first exception if any
+// tasks may refer to the locals of caller, so it cannot return before all of them finished
+template <typename T>
+void
+wait_all_futures(std::vector<std::future<T>>& futures) {
+    for(auto& f : futures) {
+        f.wait();
+    }
+    for(auto& f : futures) {
+        f.get();
+    }
+}
+
+}}  // namespace evt::chain
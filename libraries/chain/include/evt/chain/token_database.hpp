@@ -24,12 +24,19 @@ class Slice;
 namespace evt { namespace chain {
 
 using read_value_func = std::function<bool(const std::string_view& key, std::string&&)>;
+// fill the next key and value, return false when there's no more values
+using bulk_value_func = std::function<bool(std::string& key, std::string& value)>;
 
 enum class storage_profile {
     disk   = 0,
     memory = 1
 };
 
+enum class compaction_style {
+    universal = 0,
+    level     = 1
+};
+
 enum class token_type {
     asset = 0,
     domain,
@@ -131,6 +138,52 @@ public:
         uint32_t        object_cache_size = 256 * 1024 * 1024; // 256M
         fc::path        db_path           = ::evt::chain::config::default_token_database_dir_name;
         bool            enable_stats      = true;
+
+        compaction_style compaction          = compaction_style::universal;
+        bool             partitioned_index   = false;              // two-level index and partitioned filters, disk profile only
+        uint64_t         memtable_budget     = 512 * 1024 * 1024;  // 512M
+        uint64_t         write_buffer_limit  = 0;                  // limit of memtables in all column families, 0 means no limit
+        uint64_t         rate_limit          = 0;                  // bytes per second for flush and compaction, 0 means no limit
+        bool             use_direct_io       = false;              // disk profile only
+        int              max_background_jobs = 2;
+        bool             address_index       = false;              // secondary index of assets by address
+        uint32_t         max_tracked_changes = 10'000'000;         // tracking of changes stops beyond it, then a full snapshot is required
+    };
+
+    // snapshot of counters in token database, rocksdb ones are zeros when `enable_stats` is off
+    struct metrics {
+        struct histogram {
+            double   p50;
+            double   p95;
+            double   p99;
+            double   max;
+            uint64_t count;
+            uint64_t sum;
+        };
+
+        bool      stats_enabled;
+        uint64_t  block_cache_hit;
+        uint64_t  block_cache_miss;
+        uint64_t  memtable_hit;
+        uint64_t  memtable_miss;
+        uint64_t  keys_read;
+        uint64_t  keys_written;
+        uint64_t  bytes_read;
+        uint64_t  bytes_written;
+        uint64_t  compact_read_bytes;
+        uint64_t  compact_write_bytes;
+        uint64_t  stall_micros;
+        histogram get_micros;
+        histogram write_micros;
+        histogram seek_micros;
+
+        uint64_t estimate_keys;
+        uint64_t memtables_size;
+        uint64_t pending_compaction_bytes;
+
+        size_t savepoints;
+        size_t write_cache_keys;  // keys in write caches of both tokens and assets
+        size_t flushing_keys;     // irreversible keys which are not durable yet
     };
 
     class session {
@@ -200,6 +253,28 @@ public:
     int read_tokens_range(token_type type, const std::optional<name128>& domain, int skip, const read_value_func& func) const;
     int read_assets_range(const symbol_id_type sym_id, int skip, const read_value_func& func) const;
 
+    // read all the assets held by address, ordered by symbol id, requires address index
+    int  read_address_assets(const address& addr, const read_value_func& func) const;
+    bool has_address_index() const;
+
+public:
+    // bulk load values sorted by key, only allowed when there's no savepoints
+    // different prefixes can be ingested from multiple threads at the same time
+    void ingest_tokens(token_type type, const std::optional<name128>& domain, const bulk_value_func& func);
+    void ingest_assets(const symbol_id_type sym_id, const bulk_value_func& func);
+
+public:
+    // track keys changed since latest call, used to build delta snapshots
+    // keys are full keys in database and empty value means the key is removed
+    void reset_changes();
+    bool is_tracking_changes() const;
+    int  read_changed_tokens(const read_value_func& func) const;
+    int  read_changed_assets(const read_value_func& func) const;
+
+    // apply changes read from delta, only allowed when there's no savepoints
+    void apply_changed_tokens(const bulk_value_func& func);
+    void apply_changed_assets(const bulk_value_func& func);
+
 public:
     void add_savepoint(int64_t seq);
     void rollback_to_latest_savepoint();
@@ -216,6 +291,7 @@ public:
 
 public:
     std::string stats() const;
+    metrics     get_metrics() const;
 
 private:
     void flush() const;
@@ -235,4 +311,7 @@ private:
 
 }}  // namespace evt::chain
 
-FC_REFLECT(evt::chain::token_database::config, (profile)(block_cache_size)(object_cache_size)(db_path));
+FC_REFLECT_ENUM(evt::chain::storage_profile, (disk)(memory));
+FC_REFLECT_ENUM(evt::chain::compaction_style, (universal)(level));
+FC_REFLECT(evt::chain::token_database::config, (profile)(block_cache_size)(object_cache_size)(db_path)(enable_stats)
+           (compaction)(partitioned_index)(memtable_budget)(write_buffer_limit)(rate_limit)(use_direct_io)(max_background_jobs)(address_index));
@@ -3,6 +3,7 @@
  *  @copyright defined in evt/LICENSE.txt
 */
 #pragma once
+#include <atomic>
 #include <memory>
 #include <boost/type_index.hpp>
 #include <fc/io/datastream.hpp>
@@ -16,10 +17,30 @@ class token_database_cache {
 public:
     token_database_cache(token_database& db, size_t cache_size)
         : db_(db)
-        , cache_(rocksdb::NewLRUCache(cache_size)) {
+        , cache_(rocksdb::NewLRUCache(cache_size))
+        , hit_(0)
+        , miss_(0) {
         watch_db();
     }
 
+public:
+    struct metrics {
+        uint64_t hit;
+        uint64_t miss;
+        size_t   usage;
+        size_t   capacity;
+    };
+
+    metrics
+    get_metrics() const {
+        return metrics {
+            .hit      = hit_.load(std::memory_order_relaxed),
+            .miss     = miss_.load(std::memory_order_relaxed),
+            .usage    = cache_->GetUsage(),
+            .capacity = cache_->GetCapacity()
+        };
+    }
+
 private:
     template<typename T>
     struct cache_entry {
@@ -63,11 +84,14 @@ public:
         auto k = db_.get_db_key(type, domain, key);
         auto h = cache_->Lookup(k);
         if(h != nullptr) {
+            hit_.fetch_add(1, std::memory_order_relaxed);
+
             auto entry = (cache_entry<T>*)cache_->Value(h);
             EVT_ASSERT2(entry->ti == boost::typeindex::type_id<T>(), token_database_cache_exception,
                 "Types are not matched between cache({}) and query({})", entry->ti.pretty_name(), boost::typeindex::type_id<T>().pretty_name());
             return std::unique_ptr<T, cache_deleter<T>>(&entry->data, cache_deleter<T>(this, h));
         }
+        miss_.fetch_add(1, std::memory_order_relaxed);
 
         auto str = std::string();
         auto r   = db_.read_token(type, domain, key, str, no_throw);
@@ -93,11 +117,14 @@ public:
         auto k = db_.get_db_key(type, domain, key);
         auto h = cache_->Lookup(k);
         if(h != nullptr) {
+            hit_.fetch_add(1, std::memory_order_relaxed);
+
             auto entry = (cache_entry<T>*)cache_->Value(h);
             EVT_ASSERT2(entry->ti == boost::typeindex::type_id<T>(), token_database_cache_exception,
                 "Types are not matched between cache({}) and query({})", entry->ti.pretty_name(), boost::typeindex::type_id<T>().pretty_name());
             return std::unique_ptr<T, cache_deleter<T>>(&entry->data, cache_deleter<T>(this, h));
         }
+        miss_.fetch_add(1, std::memory_order_relaxed);
         return nullptr;
     }
 
@@ -158,6 +185,8 @@ private:
 private:
     token_database&                 db_;
     std::shared_ptr<rocksdb::Cache> cache_;
+    std::atomic<uint64_t>           hit_;
+    std::atomic<uint64_t>           miss_;
 };
 
 template<typename T>
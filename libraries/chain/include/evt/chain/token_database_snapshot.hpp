@@ -5,14 +5,23 @@
 #pragma once
 #include <evt/chain/snapshot.hpp>
 
+namespace boost { namespace asio {
+class thread_pool;
+}}  // namespace boost::asio
+
 namespace evt { namespace chain {
 
 class token_database;
 
 namespace token_database_snapshot {
 
-void add_to_snapshot(snapshot_writer_ptr snapshot, const token_database& db);
-void read_from_snapshot(snapshot_reader_ptr snapshot, token_database& db);
+// sections of tokens and assets are processed on thread pool when provided and supported by snapshot
+void add_to_snapshot(snapshot_writer_ptr snapshot, const token_database& db, boost::asio::thread_pool* thread_pool = nullptr);
+void read_from_snapshot(snapshot_reader_ptr snapshot, token_database& db, boost::asio::thread_pool* thread_pool = nullptr);
+
+// delta only contains the keys changed since latest `reset_changes` of token database
+void add_delta_to_snapshot(snapshot_writer_ptr snapshot, const token_database& db);
+void read_delta_from_snapshot(snapshot_reader_ptr snapshot, token_database& db);
 
 }  // namespace token_database_snapshot
 
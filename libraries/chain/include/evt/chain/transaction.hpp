@@ -68,6 +68,10 @@ struct transaction : public transaction_header {
                                            const chain_id_type&        chain_id,
                                            bool                        allow_duplicate_keys = false) const;
 
+    static public_keys_set recover_signature_keys(const signatures_base_type& signatures,
+                                                  const digest_type&          digest,
+                                                  bool                        allow_duplicate_keys = false);
+
     uint32_t
     total_actions() const {
         return actions.size();
@@ -132,7 +136,11 @@ public:
 
     digest_type packed_digest() const;
 
-    transaction_id_type id() const { return unpacked_trx.id(); }
+    // both are hashed from the packed bytes directly when they're in canonical form
+    const transaction_id_type& id() const { return trx_id; }
+    digest_type                sig_digest(const chain_id_type& chain_id) const;
+    public_keys_set            get_signature_keys(const chain_id_type& chain_id, bool allow_duplicate_keys = false) const;
+
     bytes               get_raw_transaction() const;
 
     time_point_sec            expiration() const { return unpacked_trx.expiration; }
@@ -159,6 +167,10 @@ private:
 private:
     // cache unpacked trx, for thread safety do not modify after construction
     signed_transaction unpacked_trx;
+
+    // set along with `unpacked_trx`
+    transaction_id_type trx_id;
+    bool                canonical_packed = false;  // `packed_trx` is exactly `fc::raw::pack(unpacked_trx)`
 };
 
 using packed_transaction_ptr = std::shared_ptr<packed_transaction>;
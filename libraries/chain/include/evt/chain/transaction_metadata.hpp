@@ -7,6 +7,7 @@
 #include <evt/chain/block.hpp>
 #include <evt/chain/trace.hpp>
 #include <evt/chain/transaction.hpp>
+#include <evt/chain/thread_utils.hpp>
 
 namespace evt { namespace chain {
 
@@ -16,16 +17,18 @@ namespace evt { namespace chain {
  */
 class transaction_metadata : boost::noncopyable {
 public:
-    transaction_id_type                             id;
-    transaction_id_type                             signed_id;
-    packed_transaction_ptr                          packed_trx;
-    optional<pair<chain_id_type, public_keys_set>>  signing_keys;
-    bool                                            accepted = false;
-    bool                                            implicit = false;
+    transaction_id_type                                      id;
+    transaction_id_type                                      signed_id;
+    packed_transaction_ptr                                   packed_trx;
+    optional<pair<chain_id_type, public_keys_set>>           signing_keys;
+    std::shared_future<pair<chain_id_type, public_keys_set>> signing_keys_future;  // keys being recovered in background
+    bool                                                     accepted = false;
+    bool                                                     implicit = false;
 
 public:
     explicit transaction_metadata(const signed_transaction& t, packed_transaction::compression_type c = packed_transaction::none)
-        : id(t.id()), packed_trx(std::make_shared<packed_transaction>(t, c)) {
+        : packed_trx(std::make_shared<packed_transaction>(t, c)) {
+        id        = packed_trx->id();
         signed_id = digest_type::hash(*packed_trx);
     }
 
@@ -37,8 +40,13 @@ public:
 public:
     const public_keys_set&
     recover_keys(const chain_id_type& chain_id) {
+        if(signing_keys_future.valid()) {
+            // rethrows the failure of recovering if any
+            auto future  = std::move(signing_keys_future);
+            signing_keys = future.get();
+        }
         if(!signing_keys.has_value() || signing_keys->first != chain_id) {  // Unlikely for more than one chain_id to be used in one nodeos instance
-            signing_keys = std::make_pair(chain_id, packed_trx->get_signed_transaction().get_signature_keys(chain_id));
+            signing_keys = std::make_pair(chain_id, packed_trx->get_signature_keys(chain_id));
         }
         return signing_keys->second;
     }
@@ -46,4 +54,17 @@ public:
 
 using transaction_metadata_ptr = std::shared_ptr<transaction_metadata>;
 
+// start recovering the signing keys of `mtrx` in `thread_pool`
+// it should be called before `mtrx` is used by the other threads
+inline void
+start_recover_keys(const transaction_metadata_ptr& mtrx, boost::asio::thread_pool& thread_pool, const chain_id_type& chain_id) {
+    if(mtrx->signing_keys.has_value() || mtrx->signing_keys_future.valid()) {
+        return;
+    }
+
+    mtrx->signing_keys_future = async_thread_pool(thread_pool, [ptrx = mtrx->packed_trx, chain_id] {
+        return std::make_pair(chain_id, ptrx->get_signature_keys(chain_id));
+    }).share();
+}
+
 }}  // namespace evt::chain
@@ -45,15 +45,29 @@ merkle(vector<digest_type> ids) {
         return digest_type();
     }
 
+    auto datas  = vector<const char*>();
+    auto lens   = vector<uint32_t>();
+    auto hashes = vector<digest_type>();
+
     while(ids.size() > 1) {
         if(ids.size() % 2)
             ids.push_back(ids.back());
 
-        for(auto i = 0u; i < ids.size() / 2; i++) {
-            ids[i] = digest_type::hash(make_canonical_pair(ids[2 * i], ids[(2 * i) + 1]));
+        // packed canonical pair is the same as the two adjacent digests in place,
+        // so the whole level is hashed in one batch
+        auto pairs = ids.size() / 2;
+        datas.resize(pairs);
+        lens.assign(pairs, sizeof(digest_type) * 2);
+        hashes.resize(pairs);
+
+        for(auto i = 0u; i < pairs; i++) {
+            ids[2 * i]     = make_canonical_left(ids[2 * i]);
+            ids[2 * i + 1] = make_canonical_right(ids[2 * i + 1]);
+            datas[i]       = ids[2 * i].data();
         }
 
-        ids.resize(ids.size() / 2);
+        digest_type::hash_many(datas.data(), lens.data(), pairs, hashes.data());
+        ids.swap(hashes);
     }
 
     return ids.front();
@@ -10,33 +10,85 @@
 
 namespace evt { namespace chain {
 
+namespace __internal {
+
+constexpr auto invalid_name_symbol = 0x20;
+
+struct name_tables {
+    uint8_t symbols[256];  // char to 5-bits symbol, `invalid_name_symbol` if not in charmap
+};
+
+constexpr name_tables
+make_name_tables() {
+    auto t = name_tables {};
+    for(auto c = 0; c < 256; c++) {
+        t.symbols[c] = invalid_name_symbol;
+    }
+    t.symbols[(int)'.'] = 0;
+    for(auto c = 1; c < 256; c++) {
+        auto s = char_to_symbol((char)c);
+        if(s != 0) {
+            t.symbols[c] = (uint8_t)s;
+        }
+    }
+    return t;
+}
+
+constexpr auto name_tbl     = make_name_tables();
+constexpr char name_charmap[] = ".abcdefghijklmnopqrstuvwxyz12345";
+
+// same result as `string_to_name`, returns false if `str` doesn't round-trip:
+// has chars not in charmap, trailing dots or the 13th char doesn't fit into 4 bits
+inline bool
+encode_name(const char* str, size_t len, uint64_t& value) {
+    auto v   = uint64_t(0);
+    auto bad = 0;
+    for(auto i = 0u; i < std::min(len, (size_t)12); i++) {
+        auto s = name_tbl.symbols[(uint8_t)str[i]];
+        bad |= s;
+        v |= (uint64_t)(s & 0x1f) << (64 - 5 * (i + 1));
+    }
+    if(len == 13) {
+        auto s = name_tbl.symbols[(uint8_t)str[12]];
+        bad |= s | (s & 0x10 ? invalid_name_symbol : 0);
+        v |= s & 0x0f;
+    }
+    value = v;
+    return !(bad & invalid_name_symbol) && str[len - 1] != '.';
+}
+
+}  // namespace __internal
+
 void
 name::set(const char* str) {
     const auto len = strnlen(str, 14);
     EVT_ASSERT(len <= 13, name_type_exception, "Name is longer than 13 characters (${name}) ", ("name", string(str)));
     EVT_ASSERT(len > 0, name_type_exception, "Name cannot be empty");
-    value = string_to_name(str);
-    EVT_ASSERT(to_string() == string(str), name_type_exception,
-               "Name not properly normalized (name: ${name}, normalized: ${normalized}) ",
-               ("name", string(str))("normalized", to_string()));
+
+    if(!__internal::encode_name(str, len, value)) {
+        EVT_THROW(name_type_exception, "Name not properly normalized (name: ${name}, normalized: ${normalized}) ",
+                  ("name", string(str))("normalized", to_string()));
+    }
 }
 
 name::operator string() const {
-    static const char* charmap = ".abcdefghijklmnopqrstuvwxyz12345";
+    using namespace __internal;
 
-    string str(13, '.');
+    char buf[13];
 
-    auto tmp = value;
-    str[12] = charmap[tmp & 0x0f];
-    tmp >>= 4;
+    auto tmp  = value;
+    auto last = 0u;  // length without trailing dots
 
-    for(auto i = 1u; i <= 12; ++i, tmp >>= 5) {
-        char c    = charmap[tmp & 0x1f];
-        str[12-i] = c;
+    for(auto i = 0u; i < 12; ++i, tmp <<= 5) {
+        auto s = (int)(tmp >> 59);
+        buf[i] = name_charmap[s];
+        last   = s ? (i + 1) : last;
     }
+    auto s  = (int)(value & 0x0f);
+    buf[12] = name_charmap[s];
+    last    = s ? 13 : last;
 
-    str.erase(str.find_last_not_of('.') + 1);
-    return str;
+    return string(buf, last);
 }
 
 }}  // namespace evt::chain
@@ -9,64 +9,101 @@
 
 namespace evt { namespace chain {
 
+namespace __internal {
+
+constexpr auto invalid_name128_symbol = 0x40;
+
+struct name128_tables {
+    uint8_t symbols[256];  // char to 6-bits symbol, `invalid_name128_symbol` if not in charmap
+    uint8_t tags[22];      // length to size class
+    uint8_t stops[4];      // size class to max length
+};
+
+constexpr name128_tables
+make_name128_tables() {
+    auto t = name128_tables {};
+    for(auto c = 0; c < 256; c++) {
+        t.symbols[c] = invalid_name128_symbol;
+    }
+    t.symbols[(int)'.'] = 0;
+    for(auto c = 1; c < 256; c++) {
+        auto s = char_to_symbol128((char)c);
+        if(s != 0) {
+            t.symbols[c] = (uint8_t)s;
+        }
+    }
+    for(auto len = 0; len < 22; len++) {
+        t.tags[len] = (len <= 5) ? name128::i32 : (len <= 10) ? name128::i64 : (len <= 15) ? name128::i96 : name128::i128;
+    }
+    t.stops[name128::i32]  = 5;
+    t.stops[name128::i64]  = 10;
+    t.stops[name128::i96]  = 15;
+    t.stops[name128::i128] = 21;
+    return t;
+}
+
+constexpr auto name128_tbl = make_name128_tables();
+constexpr char name128_charmap[] = ".-0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+// same result as `string_to_name128`, returns false if `str` doesn't round-trip:
+// has chars not in charmap or trailing dots
+inline bool
+encode_name128(const char* str, size_t len, uint128_t& value) {
+    auto v   = uint128_t(0);
+    auto bad = 0;
+    for(auto i = len; i-- > 0;) {
+        auto s = name128_tbl.symbols[(uint8_t)str[i]];
+        bad |= s;
+        v = (v << 6) | (s & 0x3f);
+    }
+    value = (v << 2) | name128_tbl.tags[len];
+    return !(bad & invalid_name128_symbol) && str[len - 1] != '.';
+}
+
+}  // namespace __internal
+
 void
 name128::set(const char* str) {
-    const auto len = strnlen(str, 22);
-    EVT_ASSERT(len <= 21, name128_type_exception, "Name128 is longer than 21 characters (${name}) ",
-               ("name", std::string(str)));
-    EVT_ASSERT(len > 0, name128_type_exception, "Name128 cannot be empty");
-    value = string_to_name128(str);
-    EVT_ASSERT(to_string() == std::string(str), name128_type_exception,
-               "Name128 not properly normalized (name: ${name}, normalized: ${normalized}) ",
-               ("name", std::string(str))("normalized", to_string()));
+    set(str, strnlen(str, 22));
 }
 
 void
 name128::set(const std::string& str) {
-    const auto len = str.size();
+    if(str.empty()) {
+        value = 0;
+        return;
+    }
+    set(str.data(), str.size());
+}
+
+void
+name128::set(const char* str, size_t len) {
     EVT_ASSERT(len <= 21, name128_type_exception, "Name128 is longer than 21 characters (${name}) ",
-               ("name", str));
-    value = string_to_name128(str.c_str());
-    EVT_ASSERT(to_string() == str, name128_type_exception,
-               "Name128 not properly normalized (name: ${name}, normalized: ${normalized}) ",
-               ("name", str)("normalized", to_string()));
+               ("name", std::string(str, len)));
+    EVT_ASSERT(len > 0, name128_type_exception, "Name128 cannot be empty");
+
+    if(!__internal::encode_name128(str, len, value)) {
+        EVT_THROW(name128_type_exception, "Name128 not properly normalized (name: ${name}, normalized: ${normalized}) ",
+                  ("name", std::string(str, len))("normalized", to_string()));
+    }
 }
 
 name128::operator std::string() const {
-    static const char* charmap = ".-0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    using namespace __internal;
 
-    auto str = std::string(21, '.');
-    
-    auto stop = 0u;
-    auto tmp  = value >> 2;
-    auto tag  = (int)value & 0x03;
+    char buf[21];
 
-    switch(tag) {
-    case i32: {
-        stop = 5;
-        break;
-    }
-    case i64: {
-        stop = 10;
-        break;
-    }
-    case i96: {
-        stop = 15;
-        break;
-    }
-    case i128: {
-        stop = 21;
-        break;
-    }
-    }  // switch
+    auto tmp  = value >> 2;
+    auto stop = name128_tbl.stops[(int)value & 0x03];
+    auto last = 0u;  // length without trailing dots
 
     for(auto i = 0u; i < stop; ++i, tmp >>= 6) {
-        auto c = charmap[tmp & 0x3f];
-        str[i] = c;
+        auto s = (int)tmp & 0x3f;
+        buf[i] = name128_charmap[s];
+        last   = s ? (i + 1) : last;
     }
 
-    str.erase(str.find_last_not_of('.', stop) + 1);
-    return str;
+    return std::string(buf, last);
 }
 
 name128
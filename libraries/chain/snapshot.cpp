@@ -2,7 +2,9 @@
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <fc/scoped_exit.hpp>
+#include <fc/crypto/city.hpp>
 #include <evt/chain/exceptions.hpp>
+#include <evt/chain/merkle.hpp>
 
 namespace evt { namespace chain {
 
@@ -388,6 +390,312 @@ istream_snapshot_reader::build_section_indexes() {
     }
 }
 
+chunked_snapshot_writer::chunked_snapshot_writer(std::ostream& snapshot, size_t max_chunk_size)
+    : snapshot(snapshot)
+    , header_pos(snapshot.tellp())
+    , max_chunk_size(max_chunk_size) {
+    // write magic number
+    auto totem = magic_number;
+    snapshot.write((char*)&totem, sizeof(totem));
+
+    // write version
+    auto version = current_snapshot_version;
+    snapshot.write((char*)&version, sizeof(version));
+}
+
+chunked_snapshot_writer::pending_section&
+chunked_snapshot_writer::current_section() {
+    auto lock = std::lock_guard<std::mutex>(mutex);
+
+    auto it = pendings.find(std::this_thread::get_id());
+    EVT_ASSERT(it != pendings.end(), snapshot_exception, "Attempting to write a row without starting a section");
+    return it->second;
+}
+
+void
+chunked_snapshot_writer::write_start_section(const std::string& section_name) {
+    auto lock = std::lock_guard<std::mutex>(mutex);
+
+    auto r = pendings.emplace(std::piecewise_construct,
+                              std::forward_as_tuple(std::this_thread::get_id()),
+                              std::forward_as_tuple(section_name));
+    EVT_ASSERT(r.second, snapshot_exception, "Attempting to write a new section without closing the previous section");
+}
+
+void
+chunked_snapshot_writer::write_row(const detail::abstract_snapshot_row_writer& row_writer) {
+    auto& section = current_section();
+
+    auto restore = section.buf.tellp();
+    try {
+        row_writer.write(section.wrapper);
+    }
+    catch(...) {
+        section.buf.seekp(restore);
+        throw;
+    }
+    section.row_count++;
+
+    if((size_t)section.buf.tellp() >= max_chunk_size) {
+        flush_chunk(section);
+    }
+}
+
+void
+chunked_snapshot_writer::flush_chunk(pending_section& section) {
+    auto data     = section.buf.str();
+    auto checksum = fc::city_hash64(data.data(), data.size());
+
+    {
+        auto lock = std::lock_guard<std::mutex>(mutex);
+
+        auto pos = snapshot.tellp() - header_pos;
+        snapshot.write(data.data(), data.size());
+
+        chunks.emplace_back(snapshot_chunk {
+            .name      = section.name,
+            .index     = section.chunk_index,
+            .pos       = (uint64_t)pos,
+            .size      = data.size(),
+            .row_count = section.row_count,
+            .checksum  = checksum
+        });
+    }
+
+    section.buf.str(std::string());
+    section.buf.clear();
+    section.chunk_index++;
+    section.row_count = 0;
+}
+
+void
+chunked_snapshot_writer::write_end_section() {
+    auto& section = current_section();
+
+    // always flush the last chunk even it's empty, so that empty section can also be found in the chunk table
+    if(section.row_count > 0 || section.chunk_index == 0) {
+        flush_chunk(section);
+    }
+
+    auto lock = std::lock_guard<std::mutex>(mutex);
+    pendings.erase(std::this_thread::get_id());
+}
+
+void
+chunked_snapshot_writer::finalize() {
+    auto lock = std::lock_guard<std::mutex>(mutex);
+    EVT_ASSERT(pendings.empty(), snapshot_exception, "Attempting to finalize snapshot with unclosed sections");
+
+    uint64_t table_pos = snapshot.tellp() - header_pos;
+    fc::raw::pack(snapshot, chunks);
+
+    // write footer
+    snapshot.write((char*)&table_pos, sizeof(table_pos));
+
+    auto totem = magic_number;
+    snapshot.write((char*)&totem, sizeof(totem));
+}
+
+chunked_snapshot_reader::chunked_snapshot_reader(std::istream& snapshot)
+    : snapshot(snapshot)
+    , header_pos(snapshot.tellg())
+    , version(0)
+    , table_pos(0) {
+    build_section_indexes();
+}
+
+bool
+chunked_snapshot_reader::is_chunked_snapshot(std::istream& snapshot) {
+    auto restore_pos = fc::make_scoped_exit([&snapshot, pos = snapshot.tellg()]() {
+        snapshot.clear();
+        snapshot.seekg(pos);
+    });
+
+    auto totem = uint32_t(0);
+    snapshot.read((char*)&totem, sizeof(totem));
+    return snapshot.gcount() == sizeof(totem) && totem == chunked_snapshot_writer::magic_number;
+}
+
+void
+chunked_snapshot_reader::validate() const {
+    EVT_ASSERT(version == current_snapshot_version, snapshot_validation_exception,
+               "Binary snapshot is an unsuppored version.  Expected : ${expected}, Got: ${actual}",
+               ("expected", current_snapshot_version)("actual", version));
+
+    for(auto& it : section_indexes) {
+        auto& si = it.second;
+        for(auto i = 0u; i < si.chunks.size(); i++) {
+            auto& c = si.chunks[i];
+            EVT_ASSERT(c.index == i, snapshot_validation_exception,
+                       "Chunk ${i} of section ${n} is missing", ("i", i)("n", si.name));
+            EVT_ASSERT(c.pos + c.size <= table_pos, snapshot_validation_exception,
+                       "Chunk ${i} of section ${n} is out of range", ("i", i)("n", si.name));
+        }
+    }
+}
+
+void
+chunked_snapshot_reader::build_section_indexes() {
+    auto restore_pos = fc::make_scoped_exit([this, pos = snapshot.tellg(), ex = snapshot.exceptions()]() {
+        snapshot.seekg(pos);
+        snapshot.exceptions(ex);
+    });
+
+    snapshot.exceptions(std::istream::failbit | std::istream::eofbit);
+
+    try {
+        auto totem = uint32_t(0);
+        snapshot.read((char*)&totem, sizeof(totem));
+        EVT_ASSERT(totem == chunked_snapshot_writer::magic_number, snapshot_validation_exception, "Binary snapshot has unexpected magic number!");
+        snapshot.read((char*)&version, sizeof(version));
+
+        // read footer
+        snapshot.seekg(-std::streamoff(sizeof(table_pos) + sizeof(totem)), std::ios::end);
+        snapshot.read((char*)&table_pos, sizeof(table_pos));
+        snapshot.read((char*)&totem, sizeof(totem));
+        EVT_ASSERT(totem == chunked_snapshot_writer::magic_number, snapshot_validation_exception, "Binary snapshot is not finalized!");
+
+        auto chunks = std::vector<snapshot_chunk>();
+        snapshot.seekg(header_pos + std::streamoff(table_pos));
+        fc::raw::unpack(snapshot, chunks);
+
+        for(auto& c : chunks) {
+            auto& si = section_indexes[c.name];
+            si.name = c.name;
+            si.row_count += c.row_count;
+            si.size += c.size;
+            si.chunks.emplace_back(std::move(c));
+        }
+        for(auto& it : section_indexes) {
+            auto& cs = it.second.chunks;
+            std::sort(cs.begin(), cs.end(), [](auto& a, auto& b) { return a.index < b.index; });
+        }
+    }
+    catch(const std::exception& e) {
+        snapshot_exception fce(FC_LOG_MESSAGE(warn, "Binary snapshot validation threw IO exception (${what})", ("what", e.what())));
+        throw fce;
+    }
+}
+
+const chunked_snapshot_reader::section_index&
+chunked_snapshot_reader::find_section(const string& section_name) const {
+    auto it = section_indexes.find(section_name);
+    if(it == section_indexes.end()) {
+        EVT_THROW(snapshot_exception, "Binary snapshot has no section named ${n}", ("n", section_name));
+    }
+    return it->second;
+}
+
+std::vector<std::string>
+chunked_snapshot_reader::get_section_names(const std::string& prefix) const {
+    auto names = std::vector<std::string>();
+    for(auto it = section_indexes.lower_bound(prefix); it != section_indexes.end(); it++) {
+        if(!boost::starts_with(it->first, prefix)) {
+            break;
+        }
+        names.emplace_back(it->first);
+    }
+    return names;
+}
+
+bool
+chunked_snapshot_reader::has_section(const string& section_name) {
+    return section_indexes.find(section_name) != section_indexes.end();
+}
+
+void
+chunked_snapshot_reader::set_section(const string& section_name) {
+    auto& si = find_section(section_name);
+
+    auto lock = std::lock_guard<std::mutex>(mutex);
+    auto& c   = cursors[std::this_thread::get_id()];
+
+    c.section    = &si;
+    c.next_chunk = 0;
+    c.chunk_rows = 0;
+    c.cur_row    = 0;
+    c.buf.str(std::string());
+    c.buf.clear();
+}
+
+size_t
+chunked_snapshot_reader::get_section_size(const string& section_name) {
+    return find_section(section_name).size;
+}
+
+chunked_snapshot_reader::cursor&
+chunked_snapshot_reader::current_cursor() {
+    auto lock = std::lock_guard<std::mutex>(mutex);
+
+    auto it = cursors.find(std::this_thread::get_id());
+    EVT_ASSERT(it != cursors.end(), snapshot_exception, "Attempting to read a row without setting a section");
+    return it->second;
+}
+
+void
+chunked_snapshot_reader::load_chunk(cursor& c) {
+    auto& chunks = c.section->chunks;
+    EVT_ASSERT(c.next_chunk < chunks.size(), snapshot_exception,
+               "Attempting to read beyond the end of section ${n}", ("n", c.section->name));
+
+    auto& chunk = chunks[c.next_chunk];
+    auto  data  = std::string();
+    data.resize(chunk.size);
+
+    {
+        auto lock = std::lock_guard<std::mutex>(mutex);
+        snapshot.seekg(header_pos + std::streamoff(chunk.pos));
+        snapshot.read(data.data(), data.size());
+        EVT_ASSERT(snapshot.gcount() == std::streamsize(data.size()), snapshot_validation_exception,
+                   "Chunk ${i} of section ${n} is truncated", ("i", chunk.index)("n", chunk.name));
+    }
+
+    EVT_ASSERT(fc::city_hash64(data.data(), data.size()) == chunk.checksum, snapshot_validation_exception,
+               "Checksum of chunk ${i} in section ${n} is mismatch", ("i", chunk.index)("n", chunk.name));
+
+    c.buf.str(data);
+    c.buf.clear();
+    c.chunk_rows = chunk.row_count;
+    c.next_chunk++;
+}
+
+bool
+chunked_snapshot_reader::read_row(detail::abstract_snapshot_row_reader& row_reader) {
+    auto& c = current_cursor();
+    while(c.chunk_rows == 0) {
+        load_chunk(c);
+    }
+
+    row_reader.provide(c.buf);
+    c.chunk_rows--;
+    return ++c.cur_row < c.section->row_count;
+}
+
+bool
+chunked_snapshot_reader::empty() {
+    return current_cursor().section->row_count == 0;
+}
+
+bool
+chunked_snapshot_reader::eof() {
+    auto& c = current_cursor();
+    return c.cur_row >= c.section->row_count;
+}
+
+void
+chunked_snapshot_reader::clear_section() {
+    auto lock = std::lock_guard<std::mutex>(mutex);
+    cursors.erase(std::this_thread::get_id());
+}
+
+snapshot_reader_ptr
+make_snapshot_reader(std::istream& snapshot) {
+    if(chunked_snapshot_reader::is_chunked_snapshot(snapshot)) {
+        return std::make_shared<chunked_snapshot_reader>(snapshot);
+    }
+    return std::make_shared<istream_snapshot_reader>(snapshot);
+}
+
 integrity_hash_snapshot_writer::integrity_hash_snapshot_writer(fc::sha256::encoder& enc)
     : enc(enc) {
 }
@@ -412,4 +720,58 @@ integrity_hash_snapshot_writer::finalize() {
     // no-op for structural details
 }
 
+merkle_hash_snapshot_writer::pending_section&
+merkle_hash_snapshot_writer::current_section() {
+    auto lock = std::lock_guard<std::mutex>(mutex);
+
+    auto it = pendings.find(std::this_thread::get_id());
+    EVT_ASSERT(it != pendings.end(), snapshot_exception, "Attempting to write a row without starting a section");
+    return it->second;
+}
+
+void
+merkle_hash_snapshot_writer::write_start_section(const std::string& section_name) {
+    auto lock = std::lock_guard<std::mutex>(mutex);
+
+    auto r = pendings.emplace(std::piecewise_construct,
+                              std::forward_as_tuple(std::this_thread::get_id()),
+                              std::forward_as_tuple(section_name));
+    EVT_ASSERT(r.second, snapshot_exception, "Attempting to write a new section without closing the previous section");
+}
+
+void
+merkle_hash_snapshot_writer::write_row(const detail::abstract_snapshot_row_writer& row_writer) {
+    row_writer.write(current_section().enc);
+}
+
+void
+merkle_hash_snapshot_writer::write_end_section() {
+    auto& section = current_section();
+    auto  digest  = section.enc.result();
+
+    auto lock = std::lock_guard<std::mutex>(mutex);
+    auto r    = digests.emplace(section.name, digest);
+    EVT_ASSERT(r.second, snapshot_exception, "Duplicate section: ${name}", ("name", section.name));
+
+    pendings.erase(std::this_thread::get_id());
+}
+
+fc::sha256
+merkle_hash_snapshot_writer::finalize() {
+    auto lock = std::lock_guard<std::mutex>(mutex);
+    EVT_ASSERT(pendings.empty(), snapshot_exception, "Attempting to finalize hash with unclosed sections");
+
+    // leaf binds the name of section with its digest
+    auto leaves = std::vector<digest_type>();
+    leaves.reserve(digests.size());
+    for(auto& it : digests) {
+        auto enc = fc::sha256::encoder();
+        fc::raw::pack(enc, it.first);
+        fc::raw::pack(enc, it.second);
+        leaves.emplace_back(enc.result());
+    }
+
+    return merkle(std::move(leaves));
+}
+
 }}  // namespace evt::chain
\ No newline at end of file
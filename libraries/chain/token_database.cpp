@@ -8,25 +8,38 @@
 #define __cpp_lib_string_view
 #endif
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <deque>
 #include <fstream>
+#include <mutex>
 #include <string_view>
+#include <thread>
 #include <unordered_set>
 
 #include <rocksdb/db.h>
 #include <rocksdb/cache.h>
 #include <rocksdb/options.h>
 #include <rocksdb/filter_policy.h>
+#include <rocksdb/rate_limiter.h>
 #include <rocksdb/slice_transform.h>
+#include <rocksdb/sst_file_writer.h>
 #include <rocksdb/statistics.h>
 #include <rocksdb/table.h>
+#include <rocksdb/write_buffer_manager.h>
 
 #include <llvm/ADT/StringSet.h>
 #include <llvm/ADT/StringMap.h>
 
+#include <fmt/format.h>
+
 #include <fc/filesystem.hpp>
+#include <fc/crypto/city.hpp>
 #include <fc/io/datastream.hpp>
 #include <fc/io/raw.hpp>
+#include <fc/scoped_exit.hpp>
 #include <fc/container/ring_vector.hpp>
 
 #include <evt/chain/config.hpp>
@@ -48,10 +61,11 @@ namespace __internal {
 #error EVT can only be compiled in X86-64 architecture
 #endif
 
-const char*  kAssetsColumnFamilyName = "Assets";
-const size_t kSymbolIdSize           = sizeof(symbol_id_type);
-const size_t kPublicKeySize          = sizeof(fc::ecc::public_key_shim);
-const size_t kDefaultSavePointsSize  = (4 / 3 * 24 + 1) * 12;
+const char*  kAssetsColumnFamilyName       = "Assets";
+const char*  kAddressIndexColumnFamilyName = "AddressIndex";
+const size_t kSymbolIdSize                 = sizeof(symbol_id_type);
+const size_t kPublicKeySize                = sizeof(fc::ecc::public_key_shim);
+const size_t kDefaultSavePointsSize        = (4 / 3 * 24 + 1) * 12;
 
 struct db_token_key : boost::noncopyable {
 public:
@@ -111,6 +125,19 @@ private:
     rocksdb::Slice slice;
 };
 
+// key in address index of assets, address is moved to the front of asset key
+// value is empty, the asset is read by the asset key
+std::string
+get_address_index_key(const std::string_view& asset_key) {
+    assert(asset_key.size() == kSymbolIdSize + kPublicKeySize);
+
+    auto key = std::string();
+    key.reserve(asset_key.size());
+    key.append(asset_key.substr(kSymbolIdSize));
+    key.append(asset_key.substr(0, kSymbolIdSize));
+    return key;
+}
+
 name128 action_key_prefixes[] = {
     N128(.asset),
     N128(.domain),
@@ -176,7 +203,6 @@ public:
 };
 
 struct rt_group {
-    const void*                rb_snapshot;
     small_vector<rt_action, 4> actions;
 };
 
@@ -192,6 +218,7 @@ struct pd_action {
 struct pd_group {
     int64_t                seq; // used for persistent
     std::vector<pd_action> actions;
+    bool                   legacy = false;  // values are written into db directly by version 0, not persisted in group
 };
 
 struct sp_node {
@@ -235,56 +262,108 @@ struct rt_asset_key {
     char key[kSymbolIdSize + kPublicKeySize];
 };
 
+// takes the same 4 bytes as `int dirty_flag` in version 0 (x86-64 is little-endian)
 struct pd_header {
-    int dirty_flag;
+    uint16_t dirty_flag;
+    uint16_t version;
+};
+
+// version 0: savepoints with the values before them, their writes are in db already
+// version 1: savepoints with keys only, seqs of legacy ones from version 0, and then write caches
+const uint16_t kSavepointsLogVersion = 1;
+
+enum journal_type {
+    kJournalAddSavepoint = 0,
+    kJournalPut,
+    kJournalRollback,
+    kJournalSquash,
+    kJournalPopSavepoints,
+    kJournalPopBack,
+    kJournalLegacySavepoint  // legacy savepoint from version 0 of savepoints log, `value` is its packed actions
+};
+
+// entry of savepoints journal
+// `seq` is the seq of new savepoint for adding and the `until` seq for popping
+struct journal_entry {
+    uint8_t     type;
+    uint8_t     token_type;
+    uint8_t     op;
+    int64_t     seq;
+    std::string key;
+    std::string value;
+};
+
+struct journal_header {
+    uint32_t size;
+    uint32_t checksum;
 };
 
+const size_t kMaxJournalEntrySize   = 64 * 1024 * 1024;
+const size_t kJournalCheckpointSize = 256 * 1024 * 1024;
+
+journal_entry
+make_journal_entry(journal_type type, int64_t seq = 0) {
+    auto entry = journal_entry();
+    entry.type = type;
+    entry.seq  = seq;
+    return entry;
+}
+
+journal_entry
+make_journal_put_entry(token_type type, action_op op, const std::string_view& key, const std::string_view& value) {
+    auto entry = journal_entry();
+    entry.type       = kJournalPut;
+    entry.token_type = (uint8_t)type;
+    entry.op         = (uint8_t)op;
+    entry.seq        = 0;
+    entry.key        = key;
+    entry.value      = value;
+    return entry;
+}
+
 }  // namespace __internal
 
+// multi-version overlay for the values written in savepoints
+// every key keeps one version for each savepoint it's written in, the latest version is visible.
+// rollback drops the latest versions and only the versions of irreversible savepoints are written into db
 class write_cache_layer : boost::noncopyable {
 private:
-    struct cache_entry {
-    public:
-        cache_entry(int32_t used_count, std::string&& value)
-            : used_count(used_count)
-            , value(std::move(value)) {}
-
-    public:
-        int32_t     used_count;
+    struct cache_version {
+        int64_t     seq;
         std::string value;
     };
 
-    using data_map_t = llvm::StringMap<cache_entry>;
-
-    struct data_op {
-    public:
-        data_op(data_map_t::iterator& it, std::string&& pv)
-            : it(&(*it)), pv(std::move(pv)) {}
-
-    public:
-        data_map_t::value_type* it;
-        std::string             pv;
-    };
+    // ordered by seq
+    using versions_t = small_vector<cache_version, 2>;
+    using data_map_t = llvm::StringMap<versions_t>;
 
     struct data_ops {
-        int64_t              seq;
-        std::vector<data_op> vec;
+        int64_t                              seq;
+        std::vector<data_map_t::value_type*> keys;  // keys written in this savepoint
     };
 
+public:
+    using persist_func = std::function<void(const llvm::StringRef&, std::string&&)>;
+    using range_t      = std::vector<std::pair<std::string_view, const std::string*>>;
+
 public:
     write_cache_layer() : ops_(__internal::kDefaultSavePointsSize) {}
 
 public:
     void put(const std::string_view& key, const std::string_view& value);
     int read(const std::string_view& key, std::string& value) const;
+    int read_before(const std::string_view& key, int64_t seq, std::string& value) const;
+    int read_at(const std::string_view& key, int64_t seq, std::string& value) const;
     int exists(const std::string_view& key) const;
+    range_t read_prefix(const std::string_view& prefix) const;
+    size_t size() const { return data_.size(); }
 
 public:
     void add_savepoint(int64_t seq);
     void rollback_to_latest_savepoint();
     void squash();
-    void pop_front(std::function<void(const llvm::StringRef&, std::string&&)> persist_func);
-    void pop_back();
+    void pop_front(const persist_func& func);
+    void pop_back(const persist_func& func);
 
     void clear();
     void persist_savepoints(std::ostream& os) const;
@@ -302,15 +381,16 @@ void
 write_cache_layer::put(const std::string_view& key, const std::string_view& value) {
     assert(!ops_.empty());
 
-    auto pair = data_.try_emplace(llvm::StringRef(key.data(), key.size()), 1, std::string(value.data(), value.size()));
-    if(!pair.second) {
-        auto pv = std::move(pair.first->second.value);
-        pair.first->second.used_count += 1;
-        pair.first->second.value       = std::string(value.data(), value.size());
-        ops_.back().vec.emplace_back(data_op(pair.first, std::move(pv)));
+    auto& ops  = ops_.back();
+    auto  pair = data_.try_emplace(llvm::StringRef(key.data(), key.size()));
+    auto& vers = pair.first->second;
+    if(!vers.empty() && vers.back().seq == ops.seq) {
+        // already written in this savepoint
+        vers.back().value.assign(value.data(), value.size());
         return;
     }
-    ops_.back().vec.emplace_back(data_op(pair.first, std::string()));
+    vers.emplace_back(cache_version { .seq = ops.seq, .value = std::string(value.data(), value.size()) });
+    ops.keys.emplace_back(&(*pair.first));
 }
 
 int
@@ -319,7 +399,38 @@ write_cache_layer::read(const std::string_view& key, std::string& value) const {
     if(it == data_.end()) {
         return 0;
     }
-    value = it->second.value;
+    value = it->second.back().value;
+    return 1;
+}
+
+int
+write_cache_layer::read_before(const std::string_view& key, int64_t seq, std::string& value) const {
+    auto it = data_.find(llvm::StringRef(key.data(), key.size()));
+    if(it == data_.end()) {
+        return 0;
+    }
+    auto& vers = it->second;
+    for(auto v = vers.rbegin(); v != vers.rend(); v++) {
+        if(v->seq < seq) {
+            value = v->value;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int
+write_cache_layer::read_at(const std::string_view& key, int64_t seq, std::string& value) const {
+    auto it = data_.find(llvm::StringRef(key.data(), key.size()));
+    if(it == data_.end()) {
+        return 0;
+    }
+    auto& vers = it->second;
+    auto  v    = std::find_if(vers.begin(), vers.end(), [&](auto& v) { return v.seq == seq; });
+    if(v == vers.end()) {
+        return 0;
+    }
+    value = v->value;
     return 1;
 }
 
@@ -328,22 +439,34 @@ write_cache_layer::exists(const std::string_view& key) const {
     return data_.find(llvm::StringRef(key.data(), key.size())) != data_.end();
 }
 
+write_cache_layer::range_t
+write_cache_layer::read_prefix(const std::string_view& prefix) const {
+    auto range = range_t();
+    auto p     = llvm::StringRef(prefix.data(), prefix.size());
+    for(auto& it : data_) {
+        if(it.first().startswith(p)) {
+            range.emplace_back(std::string_view(it.first().data(), it.first().size()), &it.second.back().value);
+        }
+    }
+    std::sort(range.begin(), range.end(), [](auto& a, auto& b) { return a.first < b.first; });
+    return range;
+}
+
 void
 write_cache_layer::add_savepoint(int64_t seq) {
-    ops_.push_back(data_ops{ .seq = seq, .vec = {} });
+    ops_.push_back(data_ops{ .seq = seq, .keys = {} });
 }
 
 void
 write_cache_layer::rollback_to_latest_savepoint() {
     auto& ops = ops_.back();
-    for(auto it = ops.vec.rbegin(); it != ops.vec.rend(); it++) {
-        auto& op = *it;
-        if(--op.it->second.used_count == 0) {
-            data_.erase(op.it->first());
-        }
-        else {
-            assert(!op.it->second.value.empty());
-            op.it->second.value = std::move(op.pv);
+    for(auto it : ops.keys) {
+        auto& vers = it->second;
+        assert(!vers.empty() && vers.back().seq == ops.seq);
+
+        vers.pop_back();
+        if(vers.empty()) {
+            data_.erase(it->first());
         }
     }
     ops_.pop_back();
@@ -355,24 +478,58 @@ write_cache_layer::squash() {
     auto& b1 = ops_[ops_.size() - 1];
     auto& b2 = ops_[ops_.size() - 2];
 
-    b2.vec.insert(b2.vec.end(), b1.vec.begin(), b1.vec.end());
+    for(auto it : b1.keys) {
+        auto& vers = it->second;
+        auto  n    = vers.size();
+        if(n >= 2 && vers[n - 2].seq == b2.seq) {
+            vers[n - 2].value = std::move(vers[n - 1].value);
+            vers.pop_back();
+        }
+        else {
+            vers.back().seq = b2.seq;
+            b2.keys.emplace_back(it);
+        }
+    }
     ops_.pop_back();
 }
 
 void
-write_cache_layer::pop_front(std::function<void(const llvm::StringRef&, std::string&&)> persist_func) {
-    for(auto& op : ops_.front().vec) {
-        if(--op.it->second.used_count == 0) {
-            persist_func(op.it->first(), std::move(op.it->second.value));
-            data_.erase(op.it->first());
+write_cache_layer::pop_front(const persist_func& func) {
+    auto& ops = ops_.front();
+    for(auto it : ops.keys) {
+        auto& vers = it->second;
+        assert(vers.front().seq == ops.seq);
+
+        if(vers.size() == 1) {
+            func(it->first(), std::move(vers.front().value));
+            data_.erase(it->first());
+        }
+        else {
+            // later savepoints still hold newer versions
+            func(it->first(), std::string(vers.front().value));
+            vers.erase(vers.begin());
         }
     }
-
     ops_.pop_front();
 }
 
 void
-write_cache_layer::pop_back() {
+write_cache_layer::pop_back(const persist_func& func) {
+    // values of latest savepoint are kept: merged into the previous version of the same key,
+    // or written into db if there is none
+    auto& ops = ops_.back();
+    for(auto it : ops.keys) {
+        auto& vers = it->second;
+        auto  n    = vers.size();
+        if(n == 1) {
+            func(it->first(), std::move(vers.back().value));
+            data_.erase(it->first());
+        }
+        else {
+            vers[n - 2].value = std::move(vers[n - 1].value);
+            vers.pop_back();
+        }
+    }
     ops_.pop_back();
 }
 
@@ -407,10 +564,14 @@ write_cache_layer::persist_savepoints(std::ostream& os) const {
         
         auto& epack = pack[i];
         epack.seq   = ops.seq;
-        for(auto& op : ops.vec) {
+        for(auto it : ops.keys) {
+            auto& vers = it->second;
+            auto  v    = std::find_if(vers.begin(), vers.end(), [&](auto& v) { return v.seq == ops.seq; });
+            assert(v != vers.end());
+
             epack.vec.emplace_back(wc_entry {
-                .k  = op.it->first().str(),
-                .v  = op.it->second.value
+                .k  = it->first().str(),
+                .v  = v->value
             });
         }
     }
@@ -432,6 +593,272 @@ write_cache_layer::load_savepoints(std::istream& is) {
     }
 }
 
+// irreversible values popped from write caches which are being written into db by background flusher
+// they're removed once their batch is durable
+class flush_layer : boost::noncopyable {
+private:
+    struct flush_entry {
+        uint64_t    batch;
+        std::string value;
+    };
+
+    using data_map_t = llvm::StringMap<flush_entry>;
+
+public:
+    void
+    put(const llvm::StringRef& key, std::string&& value, uint64_t batch) {
+        auto& e = data_[key];
+        e.batch = batch;
+        e.value = std::move(value);
+    }
+
+    int
+    read(const std::string_view& key, std::string& value) const {
+        auto it = data_.find(llvm::StringRef(key.data(), key.size()));
+        if(it == data_.end()) {
+            return 0;
+        }
+        value = it->second.value;
+        return 1;
+    }
+
+    int
+    exists(const std::string_view& key) const {
+        return data_.find(llvm::StringRef(key.data(), key.size())) != data_.end();
+    }
+
+    write_cache_layer::range_t
+    read_prefix(const std::string_view& prefix) const {
+        auto range = write_cache_layer::range_t();
+        auto p     = llvm::StringRef(prefix.data(), prefix.size());
+        for(auto& it : data_) {
+            if(it.first().startswith(p)) {
+                range.emplace_back(std::string_view(it.first().data(), it.first().size()), &it.second.value);
+            }
+        }
+        std::sort(range.begin(), range.end(), [](auto& a, auto& b) { return a.first < b.first; });
+        return range;
+    }
+
+    void
+    remove_durable(uint64_t durable) {
+        for(auto it = data_.begin(); it != data_.end();) {
+            auto cur = it++;
+            if(cur->second.batch <= durable) {
+                data_.erase(cur);
+            }
+        }
+    }
+
+    template<typename F>
+    void
+    for_each_key(F&& f) const {
+        for(auto& it : data_) {
+            f(std::string_view(it.first().data(), it.first().size()));
+        }
+    }
+
+    bool   empty() const { return data_.empty(); }
+    size_t size() const { return data_.size(); }
+    void   clear() { data_.clear(); }
+
+private:
+    data_map_t data_;
+};
+
+// writes batches of irreversible values into db in a background thread
+// batches queued while previous writes are in progress are committed together with only one sync
+class background_flusher : boost::noncopyable {
+public:
+    void start(rocksdb::DB* db, const rocksdb::WriteOptions& write_opts);
+    void stop();
+
+    void submit(uint64_t seq, std::unique_ptr<rocksdb::WriteBatch>&& batch);
+    void wait(uint64_t seq);
+    void check_error();
+
+    uint64_t durable_seq() const { return durable_; }
+
+private:
+    void run();
+
+private:
+    rocksdb::DB*          db_ = nullptr;
+    rocksdb::WriteOptions write_opts_;
+
+    std::thread             thread_;
+    std::mutex              mutex_;
+    std::condition_variable queue_cv_;
+    std::condition_variable durable_cv_;
+
+    std::deque<std::pair<uint64_t, std::unique_ptr<rocksdb::WriteBatch>>> queue_;
+    std::atomic<uint64_t>                                                 durable_ = 0;
+    bool                                                                  stop_    = false;
+    std::string                                                           error_;
+};
+
+void
+background_flusher::start(rocksdb::DB* db, const rocksdb::WriteOptions& write_opts) {
+    db_         = db;
+    write_opts_ = write_opts;
+    stop_       = false;
+    thread_     = std::thread([this] { run(); });
+}
+
+void
+background_flusher::stop() {
+    {
+        auto lock = std::unique_lock<std::mutex>(mutex_);
+        stop_ = true;
+    }
+    queue_cv_.notify_all();
+    if(thread_.joinable()) {
+        thread_.join();
+    }
+    check_error();
+}
+
+void
+background_flusher::submit(uint64_t seq, std::unique_ptr<rocksdb::WriteBatch>&& batch) {
+    check_error();
+    {
+        auto lock = std::unique_lock<std::mutex>(mutex_);
+        queue_.emplace_back(seq, std::move(batch));
+    }
+    queue_cv_.notify_one();
+}
+
+void
+background_flusher::wait(uint64_t seq) {
+    {
+        auto lock = std::unique_lock<std::mutex>(mutex_);
+        durable_cv_.wait(lock, [&] { return durable_ >= seq; });
+    }
+    check_error();
+}
+
+void
+background_flusher::check_error() {
+    auto lock = std::unique_lock<std::mutex>(mutex_);
+    if(!error_.empty()) {
+        FC_THROW_EXCEPTION(fc::unrecoverable_exception, "Rocksdb internal error: ${err}", ("err", error_));
+    }
+}
+
+void
+background_flusher::run() {
+    auto lock = std::unique_lock<std::mutex>(mutex_);
+    while(true) {
+        queue_cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+        if(queue_.empty()) {
+            // stopped and all batches are written
+            break;
+        }
+
+        auto batches = std::move(queue_);
+        queue_.clear();
+        lock.unlock();
+
+        // batches are written in order and only the last one syncs the wal,
+        // which makes all the previous ones durable as well
+        auto status = rocksdb::Status::OK();
+        for(auto i = 0u; i < batches.size() && status.ok(); i++) {
+            auto opts = write_opts_;
+            opts.sync = (i == batches.size() - 1);
+            status    = db_->Write(opts, batches[i].second.get());
+        }
+
+        lock.lock();
+        if(!status.ok() && error_.empty()) {
+            error_ = status.ToString();
+        }
+        durable_ = batches.back().first;
+        durable_cv_.notify_all();
+    }
+}
+
+// append-only log of the operations on savepoints, replayed to restore savepoints after unclean shutdown
+// every entry is prefixed with its size and checksum, so the torn entry at the tail can be detected and dropped
+class savepoint_journal : boost::noncopyable {
+public:
+    using replay_func = std::function<void(__internal::journal_entry&&)>;
+
+public:
+    void open(const fc::path& path);
+    void close();
+    bool is_open() const { return fs_.is_open(); }
+    size_t size() const { return size_; }
+
+    void append(const __internal::journal_entry& entry);
+    void flush();
+    static void replay(const fc::path& path, const replay_func& func);
+
+private:
+    std::ofstream fs_;
+    size_t        size_ = 0;
+};
+
+void
+savepoint_journal::open(const fc::path& path) {
+    fs_.exceptions(std::fstream::failbit | std::fstream::badbit);
+    fs_.open(path.to_native_ansi_path(), (std::ios::out | std::ios::binary | std::ios::app));
+    size_ = fc::file_size(path);
+}
+
+void
+savepoint_journal::close() {
+    if(fs_.is_open()) {
+        fs_.close();
+    }
+    size_ = 0;
+}
+
+void
+savepoint_journal::append(const __internal::journal_entry& entry) {
+    using namespace __internal;
+
+    auto data = fc::raw::pack(entry);
+    auto h    = journal_header {
+        .size     = (uint32_t)data.size(),
+        .checksum = fc::city_hash32(data.data(), data.size())
+    };
+    fc::raw::pack(fs_, h);
+    fs_.write(data.data(), data.size());
+    size_ += sizeof(h) + data.size();
+}
+
+void
+savepoint_journal::flush() {
+    fs_.flush();
+}
+
+void
+savepoint_journal::replay(const fc::path& path, const replay_func& func) {
+    using namespace __internal;
+
+    auto fs = std::ifstream(path.to_native_ansi_path(), (std::ios::in | std::ios::binary));
+    EVT_ASSERT(fs.is_open(), token_database_persist_exception, "Cannot open savepoints journal: ${f}", ("f", path));
+
+    auto buf  = std::array<char, sizeof(journal_header)>();
+    auto data = std::vector<char>();
+    while(fs.read(buf.data(), buf.size())) {
+        auto h  = journal_header();
+        auto ds = fc::datastream<const char*>(buf.data(), buf.size());
+        fc::raw::unpack(ds, h);
+
+        if(h.size > kMaxJournalEntrySize) {
+            wlog("Invalid entry found in savepoints journal, drop the rest of it");
+            break;
+        }
+        data.resize(h.size);
+        if(!fs.read(data.data(), data.size()) || fc::city_hash32(data.data(), data.size()) != h.checksum) {
+            wlog("Torn entry found in savepoints journal, drop the rest of it");
+            break;
+        }
+        func(fc::raw::unpack<journal_entry>(data));
+    }
+}
+
 class token_database_impl : boost::noncopyable {
 public:
     token_database_impl(token_database& self, const token_database::config& config);
@@ -457,6 +884,19 @@ public:
 
     int read_tokens_range(const name128& prefix, int skip, const read_value_func& func) const;
     int read_assets_range(const symbol_id_type sym_id, int skip, const read_value_func& func) const;
+    int read_range(rocksdb::ColumnFamilyHandle* handle, const std::string_view& prefix, int skip, const read_value_func& func) const;
+    int read_address_assets(const address& addr, const read_value_func& func) const;
+
+    void create_address_index(const rocksdb::ColumnFamilyOptions& options);
+    void index_asset(rocksdb::WriteBatch& batch, const std::string_view& key);
+
+    void ingest(rocksdb::ColumnFamilyHandle* handle, const std::string_view& prefix, const bulk_value_func& func);
+
+public:
+    void reset_changes();
+    void log_change(token_type type, const std::string_view& key);
+    int  read_changes(rocksdb::ColumnFamilyHandle* handle, const __internal::keys_hash_set& keys, const read_value_func& func) const;
+    void apply_changes(rocksdb::ColumnFamilyHandle* handle, const bulk_value_func& func);
 
 public:
     void add_savepoint(int64_t seq);
@@ -472,6 +912,16 @@ public:
     void rollback_rt_group(__internal::rt_group*);
     void rollback_pd_group(__internal::pd_group*);
 
+    write_cache_layer::persist_func make_flush_func(rocksdb::WriteBatch& batch, rocksdb::ColumnFamilyHandle* handle, flush_layer& layer, uint64_t seq);
+    void submit_flush(std::unique_ptr<rocksdb::WriteBatch>&& batch, uint64_t seq);
+    void collect_flushes();
+    void drain_flushes();
+
+    void journal(__internal::journal_type type, int64_t seq = 0);
+    void journal_put(token_type type, action_op op, const std::string_view& key, const std::string_view& value);
+    void replay_journal(const fc::path& path);
+    void checkpoint_journal();
+
     int should_record() { return !savepoints_.empty(); }
 
     void record(uint8_t action_type, uint8_t op, uint8_t data_type, void* data);
@@ -482,7 +932,7 @@ public:
     void load_savepoints();
     void persist_savepoints(std::ostream&) const;
     void load_savepoints(std::istream&);
-    void flush() const;
+    void flush();
 
     std::string get_db_path() const { return config_.db_path.to_native_ansi_path(); }
 
@@ -496,10 +946,34 @@ public:
 
     rocksdb::ColumnFamilyHandle* tokens_handle_;
     rocksdb::ColumnFamilyHandle* assets_handle_;
+    rocksdb::ColumnFamilyHandle* address_index_handle_;  // null when address index is disabled
+
+    // options are kept for building external sst files
+    rocksdb::Options tokens_options_;
+    rocksdb::Options assets_options_;
+    std::atomic<int> ingest_seq_;
 
+    write_cache_layer tokens_write_cache_;
     write_cache_layer assets_write_cache_;
 
+    // irreversible values are flushed in background
+    background_flusher flusher_;
+    flush_layer        tokens_flushing_;
+    flush_layer        assets_flushing_;
+    uint64_t           flush_seq_;
+
+    // operations on savepoints are journaled for restoring after unclean shutdown
+    savepoint_journal journal_;
+
     fc::ring_vector<__internal::savepoint> savepoints_;
+
+    // keys changed since latest `reset_changes`
+    struct change_log {
+        bool                      enabled    = false;
+        bool                      overflowed = false;  // too many changes were made and tracking is stopped
+        __internal::keys_hash_set tokens;
+        __internal::keys_hash_set assets;
+    } changes_;
 };
 
 token_database_impl::token_database_impl(token_database& self, const token_database::config& config)
@@ -510,6 +984,9 @@ token_database_impl::token_database_impl(token_database& self, const token_datab
     , write_opts_()
     , tokens_handle_(nullptr)
     , assets_handle_(nullptr)
+    , address_index_handle_(nullptr)
+    , ingest_seq_(0)
+    , flush_seq_(0)
     , savepoints_(__internal::kDefaultSavePointsSize) {}
 
 void
@@ -520,9 +997,15 @@ token_database_impl::open(int load_persistence) {
     EVT_ASSERT(db_ == nullptr, token_database_exception, "Token database is already opened");
 
     auto options = Options();
-    options.OptimizeUniversalStyleCompaction();
+    if(config_.compaction == compaction_style::universal) {
+        options.OptimizeUniversalStyleCompaction(config_.memtable_budget);
+    }
+    else {
+        options.OptimizeLevelStyleCompaction(config_.memtable_budget);
+    }
 
     options.create_if_missing               = true;
+    options.max_background_jobs             = config_.max_background_jobs;
     options.compression                     = CompressionType::kLZ4Compression;
     options.bottommost_compression          = CompressionType::kZSTD;
     options.allow_concurrent_memtable_write = false;
@@ -536,8 +1019,17 @@ token_database_impl::open(int load_persistence) {
         options.statistics->stats_level_ = StatsLevel::kExceptTimeForMutex;
 #endif
     }
+    if(config_.write_buffer_limit > 0) {
+        // memtables of both column families are limited together
+        options.write_buffer_manager = std::make_shared<WriteBufferManager>(config_.write_buffer_limit);
+    }
+    if(config_.rate_limit > 0) {
+        options.rate_limiter.reset(NewGenericRateLimiter(config_.rate_limit));
+    }
 
     auto assets_options = ColumnFamilyOptions(options);
+    auto index_options  = ColumnFamilyOptions(options);
+    index_options.prefix_extractor.reset(NewFixedPrefixTransform(kPublicKeySize));
 
     if(config_.profile == storage_profile::disk) {
         auto table_opts = BlockBasedTableOptions();
@@ -548,8 +1040,25 @@ token_database_impl::open(int load_persistence) {
         table_opts.block_cache    = NewLRUCache(config_.block_cache_size);
         table_opts.filter_policy.reset(NewBloomFilterPolicy(10, false));
 
+        if(config_.partitioned_index) {
+            // index and filters are partitioned and stored in block cache,
+            // only the top level ones are pinned, which bounds the memory for large database
+            table_opts.index_type                              = BlockBasedTableOptions::kTwoLevelIndexSearch;
+            table_opts.partition_filters                       = true;
+            table_opts.cache_index_and_filter_blocks           = true;
+            table_opts.pin_top_level_index_and_filter          = true;
+            table_opts.pin_l0_filter_and_index_blocks_in_cache = true;
+        }
+        if(config_.use_direct_io) {
+            options.use_direct_reads                       = true;
+            options.use_direct_io_for_flush_and_compaction = true;
+        }
+
+        // all the column families share the same table options and block cache, each keeps its own prefix extractor
         options.table_factory.reset(NewBlockBasedTableFactory(table_opts));
+        assets_options.table_factory = options.table_factory;
         assets_options.prefix_extractor.reset(NewFixedPrefixTransform(kSymbolIdSize));
+        index_options.table_factory = options.table_factory;
     }
     else if(config_.profile == storage_profile::memory) {
         auto tokens_table_options = PlainTableOptions();
@@ -559,6 +1068,7 @@ token_database_impl::open(int load_persistence) {
 
         options.table_factory.reset(NewPlainTableFactory(tokens_table_options));
         assets_options.table_factory.reset(NewPlainTableFactory(assets_table_options));
+        index_options.table_factory.reset(NewPlainTableFactory(assets_table_options));
         assets_options.prefix_extractor.reset(NewFixedPrefixTransform(kSymbolIdSize));
     }
     else {
@@ -569,6 +1079,9 @@ token_database_impl::open(int load_persistence) {
     read_opts_.prefix_same_as_start = true;
     read_opts_.tailing              = true;
 
+    tokens_options_ = options;
+    assets_options_ = Options(DBOptions(options), assets_options);
+
     if(!fc::exists(config_.db_path)) {
         auto t = config_.db_path.to_native_ansi_path();
         // create new database and open
@@ -583,47 +1096,101 @@ token_database_impl::open(int load_persistence) {
         if(!status.ok()) {
             EVT_THROW(token_database_rocksdb_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
         }
+        if(config_.address_index) {
+            create_address_index(index_options);
+        }
 
+        flusher_.start(db_, write_opts_);
         if(load_persistence) {
             load_savepoints();
         }
+        checkpoint_journal();
         return;
     }
 
+    // address index is optional, all the existing column families are required to be opened
+    auto families = std::vector<std::string>();
+    auto status   = DB::ListColumnFamilies(options, config_.db_path.to_native_ansi_path(), &families);
+    if(!status.ok()) {
+        EVT_THROW(token_database_rocksdb_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
+    }
+    auto has_index = std::find(families.cbegin(), families.cend(), kAddressIndexColumnFamilyName) != families.cend();
+
     auto columns = std::vector<ColumnFamilyDescriptor>();
     columns.emplace_back(kDefaultColumnFamilyName, options);
     columns.emplace_back(kAssetsColumnFamilyName, assets_options);
+    if(has_index) {
+        columns.emplace_back(kAddressIndexColumnFamilyName, index_options);
+    }
 
     auto handles = std::vector<ColumnFamilyHandle*>();
 
-    auto status = DB::Open(options, config_.db_path.to_native_ansi_path(), columns, &handles, &db_);
+    status = DB::Open(options, config_.db_path.to_native_ansi_path(), columns, &handles, &db_);
     if(!status.ok()) {
         EVT_THROW(token_database_rocksdb_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
     }
 
-    assert(handles.size() == 2);
+    assert(handles.size() == columns.size());
     tokens_handle_ = handles[0];
     assets_handle_ = handles[1];
 
+    if(has_index && !config_.address_index) {
+        // index is not maintained when disabled, drop it so it won't be stale when enabled again
+        status = db_->DropColumnFamily(handles[2]);
+        if(!status.ok()) {
+            EVT_THROW(token_database_rocksdb_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
+        }
+        delete handles[2];
+    }
+    else if(has_index) {
+        address_index_handle_ = handles[2];
+    }
+    else if(config_.address_index) {
+        create_address_index(index_options);
+    }
+
+    flusher_.start(db_, write_opts_);
     if(load_persistence) {
         load_savepoints();
     }
+    // start a new journal from loaded savepoints, old journal is discarded if not loaded
+    checkpoint_journal();
 }
 
 void
 token_database_impl::close(int persist) {
     if(db_) {
+        drain_flushes();
+        flusher_.stop();
+
         if(persist) {
             persist_savepoints();
         }
+
+        // savepoints log is written now, journal is only needed after unclean shutdown
+        journal_.close();
+        fc::remove(config_.db_path / config::token_database_journal_filename);
+
         if(!savepoints_.empty()) {
             free_all_savepoints();
         }
+
+        // cache will be loaded again from savepoints log when opening
+        tokens_write_cache_.clear();
+        assets_write_cache_.clear();
+
+        changes_.enabled    = false;
+        changes_.overflowed = false;
+        changes_.tokens.clear();
+        changes_.assets.clear();
         
         delete tokens_handle_;
         delete assets_handle_;
+        delete address_index_handle_;
         delete db_;
 
+        address_index_handle_ = nullptr;
+
         db_ = nullptr;
     }
 }
@@ -632,30 +1199,35 @@ void
 token_database_impl::put_token(token_type type, action_op op, const name128& prefix, const name128& key, const std::string_view& data) {
     using namespace __internal;
 
-    auto dbkey  = db_token_key(prefix, key);
-    auto status = db_->Put(write_opts_, dbkey.as_slice(), data);
-    if(!status.ok()) {
-        FC_THROW_EXCEPTION(fc::unrecoverable_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
+    auto dbkey = db_token_key(prefix, key);
+    log_change(type, dbkey.as_string_view());
+    if(!should_record()) {
+        drain_flushes();
+        auto status = db_->Put(write_opts_, dbkey.as_slice(), data);
+        if(!status.ok()) {
+            FC_THROW_EXCEPTION(fc::unrecoverable_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
+        }
+        return;
     }
-    if(should_record()) {
-        void* data;
 
-        // for `token` action, needs to record both prefix and key, prefix refers to the domain
-        // for `non-token` action, prefix is not necessary which can be inferred by the `type`
-        if(type != token_type::token) {
-            assert(prefix == action_key_prefixes[(int)type]);
-            auto data = (rt_token_key*)malloc(sizeof(rt_token_key));
-            data->key = key;
+    tokens_write_cache_.put(dbkey.as_string_view(), data);
+    journal_put(type, op, dbkey.as_string_view(), data);
 
-            record((int)type, (int)op, (int)kTokenKey, data);
-        }
-        else {
-            auto data    = (rt_token_fullkey*)malloc(sizeof(rt_token_fullkey));
-            data->prefix = prefix;
-            data->key    = key;
+    // for `token` action, needs to record both prefix and key, prefix refers to the domain
+    // for `non-token` action, prefix is not necessary which can be inferred by the `type`
+    if(type != token_type::token) {
+        assert(prefix == action_key_prefixes[(int)type]);
+        auto data = (rt_token_key*)malloc(sizeof(rt_token_key));
+        data->key = key;
 
-            record((int)type, (int)op, (int)kTokenFullKey, data);
-        }
+        record((int)type, (int)op, (int)kTokenKey, data);
+    }
+    else {
+        auto data    = (rt_token_fullkey*)malloc(sizeof(rt_token_fullkey));
+        data->prefix = prefix;
+        data->key    = key;
+
+        record((int)type, (int)op, (int)kTokenFullKey, data);
     }
 }
 
@@ -669,7 +1241,15 @@ token_database_impl::put_tokens(token_type type,
     assert(keys.size() == data.size());
 
     for(auto i = 0u; i < keys.size(); i++) {
-        auto dbkey  = db_token_key(prefix, keys[i]);
+        auto dbkey = db_token_key(prefix, keys[i]);
+        log_change(type, dbkey.as_string_view());
+        if(should_record()) {
+            tokens_write_cache_.put(dbkey.as_string_view(), data[i]);
+            journal_put(type, op, dbkey.as_string_view(), data[i]);
+            continue;
+        }
+
+        drain_flushes();
         auto status = db_->Put(write_opts_, dbkey.as_slice(), data[i]);
         if(!status.ok()) {
             FC_THROW_EXCEPTION(fc::unrecoverable_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
@@ -689,12 +1269,20 @@ token_database_impl::put_asset(const address& addr, const symbol_id_type sym_id,
     using namespace __internal;
 
     auto dbkey = db_asset_key(addr, sym_id);
+    log_change(token_type::asset, dbkey.as_string_view());
     if(should_record()) {
         assets_write_cache_.put(dbkey.as_string_view(), data);
+        journal_put(token_type::asset, action_op::put, dbkey.as_string_view(), data);
         return;
     }
     else {
-        auto status = db_->Put(write_opts_, assets_handle_, dbkey.as_slice(), data);
+        drain_flushes();
+
+        auto batch = rocksdb::WriteBatch();
+        batch.Put(assets_handle_, dbkey.as_slice(), data);
+        index_asset(batch, dbkey.as_string_view());
+
+        auto status = db_->Write(write_opts_, &batch);
         if(!status.ok()) {
             FC_THROW_EXCEPTION(fc::unrecoverable_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
         }
@@ -707,6 +1295,10 @@ token_database_impl::exists_token(const name128& prefix, const name128& key) con
 
     auto dbkey  = db_token_key(prefix, key);
     auto value  = std::string();
+
+    if(tokens_write_cache_.exists(dbkey.as_string_view()) || tokens_flushing_.exists(dbkey.as_string_view())) {
+        return true;
+    }
     auto status = db_->Get(read_opts_, dbkey.as_slice(), &value);
     return status.ok();
 }
@@ -718,7 +1310,7 @@ token_database_impl::exists_asset(const address& addr, const symbol_id_type sym_
     auto dbkey  = db_asset_key(addr, sym_id);
     auto value  = std::string();
 
-    if(assets_write_cache_.exists(dbkey.as_string_view())) {
+    if(assets_write_cache_.exists(dbkey.as_string_view()) || assets_flushing_.exists(dbkey.as_string_view())) {
         return true;
     }
     auto status = db_->Get(read_opts_, assets_handle_, dbkey.as_slice(), &value);
@@ -729,7 +1321,11 @@ int
 token_database_impl::read_token(const name128& prefix, const name128& key, std::string& out, bool no_throw) const {
     using namespace __internal;
 
-    auto dbkey  = db_token_key(prefix, key);
+    auto dbkey = db_token_key(prefix, key);
+    if(tokens_write_cache_.read(dbkey.as_string_view(), out) || tokens_flushing_.read(dbkey.as_string_view(), out)) {
+        return true;
+    }
+
     auto status = db_->Get(read_opts_, dbkey.as_slice(), &out);
     if(!status.ok()) {
         if(!status.IsNotFound()) {
@@ -748,7 +1344,7 @@ token_database_impl::read_asset(const address& addr, const symbol_id_type sym_id
     using namespace __internal;
 
     auto key = db_asset_key(addr, sym_id);
-    if(assets_write_cache_.read(key.as_string_view(), out)) {
+    if(assets_write_cache_.read(key.as_string_view(), out) || assets_flushing_.read(key.as_string_view(), out)) {
         return true;
     }
 
@@ -767,101 +1363,264 @@ token_database_impl::read_asset(const address& addr, const symbol_id_type sym_id
 
 int
 token_database_impl::read_tokens_range(const name128& prefix, int skip, const read_value_func& func) const {
-    using namespace __internal;
-
-    auto it    = db_->NewIterator(read_opts_);
-    auto key   = rocksdb::Slice((char*)&prefix, sizeof(prefix));
-    auto i     = 0;
-    auto count = 0;
-    
-    it->Seek(key);
-    while(it->Valid()) {
-        if(i++ < skip) {
-            it->Next();
-            continue;
-        }
-
-        count++;
-        auto value = it->value().ToString();
-        auto key   = it->key();
-
-        key.remove_prefix(sizeof(prefix));
-        if(!func(key.ToStringView(), std::move(value))) {
-            delete it;
-            return count;
-        }
-        it->Next();
-    }
-    delete it;
-    return count;
+    return read_range(tokens_handle_, std::string_view((const char*)&prefix, sizeof(prefix)), skip, func);
 }
 
 int
 token_database_impl::read_assets_range(const symbol_id_type sym_id, int skip, const read_value_func& func) const {
-    using namespace __internal;
+    return read_range(assets_handle_, std::string_view((const char*)&sym_id, sizeof(sym_id)), skip, func);
+}
 
-    // create snapshot first
-    auto ss = db_->GetSnapshot();
-    
-    // write new values from cache into db
-    for(auto& it : assets_write_cache_.data_) {
-        auto k = rocksdb::Slice(it.first().data(), it.first().size());
-        auto v = rocksdb::Slice(it.second.value.data(), it.second.value.size());
-        db_->Put(write_opts_, assets_handle_, k, v);
-    }
+int
+token_database_impl::read_address_assets(const address& addr, const read_value_func& func) const {
+    using namespace __internal;
+    EVT_ASSERT(address_index_handle_, token_database_exception, "Address index of assets is not enabled in token database");
+
+    auto prefix = std::string(kPublicKeySize, '\0');
+    addr.to_bytes(prefix.data(), prefix.size());
+
+    // index only has the assets in db, the ones in write cache and being flushed are found by scanning
+    auto ids = std::vector<symbol_id_type>();
+    auto fn  = [&](const std::string_view& key) {
+        if(key.substr(kSymbolIdSize) == prefix) {
+            auto id = symbol_id_type();
+            memcpy(&id, key.data(), kSymbolIdSize);
+            ids.emplace_back(id);
+        }
+    };
+    for(auto& it : assets_write_cache_.data_) {
+        fn(std::string_view(it.first().data(), it.first().size()));
+    }
+    assets_flushing_.for_each_key(fn);
 
-    // scan values
-    auto it    = db_->NewIterator(read_opts_, assets_handle_);
-    auto key   = rocksdb::Slice((char*)&sym_id, sizeof(sym_id));
-    auto count = 0;
+    auto it = std::unique_ptr<rocksdb::Iterator>(db_->NewIterator(read_opts_, address_index_handle_));
+    for(it->Seek(prefix); it->Valid(); it->Next()) {
+        auto key = it->key();
+
+        auto id = symbol_id_type();
+        memcpy(&id, key.data() + kPublicKeySize, kSymbolIdSize);
+        ids.emplace_back(id);
+    }
+    if(!it->status().ok()) {
+        FC_THROW_EXCEPTION(fc::unrecoverable_exception, "Rocksdb internal error: ${err}", ("err", it->status().getState()));
+    }
+
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    auto i = 0;
+    for(auto id : ids) {
+        auto value = std::string();
+        if(!read_asset(addr, id, value, true /* no throw */)) {
+            continue;
+        }
+
+        i++;
+        auto key = db_asset_key(addr, id);
+        if(!func(key.as_string_view(), std::move(value))) {
+            break;
+        }
+    }
+    return i;
+}
+
+int
+token_database_impl::read_range(rocksdb::ColumnFamilyHandle* handle, const std::string_view& prefix, int skip, const read_value_func& func) const {
+    using namespace __internal;
+
+    auto& cache    = (handle == assets_handle_) ? assets_write_cache_ : tokens_write_cache_;
+    auto& flushing = (handle == assets_handle_) ? assets_flushing_ : tokens_flushing_;
+
+    // values in write cache are newer than the ones being flushed, set_union takes them first
+    auto cached  = cache.read_prefix(prefix);
+    auto flushed = flushing.read_prefix(prefix);
+    if(!flushed.empty()) {
+        auto merged = write_cache_layer::range_t();
+        std::set_union(cached.begin(), cached.end(), flushed.begin(), flushed.end(), std::back_inserter(merged),
+            [](auto& a, auto& b) { return a.first < b.first; });
+        cached = std::move(merged);
+    }
+    auto ci = cached.begin();
+
+    // merge values in db with the ones in write cache, both are sorted by key
+    auto it    = std::unique_ptr<rocksdb::Iterator>(db_->NewIterator(read_opts_, handle ? handle : db_->DefaultColumnFamily()));
     auto i     = 0;
-    
-    it->Seek(key);
-    while(it->Valid()) {
-        if(i++ < skip) {
+    auto count = 0;
+
+    it->Seek(rocksdb::Slice(prefix.data(), prefix.size()));
+    while(it->Valid() || ci != cached.end()) {
+        auto from_db    = false;
+        auto from_cache = false;
+        if(!it->Valid()) {
+            from_cache = true;
+        }
+        else if(ci == cached.end()) {
+            from_db = true;
+        }
+        else {
+            // same key in both, the one in cache is newer
+            auto c     = it->key().compare(rocksdb::Slice(ci->first.data(), ci->first.size()));
+            from_db    = (c <= 0);
+            from_cache = (c >= 0);
+        }
+
+        if(i++ >= skip) {
+            count++;
+            auto key   = from_cache ? ci->first : it->key().ToStringView();
+            auto value = from_cache ? *ci->second : it->value().ToString();
+
+            key.remove_prefix(prefix.size());
+            if(!func(key, std::move(value))) {
+                return count;
+            }
+        }
+
+        if(from_db) {
             it->Next();
-            continue;
         }
+        if(from_cache) {
+            ci++;
+        }
+    }
+    return count;
+}
 
-        count++;
-        auto value = it->value().ToString();
-        auto key   = it->key();
+void
+token_database_impl::ingest(rocksdb::ColumnFamilyHandle* handle, const std::string_view& prefix, const bulk_value_func& func) {
+    using namespace rocksdb;
+
+    EVT_ASSERT(savepoints_.empty(), token_database_exception, "Bulk loading is only allowed when there's no savepoints");
+    drain_flushes();
+
+    auto key   = std::string(prefix.data(), prefix.size());
+    auto k     = std::string();
+    auto v     = std::string();
+    auto count = 0;
+
+    if(config_.profile != storage_profile::disk) {
+        // plain table cannot ingest external sst files, fallback to batch writes
+        auto batch = WriteBatch();
+        while(func(k, v)) {
+            key.resize(prefix.size());
+            key.append(k);
+            batch.Put(handle, key, v);
+            if(handle == assets_handle_) {
+                index_asset(batch, key);
+            }
+        }
 
-        key.remove_prefix(sizeof(sym_id));
-        if(!func(key.ToStringView(), std::move(value))) {
-            delete it;
-            return count;
+        auto status = db_->Write(write_opts_, &batch);
+        if(!status.ok()) {
+            FC_THROW_EXCEPTION(fc::unrecoverable_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
         }
-        it->Next();
+        return;
     }
-    delete it;
 
-    // restore values
-    auto snapshot_read_opts_     = read_opts_;
-    snapshot_read_opts_.snapshot = ss;
+    auto& options = (handle == assets_handle_) ? assets_options_ : tokens_options_;
+    auto  file    = config_.db_path / fmt::format("ingest-{}.sst", ingest_seq_++);
+    auto  path    = file.to_native_ansi_path();
+    auto  writer  = SstFileWriter(EnvOptions(), options, handle);
 
-    auto batch = rocksdb::WriteBatch();
-    for(auto& it : assets_write_cache_.data_) {
-        auto v = std::string();
-        auto k = rocksdb::Slice(it.first().data(), it.first().size());
-        auto s = db_->Get(snapshot_read_opts_, assets_handle_, k, &v);
-        if(s.ok()) {
-            // put value back
-            batch.Put(assets_handle_, k, v);
+    // file is moved into db after ingested, remove it when failed
+    auto remove_file = fc::make_scoped_exit([&file] {
+        if(fc::exists(file)) {
+            fc::remove(file);
         }
-        else if(s.code() == rocksdb::Status::kNotFound) {
-            // remove value
-            batch.Delete(assets_handle_, k);
+    });
+
+    auto status = writer.Open(path);
+    if(!status.ok()) {
+        EVT_THROW(token_database_rocksdb_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
+    }
+
+    // index keys are in different order, they're written in batch after ingested
+    auto index = WriteBatch();
+    while(func(k, v)) {
+        key.resize(prefix.size());
+        key.append(k);
+
+        // keys are required to be strictly increasing
+        status = writer.Put(key, v);
+        if(!status.ok()) {
+            EVT_THROW(token_database_rocksdb_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
         }
-        else {
-            FC_THROW_EXCEPTION(fc::unrecoverable_exception, "Rocksdb internal error: ${err}", ("err", s.getState()));
+        if(handle == assets_handle_) {
+            index_asset(index, key);
         }
+        count++;
+    }
+    if(count == 0) {
+        // sst file cannot be empty
+        return;
     }
-    auto sync_write_opts = write_opts_;
-    sync_write_opts.sync = true;
-    db_->Write(sync_write_opts, &batch);
 
-    return count;
+    status = writer.Finish();
+    if(!status.ok()) {
+        EVT_THROW(token_database_rocksdb_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
+    }
+
+    auto ingest_opts = IngestExternalFileOptions();
+    ingest_opts.move_files = true;
+
+    status = db_->IngestExternalFile(handle, { path }, ingest_opts);
+    if(!status.ok()) {
+        EVT_THROW(token_database_rocksdb_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
+    }
+
+    if(index.Count() > 0) {
+        status = db_->Write(write_opts_, &index);
+        if(!status.ok()) {
+            EVT_THROW(token_database_rocksdb_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
+        }
+    }
+}
+
+void
+token_database_impl::create_address_index(const rocksdb::ColumnFamilyOptions& options) {
+    using namespace rocksdb;
+    using namespace __internal;
+
+    auto status = db_->CreateColumnFamily(options, kAddressIndexColumnFamilyName, &address_index_handle_);
+    if(!status.ok()) {
+        EVT_THROW(token_database_rocksdb_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
+    }
+
+    // build index from all the assets in db
+    auto opts = ReadOptions();
+    opts.total_order_seek = true;
+
+    auto it    = std::unique_ptr<Iterator>(db_->NewIterator(opts, assets_handle_));
+    auto batch = WriteBatch();
+    auto count = 0;
+
+    auto write = [&] {
+        auto status = db_->Write(write_opts_, &batch);
+        if(!status.ok()) {
+            EVT_THROW(token_database_rocksdb_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
+        }
+        batch.Clear();
+    };
+
+    for(it->SeekToFirst(); it->Valid(); it->Next()) {
+        index_asset(batch, it->key().ToStringView());
+        if(++count % 10000 == 0) {
+            write();
+        }
+    }
+    if(!it->status().ok()) {
+        EVT_THROW(token_database_rocksdb_exception, "Rocksdb internal error: ${err}", ("err", it->status().getState()));
+    }
+    write();
+
+    ilog("Address index of token database is created with ${n} assets", ("n", count));
+}
+
+void
+token_database_impl::index_asset(rocksdb::WriteBatch& batch, const std::string_view& key) {
+    if(address_index_handle_ == nullptr) {
+        return;
+    }
+    batch.Put(address_index_handle_, __internal::get_address_index_key(key), rocksdb::Slice());
 }
 
 void
@@ -877,10 +1636,12 @@ token_database_impl::add_savepoint(int64_t seq) {
     }
 
     savepoints_.push_back(savepoint(seq, kRuntime));
-    auto rt = new rt_group { .rb_snapshot = (const void*)db_->GetSnapshot(), .actions = {} }; 
+    auto rt = new rt_group { .actions = {} };
     SETPOINTER(void, savepoints_.back().node.group, rt);
 
+    tokens_write_cache_.add_savepoint(seq);
     assets_write_cache_.add_savepoint(seq);
+    journal(kJournalAddSavepoint, seq);
 }
 
 void
@@ -909,7 +1670,6 @@ token_database_impl::free_savepoint(__internal::savepoint& sp) {
             }
             }  // switch
         }
-        db_->ReleaseSnapshot((const rocksdb::Snapshot*)rt->rb_snapshot);
         delete rt;
         break;
     }
@@ -929,22 +1689,72 @@ token_database_impl::free_all_savepoints() {
     }
 }
 
+write_cache_layer::persist_func
+token_database_impl::make_flush_func(rocksdb::WriteBatch& batch, rocksdb::ColumnFamilyHandle* handle, flush_layer& layer, uint64_t seq) {
+    return [this, &batch, handle, &layer, seq](auto& k, auto&& v) {
+        batch.Put(handle, rocksdb::Slice(k.data(), k.size()), v);
+        if(handle == assets_handle_) {
+            index_asset(batch, std::string_view(k.data(), k.size()));
+        }
+        layer.put(k, std::move(v), seq);
+    };
+}
+
+void
+token_database_impl::submit_flush(std::unique_ptr<rocksdb::WriteBatch>&& batch, uint64_t seq) {
+    if(batch->Count() == 0) {
+        return;
+    }
+    assert(seq == flush_seq_ + 1);
+    flush_seq_ = seq;
+    flusher_.submit(seq, std::move(batch));
+}
+
+void
+token_database_impl::collect_flushes() {
+    flusher_.check_error();
+
+    auto durable = flusher_.durable_seq();
+    tokens_flushing_.remove_durable(durable);
+    assets_flushing_.remove_durable(durable);
+}
+
+void
+token_database_impl::drain_flushes() {
+    // values are always removed from flushing layers after their batch is durable,
+    // so empty layers mean there is nothing in progress
+    if(tokens_flushing_.empty() && assets_flushing_.empty()) {
+        return;
+    }
+    flusher_.wait(flush_seq_);
+    tokens_flushing_.clear();
+    assets_flushing_.clear();
+}
+
 void
 token_database_impl::pop_savepoints(int64_t until) {
+    collect_flushes();
+
+    // values of all the popped savepoints are written into db in one batch by background flusher,
+    // they're still readable from flushing layers before the batch is durable
+    auto batch = std::make_unique<rocksdb::WriteBatch>();
+    auto seq   = flush_seq_ + 1;
     while(!savepoints_.empty() && savepoints_.front().seq < until) {
         auto it = std::move(savepoints_.front());
         savepoints_.pop_front();
         free_savepoint(it);
 
-        // pop write cache and persist into underlying db
+        assert(tokens_write_cache_.ops_.front().seq == it.seq);
         assert(assets_write_cache_.ops_.front().seq == it.seq);
-        auto batch = rocksdb::WriteBatch();
-        assets_write_cache_.pop_front([&](auto& k, auto&& v) {
-            batch.Put(assets_handle_, rocksdb::Slice(k.data(), k.size()), v);
-        });
-        auto sync_write_opts = write_opts_;
-        sync_write_opts.sync = true;
-        db_->Write(sync_write_opts, &batch);
+        tokens_write_cache_.pop_front(make_flush_func(*batch, tokens_handle_, tokens_flushing_, seq));
+        assets_write_cache_.pop_front(make_flush_func(*batch, assets_handle_, assets_flushing_, seq));
+    }
+    submit_flush(std::move(batch), seq);
+    journal(__internal::kJournalPopSavepoints, until);
+
+    // popped savepoints are useless in journal, rewrite it when it grows too large
+    if(journal_.size() > __internal::kJournalCheckpointSize) {
+        checkpoint_journal();
     }
 }
 
@@ -956,7 +1766,12 @@ token_database_impl::pop_back_savepoint() {
     savepoints_.pop_back();
     free_savepoint(it);
 
-    assets_write_cache_.pop_back();
+    auto batch = std::make_unique<rocksdb::WriteBatch>();
+    auto seq   = flush_seq_ + 1;
+    tokens_write_cache_.pop_back(make_flush_func(*batch, tokens_handle_, tokens_flushing_, seq));
+    assets_write_cache_.pop_back(make_flush_func(*batch, assets_handle_, assets_flushing_, seq));
+    submit_flush(std::move(batch), seq);
+    journal(__internal::kJournalPopBack);
 }
 
 void
@@ -977,11 +1792,11 @@ token_database_impl::squash() {
     // add all actions from rt1 into end of rt2
     rt2->actions.insert(rt2->actions.cend(), rt1->actions.cbegin(), rt1->actions.cend());
 
-    // just release rt1's snapshot
-    db_->ReleaseSnapshot((const rocksdb::Snapshot*)rt1->rb_snapshot);
     delete rt1;
 
+    tokens_write_cache_.squash();
     assets_write_cache_.squash();
+    journal(kJournalSquash);
 }
 
 int64_t
@@ -1039,85 +1854,200 @@ get_sp_key(const rt_action& act) {
 }  // namespace __internal
 
 void
-token_database_impl::rollback_rt_group(__internal::rt_group* rt) {
-    using namespace __internal;
-
-    if(rt->actions.empty()) {
-        db_->ReleaseSnapshot((const rocksdb::Snapshot*)rt->rb_snapshot);
+token_database_impl::journal(__internal::journal_type type, int64_t seq) {
+    if(!journal_.is_open()) {
         return;
     }
+    journal_.append(__internal::make_journal_entry(type, seq));
 
-    auto snapshot_read_opts_     = read_opts_;
-    snapshot_read_opts_.snapshot = (const rocksdb::Snapshot*)rt->rb_snapshot;
+    // hand over to os once per operation on savepoints instead of every put,
+    // puts are handed over together with the next one
+    journal_.flush();
+}
 
-    auto key_set = keys_hash_set();
-    auto batch   = rocksdb::WriteBatch();
-    
-    for(auto it = rt->actions.begin(); it < rt->actions.end(); it++) {
-        auto data = GETPOINTER(void, it->data);
+void
+token_database_impl::journal_put(token_type type, action_op op, const std::string_view& key, const std::string_view& value) {
+    if(!journal_.is_open()) {
+        return;
+    }
+    journal_.append(__internal::make_journal_put_entry(type, op, key, value));
+}
 
-        auto fn = [&](auto& key, auto type, auto op) {
-            switch(op) {
-            case action_op::add: {
-                assert(key_set.find(key) == key_set.end());
+void
+token_database_impl::replay_journal(const fc::path& path) {
+    using namespace __internal;
 
-                batch.Delete(key);
-                self_.remove_token_value(key);
-            
-                // insert key into key set
-                key_set.insert(key);
+    // delete old savepoints if existed (from snapshot)
+    savepoints_.clear();
+    tokens_write_cache_.clear();
+    assets_write_cache_.clear();
+
+    // journal is closed here, so replayed operations are not journaled again
+    assert(!journal_.is_open());
+    savepoint_journal::replay(path, [this](auto&& entry) {
+        switch(entry.type) {
+        case kJournalAddSavepoint: {
+            add_savepoint(entry.seq);
+            break;
+        }
+        case kJournalPut: {
+            if(entry.token_type == (uint8_t)token_type::asset) {
+                assets_write_cache_.put(entry.key, entry.value);
                 break;
             }
-            case action_op::update: {
-                // only update operation need to check if key is already processed
-                if(key_set.find(key) != key_set.end()) {
-                    break;
-                }
-                auto old_value = std::string();
-                auto status    = db_->Get(snapshot_read_opts_, key, &old_value);
-                if(!status.ok()) {
-                    FC_THROW_EXCEPTION(fc::unrecoverable_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
-                }
-                batch.Put(key, old_value);
-                self_.rollback_token_value(key);
 
-                // insert key into key set
-                key_set.insert(key);
-                break;
+            assert(entry.key.size() == sizeof(rt_token_fullkey));
+            tokens_write_cache_.put(entry.key, entry.value);
+
+            // key in journal is db key, which consists of prefix and key
+            auto data = (rt_token_fullkey*)malloc(sizeof(rt_token_fullkey));
+            memcpy(data, entry.key.data(), sizeof(rt_token_fullkey));
+
+            record(entry.token_type, entry.op, (int)kTokenFullKey, data);
+            break;
+        }
+        case kJournalRollback: {
+            rollback_to_latest_savepoint();
+            break;
+        }
+        case kJournalSquash: {
+            squash();
+            break;
+        }
+        case kJournalPopSavepoints: {
+            pop_savepoints(entry.seq);
+            break;
+        }
+        case kJournalPopBack: {
+            pop_back_savepoint();
+            break;
+        }
+        case kJournalLegacySavepoint: {
+            auto pd    = new pd_group();
+            pd->seq    = entry.seq;
+            pd->legacy = true;
+            fc::raw::unpack(entry.value.data(), entry.value.size(), pd->actions);
+
+            savepoints_.push_back(savepoint(entry.seq, kPersist));
+            SETPOINTER(void, savepoints_.back().node.group, pd);
+            tokens_write_cache_.add_savepoint(entry.seq);
+            assets_write_cache_.add_savepoint(entry.seq);
+            break;
+        }
+        default: {
+            EVT_THROW(token_database_persist_exception, "Unknown entry type in savepoints journal: ${t}", ("t", entry.type));
+        }
+        }  // switch
+    });
+}
+
+void
+token_database_impl::checkpoint_journal() {
+    using namespace __internal;
+
+    // values of popped savepoints are required to be in db before they're dropped from journal
+    drain_flushes();
+    journal_.close();
+
+    auto path = config_.db_path / config::token_database_journal_filename;
+    auto temp = config_.db_path / (std::string(config::token_database_journal_filename) + ".tmp");
+    if(fc::exists(temp)) {
+        fc::remove(temp);
+    }
+
+    // write current savepoints as the new journal: adding each savepoint and the latest values written in it
+    auto j = savepoint_journal();
+    j.open(temp);
+    for(auto i = 0u; i < savepoints_.size(); i++) {
+        auto& sp = savepoints_[i];
+        if(sp.node.f.type == kPersist && GETPOINTER(pd_group, sp.node.group)->legacy) {
+            // values of legacy savepoints are in db already, whole group is kept for restoring them
+            auto entry  = make_journal_entry(kJournalLegacySavepoint, sp.seq);
+            auto packed = fc::raw::pack(GETPOINTER(pd_group, sp.node.group)->actions);
+            entry.value = std::string(packed.data(), packed.size());
+            j.append(entry);
+            continue;
+        }
+        j.append(make_journal_entry(kJournalAddSavepoint, sp.seq));
+
+        auto key_set = keys_hash_set();
+        auto fn      = [&](const auto& key, auto type, auto op) {
+            if(key_set.find(key) != key_set.end()) {
+                return;
             }
-            case action_op::put: {
-                // only update operation need to check if key is already processed
-                if(key_set.find(key) != key_set.end()) {
-                    break;
+            key_set.insert(key);
+
+            auto value = std::string();
+            if(tokens_write_cache_.read_at(key, sp.seq, value)) {
+                j.append(make_journal_put_entry(type, op, key, value));
+            }
+        };
+
+        auto n = sp.node;
+        switch(n.f.type) {
+        case kRuntime: {
+            auto rt = GETPOINTER(rt_group, n.group);
+            for(auto& act : rt->actions) {
+                if(act.get_data_type() != kTokenKeys) {
+                    fn(get_sp_key(act), act.get_token_type(), act.get_action_op());
+                    continue;
                 }
 
-                // Asset type only has put op
-                auto handle    = (type == token_type::asset) ? assets_handle_ : tokens_handle_;
-                auto old_value = std::string();
-                auto status    = db_->Get(snapshot_read_opts_, handle, key, &old_value);
-
-                // key may not existed in latest snapshot, remove it
-                if(!status.ok()) {
-                    if(status.code() != rocksdb::Status::kNotFound) {
-                        FC_THROW_EXCEPTION(fc::unrecoverable_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
-                    }
-                    batch.Delete(handle, key);
-                    if(handle == tokens_handle_) {
-                        self_.remove_token_value(key);
-                    }
+                auto keys = GETPOINTER(rt_token_keys, act.data);
+                for(auto& k : keys->keys) {
+                    fn(db_token_key(keys->prefix, k).as_string(), act.get_token_type(), act.get_action_op());
                 }
-                else {
-                    batch.Put(handle, key, old_value);
-                    if(handle == tokens_handle_) {
-                        self_.rollback_token_value(key);
-                    }
+            }
+            break;
+        }
+        case kPersist: {
+            auto pd = GETPOINTER(pd_group, n.group);
+            for(auto& act : pd->actions) {
+                if(act.type == (int)token_type::asset) {
+                    continue;
                 }
+                fn(act.key, (token_type)act.type, (action_op)act.op);
+            }
+            break;
+        }
+        }  // switch
 
-                // insert key into key set
-                key_set.insert(key);
-                break;
+        // assets are not recorded in savepoints, take them from write cache directly
+        auto& ops = assets_write_cache_.ops_[i];
+        assert(ops.seq == sp.seq);
+        for(auto it : ops.keys) {
+            auto value = std::string();
+            auto key   = std::string_view(it->first().data(), it->first().size());
+            if(assets_write_cache_.read_at(key, sp.seq, value)) {
+                j.append(make_journal_put_entry(token_type::asset, action_op::put, key, value));
+            }
+        }
+    }
+    j.close();
+
+    fc::rename(temp, path);
+    journal_.open(path);
+}
+
+void
+token_database_impl::rollback_rt_group(__internal::rt_group* rt) {
+    using namespace __internal;
+
+    // values are restored by dropping the latest versions in write caches,
+    // here only notifies the object cache
+    for(auto it = rt->actions.begin(); it < rt->actions.end(); it++) {
+        auto data = GETPOINTER(void, it->data);
+
+        auto fn = [&](auto& key, auto type, auto op) {
+            if(type == token_type::asset) {
+                return;
+            }
+            if(op == action_op::add) {
+                self_.remove_token_value(key);
+            }
+            else {
+                self_.rollback_token_value(key);
             }
-            }  // switch
         };
 
         auto op         = it->get_action_op();
@@ -1148,56 +2078,51 @@ token_database_impl::rollback_rt_group(__internal::rt_group* rt) {
 
         free(data);
     }  // for
-
-    auto sync_write_opts = write_opts_;
-    sync_write_opts.sync = true;
-    db_->Write(sync_write_opts, &batch);
-
-    db_->ReleaseSnapshot((const rocksdb::Snapshot*)rt->rb_snapshot);
 }
 
 void
 token_database_impl::rollback_pd_group(__internal::pd_group* pd) {
     using namespace __internal;
 
-    if(pd->actions.empty()) {
-        return;
-    }
+    // legacy ones wrote values into db directly, restore the values before them like version 0 did
+    if(pd->legacy && !pd->actions.empty()) {
+        drain_flushes();
 
-    // keyset is not required here,
-    // because it has done during creating persist savepoint
-    // cache rollback is also no need here
-    // because cache cannot have persist value objects
-    auto batch = rocksdb::WriteBatch();
-    for(auto it = pd->actions.begin(); it < pd->actions.end(); it++) {
-        switch((action_op)it->op) {
-        case action_op::add: {
-            assert(it->value.empty());
-            batch.Delete(it->key);
-            break;
-        }
-        case action_op::update: {
-            assert(!it->value.empty());
-            batch.Put(it->key, it->value);
-            break;
-        }
-        case action_op::put: {
-            // Asset type only has put op
-            auto handle = (it->type == (int)token_type::asset) ? assets_handle_ : tokens_handle_;
-            if(it->value.empty()) {
-                batch.Delete(handle, it->key);
+        auto batch = rocksdb::WriteBatch();
+        for(auto& act : pd->actions) {
+            auto handle = (act.type == (int)token_type::asset) ? assets_handle_ : tokens_handle_;
+            handle      = handle ? handle : db_->DefaultColumnFamily();
+
+            if(act.op == (int)action_op::add || act.value.empty()) {
+                batch.Delete(handle, act.key);
             }
             else {
-                batch.Put(handle, it->key, it->value);
+                batch.Put(handle, act.key, act.value);
             }
-            break;
         }
-        }  // switch
+
+        auto sync_write_opts = write_opts_;
+        sync_write_opts.sync = true;
+
+        auto status = db_->Write(sync_write_opts, &batch);
+        if(!status.ok()) {
+            FC_THROW_EXCEPTION(fc::unrecoverable_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
+        }
     }
 
-    auto sync_write_opts = write_opts_;
-    sync_write_opts.sync = true;
-    db_->Write(sync_write_opts, &batch);
+    // other persist savepoints are loaded together with the write caches,
+    // so values are restored by write caches as well
+    for(auto& act : pd->actions) {
+        if(act.type == (int)token_type::asset) {
+            continue;
+        }
+        if(act.op == (int)action_op::add) {
+            self_.remove_token_value(act.key);
+        }
+        else {
+            self_.rollback_token_value(act.key);
+        }
+    }
 }
 
 void
@@ -1227,8 +2152,148 @@ token_database_impl::rollback_to_latest_savepoint() {
 
     savepoints_.pop_back();
 
+    assert(seq == tokens_write_cache_.ops_.back().seq);
     assert(seq == assets_write_cache_.ops_.back().seq);
+    tokens_write_cache_.rollback_to_latest_savepoint();
     assets_write_cache_.rollback_to_latest_savepoint();
+    journal(kJournalRollback);
+}
+
+void
+token_database_impl::reset_changes() {
+    using namespace __internal;
+
+    changes_.enabled    = true;
+    changes_.overflowed = false;
+    changes_.tokens.clear();
+    changes_.assets.clear();
+
+    // keys in current savepoints may be changed later by rollback
+    // so they're treated as changed from the beginning
+    for(auto i = 0u; i < savepoints_.size(); i++) {
+        auto n = savepoints_[i].node;
+
+        switch(n.f.type) {
+        case kRuntime: {
+            auto rt = GETPOINTER(rt_group, n.group);
+            for(auto& act : rt->actions) {
+                if(act.get_data_type() != kTokenKeys) {
+                    log_change(act.get_token_type(), get_sp_key(act));
+                    continue;
+                }
+
+                auto keys = GETPOINTER(rt_token_keys, act.data);
+                for(auto& k : keys->keys) {
+                    log_change(act.get_token_type(), db_token_key(keys->prefix, k).as_string_view());
+                }
+            }
+            break;
+        }
+        case kPersist: {
+            auto pd = GETPOINTER(pd_group, n.group);
+            for(auto& act : pd->actions) {
+                log_change((token_type)act.type, act.key);
+            }
+            break;
+        }
+        }  // switch
+    }
+
+    for(auto& it : tokens_write_cache_.data_) {
+        log_change(token_type::token, std::string_view(it.first().data(), it.first().size()));
+    }
+    for(auto& it : assets_write_cache_.data_) {
+        log_change(token_type::asset, std::string_view(it.first().data(), it.first().size()));
+    }
+}
+
+void
+token_database_impl::log_change(token_type type, const std::string_view& key) {
+    if(!changes_.enabled) {
+        return;
+    }
+
+    auto& keys = (type == token_type::asset) ? changes_.assets : changes_.tokens;
+    keys.insert(llvm::StringRef(key.data(), key.size()));
+
+    // bounds the memory when delta snapshots are not taken for a long time
+    if(changes_.tokens.size() + changes_.assets.size() > config_.max_tracked_changes) {
+        changes_.enabled    = false;
+        changes_.overflowed = true;
+        changes_.tokens.clear();
+        changes_.assets.clear();
+    }
+}
+
+int
+token_database_impl::read_changes(rocksdb::ColumnFamilyHandle* handle, const __internal::keys_hash_set& keys, const read_value_func& func) const {
+    EVT_ASSERT(!changes_.overflowed, token_database_exception, "Too many changes to track in token database, a full snapshot is required");
+    EVT_ASSERT(changes_.enabled, token_database_exception, "Changes are not tracked in token database");
+
+    // sort keys to make the output stable
+    auto sorted = std::vector<llvm::StringRef>();
+    sorted.reserve(keys.size());
+    for(auto& it : keys) {
+        sorted.emplace_back(it.first());
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    auto i = 0;
+    for(auto& k : sorted) {
+        auto key   = std::string_view(k.data(), k.size());
+        auto value = std::string();
+
+        // values may still be in the write caches or being flushed
+        auto& cache    = (handle == assets_handle_) ? assets_write_cache_ : tokens_write_cache_;
+        auto& flushing = (handle == assets_handle_) ? assets_flushing_ : tokens_flushing_;
+        if(!cache.read(key, value) && !flushing.read(key, value)) {
+            auto status = db_->Get(read_opts_, handle, rocksdb::Slice(key.data(), key.size()), &value);
+            if(!status.ok() && !status.IsNotFound()) {
+                FC_THROW_EXCEPTION(fc::unrecoverable_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
+            }
+        }
+
+        i++;
+        if(!func(key, std::move(value))) {
+            break;
+        }
+    }
+    return i;
+}
+
+void
+token_database_impl::apply_changes(rocksdb::ColumnFamilyHandle* handle, const bulk_value_func& func) {
+    EVT_ASSERT(savepoints_.empty(), token_database_exception, "Cannot apply changes when there're savepoints");
+    drain_flushes();
+
+    auto batch = rocksdb::WriteBatch();
+    auto k     = std::string();
+    auto v     = std::string();
+    while(func(k, v)) {
+        if(v.empty()) {
+            batch.Delete(handle, k);
+            if(handle != assets_handle_) {
+                self_.remove_token_value(k);
+            }
+            else if(address_index_handle_) {
+                batch.Delete(address_index_handle_, __internal::get_address_index_key(k));
+            }
+        }
+        else {
+            batch.Put(handle, k, v);
+            if(handle != assets_handle_) {
+                self_.rollback_token_value(k);
+            }
+            else {
+                index_asset(batch, k);
+            }
+        }
+    }
+
+    auto status = db_->Write(write_opts_, &batch);
+    if(!status.ok()) {
+        EVT_THROW(token_database_rocksdb_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
+    }
 }
 
 void
@@ -1245,13 +2310,13 @@ token_database_impl::persist_savepoints() const {
         fs.open(filename.to_native_ansi_path(), (std::ios::out | std::ios::binary));
 
         auto h = pd_header {
-            .dirty_flag = 1
+            .dirty_flag = 1,
+            .version    = kSavepointsLogVersion
         };
         // set dirty first
         fc::raw::pack(fs, h);
 
         persist_savepoints(fs);
-        assets_write_cache_.persist_savepoints(fs);
 
         // clear dirty
         fs.seekp(0);
@@ -1267,6 +2332,14 @@ token_database_impl::persist_savepoints() const {
 
 void
 token_database_impl::load_savepoints() {
+    // journal is left only after unclean shutdown, it's newer than savepoints log then
+    auto journal = config_.db_path / config::token_database_journal_filename;
+    if(fc::exists(journal)) {
+        wlog("Token database is not closed cleanly, restore savepoints from journal");
+        replay_journal(journal);
+        return;
+    }
+
     auto filename = config_.db_path / config::token_database_persisit_filename;
     if(!fc::exists(filename)) {
         wlog("No savepoints log in token database");
@@ -1279,11 +2352,11 @@ token_database_impl::load_savepoints() {
 
     // delete old savepoints if existed (from snapshot)
     savepoints_.clear();
+    tokens_write_cache_.clear();
     assets_write_cache_.clear();
 
     // load
     load_savepoints(fs);
-    assets_write_cache_.load_savepoints(fs);
 
     // close
     fs.close();
@@ -1293,7 +2366,8 @@ void
 token_database_impl::persist_savepoints(std::ostream& os) const {
     using namespace __internal;
 
-    auto pds = std::vector<pd_group>();
+    auto pds         = std::vector<pd_group>();
+    auto legacy_seqs = std::vector<int64_t>();
 
     for(auto i = 0u; i < savepoints_.size(); i++) {
         auto& sp = savepoints_[i];
@@ -1307,93 +2381,39 @@ token_database_impl::persist_savepoints(std::ostream& os) const {
         case kPersist: {
             auto pd2 = GETPOINTER(pd_group, n.group);
             pd.actions.insert(pd.actions.cbegin(), pd2->actions.cbegin(), pd2->actions.cend());
-            
+            if(pd2->legacy) {
+                legacy_seqs.emplace_back(sp.seq);
+            }
             break;
         }
         case kRuntime: {
             auto rt = GETPOINTER(rt_group, n.group);
 
+            // only keys are kept, values are persisted by write caches
             auto key_set = keys_hash_set();
-
-            auto snapshot_read_opts_     = read_opts_;
-            snapshot_read_opts_.snapshot = (const rocksdb::Snapshot*)rt->rb_snapshot;
-
-            for(auto& act : rt->actions) {
-                auto data = GETPOINTER(void, act.data);
-
-                auto fn = [&](const auto& key, auto type, auto op) {
-                    auto value = std::string();
-
-                    switch(op) {
-                    case action_op::add: {
-                        assert(key_set.find(key) == key_set.end());
-
-                        // no need to read value
-                        key_set.insert(key);
-                        break;
-                    }
-                    case action_op::update: {
-                        if(key_set.find(key) != key_set.end()) {
-                            break;
-                        }
-
-                        auto status = db_->Get(snapshot_read_opts_, key, &value);
-                        if(!status.ok()) {
-                            FC_THROW_EXCEPTION(fc::unrecoverable_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
-                        }
-
-                        key_set.insert(key);
-                        break;
-                    }
-                    case action_op::put: {
-                        if(key_set.find(key) != key_set.end()) {
-                            break;
-                        }
-
-                        auto handle = (type == token_type::asset) ? assets_handle_ : tokens_handle_;
-                        auto status = db_->Get(snapshot_read_opts_, handle, key, &value);
-                        
-                        // key may not existed in latest snapshot
-                        if(!status.ok() && status.code() != rocksdb::Status::kNotFound) {
-                            FC_THROW_EXCEPTION(fc::unrecoverable_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
-                        }
-
-                        key_set.insert(key);
-                        break;
-                    }
-                    }  // switch
-
-                    return value;
-                };
-
-                auto op         = act.get_action_op();
-                auto data_type  = act.get_data_type();
-                auto type       = act.get_token_type();
+            auto add_key = [&](std::string&& key, auto type, auto op) {
+                if(key_set.find(key) != key_set.end()) {
+                    return;
+                }
+                key_set.insert(key);
 
                 auto pdact = pd_action();
                 pdact.op   = (int)op;
                 pdact.type = (int)type;
+                pdact.key  = std::move(key);
+                pd.actions.emplace_back(std::move(pdact));
+            };
 
-                switch(data_type) {
-                case kTokenKey:
-                case kTokenFullKey:
-                case kAssetKey: {
-                    pdact.key   = get_sp_key(act);
-                    pdact.value = fn(pdact.key, type, op);
-                    pd.actions.emplace_back(std::move(pdact));
-                    break;
+            for(auto& act : rt->actions) {
+                if(act.get_data_type() != kTokenKeys) {
+                    add_key(get_sp_key(act), act.get_token_type(), act.get_action_op());
+                    continue;
                 }
-                case kTokenKeys: {
-                    auto  keys   = (rt_token_keys*)data;
-                    auto& prefix = keys->prefix;
-                    for(auto& k : keys->keys) {
-                        pdact.key   = db_token_key(prefix, k).as_string();
-                        pdact.value = fn(pdact.key, type, op);
-                        pd.actions.emplace_back(pdact);
-                    }
-                    break;
+
+                auto keys = GETPOINTER(rt_token_keys, act.data);
+                for(auto& k : keys->keys) {
+                    add_key(db_token_key(keys->prefix, k).as_string(), act.get_token_type(), act.get_action_op());
                 }
-                }  // switch
             }  // for
             break;
         }
@@ -1403,6 +2423,10 @@ token_database_impl::persist_savepoints(std::ostream& os) const {
     }  // for
 
     fc::raw::pack(os, pds);
+    fc::raw::pack(os, legacy_seqs);
+
+    assets_write_cache_.persist_savepoints(os);
+    tokens_write_cache_.persist_savepoints(os);
 }
 
 void
@@ -1412,20 +2436,47 @@ token_database_impl::load_savepoints(std::istream& is) {
     auto h = pd_header();
     fc::raw::unpack(is, h);
     EVT_ASSERT(h.dirty_flag == 0, token_database_dirty_flag_exception, "checkpoints log file dirty flag set");
+    EVT_ASSERT(h.version <= kSavepointsLogVersion, token_database_persist_exception,
+        "Unknown version of savepoints log: ${v}", ("v", h.version));
 
     auto pds = std::vector<pd_group>();
     fc::raw::unpack(is, pds);
 
+    // all the savepoints of version 0 are legacy ones
+    auto legacy_seqs = std::vector<int64_t>();
+    if(h.version == 0) {
+        for(auto& pd : pds) {
+            legacy_seqs.emplace_back(pd.seq);
+        }
+    }
+    else {
+        fc::raw::unpack(is, legacy_seqs);
+    }
+
     for(auto& pd : pds) {
         savepoints_.push_back(savepoint(pd.seq, kPersist));
 
-        auto ppd = new pd_group(pd);
+        auto ppd    = new pd_group(std::move(pd));
+        ppd->legacy = std::find(legacy_seqs.cbegin(), legacy_seqs.cend(), ppd->seq) != legacy_seqs.cend();
         SETPOINTER(void, savepoints_.back().node.group, ppd);
     }
+
+    if(h.version == 0) {
+        // no write caches in version 0, keep them aligned with the savepoints
+        for(auto i = 0u; i < savepoints_.size(); i++) {
+            tokens_write_cache_.add_savepoint(savepoints_[i].seq);
+            assets_write_cache_.add_savepoint(savepoints_[i].seq);
+        }
+        return;
+    }
+    assets_write_cache_.load_savepoints(is);
+    tokens_write_cache_.load_savepoints(is);
 }
 
 void
-token_database_impl::flush() const {
+token_database_impl::flush() {
+    drain_flushes();
+
     auto status = db_->Flush(rocksdb::FlushOptions());
     if(!status.ok()) {
         FC_THROW_EXCEPTION(fc::unrecoverable_exception, "Rocksdb internal error: ${err}", ("err", status.getState()));
@@ -1518,11 +2569,69 @@ token_database::read_tokens_range(token_type type, const std::optional<name128>&
     return my_->read_tokens_range(prefix, skip, func);
 }
 
+int
+token_database::read_address_assets(const address& addr, const read_value_func& func) const {
+    return my_->read_address_assets(addr, func);
+}
+
+bool
+token_database::has_address_index() const {
+    return my_->address_index_handle_ != nullptr;
+}
+
 int
 token_database::read_assets_range(const symbol_id_type sym_id, int skip, const read_value_func& func) const {
     return my_->read_assets_range(sym_id, skip, func);
 }
 
+void
+token_database::ingest_tokens(token_type type, const std::optional<name128>& domain, const bulk_value_func& func) {
+    using namespace __internal;
+
+    assert(type != token_type::asset);
+    assert((type == token_type::token) != (!domain.has_value()));
+    auto& prefix = domain.has_value() ? *domain : action_key_prefixes[(int)type];
+    auto  handle = my_->tokens_handle_ ? my_->tokens_handle_ : my_->db_->DefaultColumnFamily();
+    my_->ingest(handle, std::string_view((const char*)&prefix, sizeof(prefix)), func);
+}
+
+void
+token_database::ingest_assets(const symbol_id_type sym_id, const bulk_value_func& func) {
+    my_->ingest(my_->assets_handle_, std::string_view((const char*)&sym_id, sizeof(sym_id)), func);
+}
+
+void
+token_database::reset_changes() {
+    my_->reset_changes();
+}
+
+bool
+token_database::is_tracking_changes() const {
+    return my_->changes_.enabled;
+}
+
+int
+token_database::read_changed_tokens(const read_value_func& func) const {
+    auto handle = my_->tokens_handle_ ? my_->tokens_handle_ : my_->db_->DefaultColumnFamily();
+    return my_->read_changes(handle, my_->changes_.tokens, func);
+}
+
+int
+token_database::read_changed_assets(const read_value_func& func) const {
+    return my_->read_changes(my_->assets_handle_, my_->changes_.assets, func);
+}
+
+void
+token_database::apply_changed_tokens(const bulk_value_func& func) {
+    auto handle = my_->tokens_handle_ ? my_->tokens_handle_ : my_->db_->DefaultColumnFamily();
+    my_->apply_changes(handle, func);
+}
+
+void
+token_database::apply_changed_assets(const bulk_value_func& func) {
+    my_->apply_changes(my_->assets_handle_, func);
+}
+
 token_database::session
 token_database::new_savepoint_session(int64_t seq) {
     my_->add_savepoint(seq);
@@ -1580,6 +2689,61 @@ token_database::stats() const {
     return "NA";
 }
 
+token_database::metrics
+token_database::get_metrics() const {
+    using namespace rocksdb;
+
+    auto m = metrics();
+
+    auto& stats = my_->tokens_options_.statistics;
+    if(stats) {
+        auto hist = [&](auto type, auto& h) {
+            auto data = HistogramData();
+            stats->histogramData(type, &data);
+
+            h.p50   = data.median;
+            h.p95   = data.percentile95;
+            h.p99   = data.percentile99;
+            h.max   = data.max;
+            h.count = data.count;
+            h.sum   = data.sum;
+        };
+
+        m.stats_enabled       = true;
+        m.block_cache_hit     = stats->getTickerCount(BLOCK_CACHE_HIT);
+        m.block_cache_miss    = stats->getTickerCount(BLOCK_CACHE_MISS);
+        m.memtable_hit        = stats->getTickerCount(MEMTABLE_HIT);
+        m.memtable_miss       = stats->getTickerCount(MEMTABLE_MISS);
+        m.keys_read           = stats->getTickerCount(NUMBER_KEYS_READ);
+        m.keys_written        = stats->getTickerCount(NUMBER_KEYS_WRITTEN);
+        m.bytes_read          = stats->getTickerCount(BYTES_READ);
+        m.bytes_written       = stats->getTickerCount(BYTES_WRITTEN);
+        m.compact_read_bytes  = stats->getTickerCount(COMPACT_READ_BYTES);
+        m.compact_write_bytes = stats->getTickerCount(COMPACT_WRITE_BYTES);
+        m.stall_micros        = stats->getTickerCount(STALL_MICROS);
+        hist(DB_GET, m.get_micros);
+        hist(DB_WRITE, m.write_micros);
+        hist(DB_SEEK, m.seek_micros);
+    }
+
+    // properties are summed up from both column families
+    auto prop = [&](auto& name) {
+        auto v1 = uint64_t(0), v2 = uint64_t(0);
+        my_->db_->GetIntProperty(my_->db_->DefaultColumnFamily(), name, &v1);
+        my_->db_->GetIntProperty(my_->assets_handle_, name, &v2);
+        return v1 + v2;
+    };
+    m.estimate_keys            = prop(DB::Properties::kEstimateNumKeys);
+    m.memtables_size           = prop(DB::Properties::kCurSizeAllMemTables);
+    m.pending_compaction_bytes = prop(DB::Properties::kEstimatePendingCompactionBytes);
+
+    m.savepoints       = my_->savepoints_.size();
+    m.write_cache_keys = my_->tokens_write_cache_.size() + my_->assets_write_cache_.size();
+    m.flushing_keys    = my_->tokens_flushing_.size() + my_->assets_flushing_.size();
+
+    return m;
+}
+
 void
 token_database::flush() const {
     my_->flush();
@@ -1606,8 +2770,10 @@ token_database::get_db_key(token_type type, const std::optional<name128>& domain
 
 }}  // namespace evt::chain
 
-FC_REFLECT(evt::chain::__internal::pd_header, (dirty_flag));
+FC_REFLECT(evt::chain::__internal::pd_header, (dirty_flag)(version));
 FC_REFLECT(evt::chain::__internal::pd_action, (op)(type)(key)(value));
 FC_REFLECT(evt::chain::__internal::pd_group,  (seq)(actions));
 FC_REFLECT(evt::chain::__internal::wc_entry, (k)(v));
 FC_REFLECT(evt::chain::__internal::wc_entry_pack, (seq)(vec));
+FC_REFLECT(evt::chain::__internal::journal_entry, (type)(token_type)(op)(seq)(key)(value));
+FC_REFLECT(evt::chain::__internal::journal_header, (size)(checksum));
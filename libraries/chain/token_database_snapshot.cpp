@@ -5,6 +5,7 @@
 #include <fmt/format.h>
 #include <rocksdb/db.h>
 #include <evt/chain/token_database.hpp>
+#include <evt/chain/thread_utils.hpp>
 
 namespace evt { namespace chain {
 
@@ -25,6 +26,24 @@ const char* section_names[] = {
     ".psvbonus-dist"
 };
 
+template <typename T, typename F>
+void
+for_each_section(boost::asio::thread_pool* thread_pool, bool concurrent, const std::vector<T>& items, F&& f) {
+    if(thread_pool == nullptr || !concurrent) {
+        for(auto& item : items) {
+            f(item);
+        }
+        return;
+    }
+
+    auto futures = std::vector<std::future<void>>();
+    futures.reserve(items.size());
+    for(auto& item : items) {
+        futures.emplace_back(async_thread_pool(*thread_pool, [&f, &item] { f(item); }));
+    }
+    wait_all_futures(futures);
+}
+
 void
 add_reserved_tokens(snapshot_writer_ptr          writer, 
                     const token_database&        db, 
@@ -63,8 +82,11 @@ add_reserved_tokens(snapshot_writer_ptr          writer,
 }
 
 void
-add_tokens(snapshot_writer_ptr writer, const token_database& db, const std::vector<domain_name> domains) {
-    for(auto& d : domains) {
+add_tokens(snapshot_writer_ptr             writer,
+           const token_database&           db,
+           const std::vector<domain_name>& domains,
+           boost::asio::thread_pool*       thread_pool) {
+    for_each_section(thread_pool, writer->concurrent(), domains, [&](auto& d) {
         writer->write_section(d.to_string(), [&](auto& w) {
             db.read_tokens_range(token_type::token, d, 0, [&w](auto& key, auto&& v) {
                 w.add_row(key.data(), key.size());
@@ -73,12 +95,15 @@ add_tokens(snapshot_writer_ptr writer, const token_database& db, const std::vect
                 return true;
             });
         });
-    }
+    });
 }
 
 void
-add_assets(snapshot_writer_ptr writer, const token_database& db, const std::vector<symbol_id_type>& symbol_ids) {
-    for(auto& id : symbol_ids) {
+add_assets(snapshot_writer_ptr                writer,
+           const token_database&              db,
+           const std::vector<symbol_id_type>& symbol_ids,
+           boost::asio::thread_pool*          thread_pool) {
+    for_each_section(thread_pool, writer->concurrent(), symbol_ids, [&](auto& id) {
         auto sn = fmt::format(".asset-{}", id);
         writer->write_section(sn, [&](auto& w) {
             db.read_assets_range(id, 0, [&w](auto& key, auto&& v) {
@@ -89,7 +114,24 @@ add_assets(snapshot_writer_ptr writer, const token_database& db, const std::vect
                 return true;
             });
         });
-    }
+    });
+}
+
+// reads pairs of key and value rows from section and feeds them into bulk loading
+template <typename Reader>
+auto
+make_bulk_func(Reader& r, size_t key_size) {
+    return [&r, key_size](auto& k, auto& v) {
+        if(r.eof()) {
+            return false;
+        }
+
+        k.resize(key_size);
+        r.read_row(k.data(), k.size());
+        r.read_row(v);
+
+        return true;
+    };
 }
 
 void
@@ -103,66 +145,77 @@ read_reserved_tokens(snapshot_reader_ptr          reader,
         }
 
         reader->read_section(section_names[i], [&](auto& r) {
-            while(!r.eof()) {
-                auto k = uint128_t(0);
-                auto v = std::string();
-
-                r.read_row((char*)&k, sizeof(k));
-                r.read_row(v);
+            auto read = make_bulk_func(r, sizeof(name128));
+            db.ingest_tokens((token_type)i, std::nullopt, [&](auto& k, auto& v) {
+                if(!read(k, v)) {
+                    return false;
+                }
 
-                db.put_token((token_type)i, action_op::put, std::nullopt, k, std::string_view(v.data(), v.size()));
+                auto n = name128();
+                memcpy(&n, k.data(), sizeof(name128));
 
                 if(i == (int)token_type::domain) {
-                    domains.emplace_back(k);
+                    domains.emplace_back(n);
                 }
                 else if(i == (int)token_type::fungible) {
-                    symbol_ids.emplace_back((symbol_id_type)k);
+                    symbol_ids.emplace_back((symbol_id_type)n.value);
                 }
-            }
+                return true;
+            });
         });
     }
 }
 
 void
-read_tokens(snapshot_reader_ptr reader, token_database& db, const std::vector<domain_name>& domains) {
-    for(auto& d : domains) {
+read_tokens(snapshot_reader_ptr             reader,
+            token_database&                 db,
+            const std::vector<domain_name>& domains,
+            boost::asio::thread_pool*       thread_pool) {
+    for_each_section(thread_pool, reader->concurrent(), domains, [&](auto& d) {
         reader->read_section(d.to_string(), [&](auto& r) {
-            while(!r.eof()) {
-                auto k = name128();
-                auto v = std::string();
-
-                r.read_row((char*)&k, sizeof(k));
-                r.read_row(v);
-
-                db.put_token(token_type::token, action_op::put, d, k, std::string_view(v.data(), v.size()));
-            }
+            db.ingest_tokens(token_type::token, d, make_bulk_func(r, sizeof(name128)));
         });
-    }
+    });
 }
 
 void
-read_assets(snapshot_reader_ptr reader, token_database& db, const std::vector<symbol_id_type>& symbol_ids) {
-    for(auto& id : symbol_ids) {
+read_assets(snapshot_reader_ptr                reader,
+            token_database&                    db,
+            const std::vector<symbol_id_type>& symbol_ids,
+            boost::asio::thread_pool*          thread_pool) {
+    for_each_section(thread_pool, reader->concurrent(), symbol_ids, [&](auto& id) {
         auto sn = fmt::format(".asset-{}", id);
         reader->read_section(sn, [&](auto& r) {
-            while(!r.eof()) {
-                auto k = fc::ecc::public_key_shim();
-                auto v = std::string();
+            // keys in assets sections are raw bytes of addresses
+            db.ingest_assets(id, make_bulk_func(r, sizeof(fc::ecc::public_key_shim)));
+        });
+    });
+}
 
-                r.read_row((char*)&k, sizeof(k));
-                r.read_row(v);
+const char* delta_tokens_section = ".delta-tokens";
+const char* delta_assets_section = ".delta-assets";
 
-                auto addr = address(public_key_type(k));
-                db.put_asset(addr, id, std::string_view(v.data(), v.size()));
-            }
-        });
-    }
+const size_t token_key_size = sizeof(name128) * 2;
+const size_t asset_key_size = sizeof(symbol_id_type) + sizeof(fc::ecc::public_key_shim);
+
+template <typename Writer>
+auto
+make_delta_func(Writer& w, size_t key_size) {
+    return [&w, key_size](auto& key, auto&& v) {
+        assert(key.size() == key_size);
+
+        // empty value means the key is removed
+        w.add_row(key.data(), key.size());
+        w.add_row(v);
+
+        return true;
+    };
 }
 
 }  // namespace __internal
 
 void
-token_database_snapshot::add_to_snapshot(snapshot_writer_ptr writer, const token_database& db) {
+token_database_snapshot::add_to_snapshot(snapshot_writer_ptr writer, const token_database& db, boost::asio::thread_pool* thread_pool) {
     using namespace __internal;
 
     try {
@@ -170,14 +223,14 @@ token_database_snapshot::add_to_snapshot(snapshot_writer_ptr writer, const token
         auto symbol_ids = std::vector<symbol_id_type>();
 
         add_reserved_tokens(writer, db, domains, symbol_ids);
-        add_tokens(writer, db, domains);
-        add_assets(writer, db, symbol_ids);
+        add_tokens(writer, db, domains, thread_pool);
+        add_assets(writer, db, symbol_ids, thread_pool);
     }
     EVT_CAPTURE_AND_RETHROW(token_database_snapshot_exception);
 }
 
 void
-token_database_snapshot::read_from_snapshot(snapshot_reader_ptr reader, token_database& db) {
+token_database_snapshot::read_from_snapshot(snapshot_reader_ptr reader, token_database& db, boost::asio::thread_pool* thread_pool) {
     using namespace __internal;
 
     try {
@@ -191,8 +244,40 @@ token_database_snapshot::read_from_snapshot(snapshot_reader_ptr reader, token_da
         auto symbol_ids = std::vector<symbol_id_type>();
 
         read_reserved_tokens(reader, db, domains, symbol_ids);
-        read_tokens(reader, db, domains);
-        read_assets(reader, db, symbol_ids);        
+        read_tokens(reader, db, domains, thread_pool);
+        read_assets(reader, db, symbol_ids, thread_pool);
+    }
+    EVT_CAPTURE_AND_RETHROW(token_database_snapshot_exception);
+}
+
+void
+token_database_snapshot::add_delta_to_snapshot(snapshot_writer_ptr writer, const token_database& db) {
+    using namespace __internal;
+
+    try {
+        writer->write_section(delta_tokens_section, [&](auto& w) {
+            db.read_changed_tokens(make_delta_func(w, token_key_size));
+        });
+        writer->write_section(delta_assets_section, [&](auto& w) {
+            db.read_changed_assets(make_delta_func(w, asset_key_size));
+        });
+    }
+    EVT_CAPTURE_AND_RETHROW(token_database_snapshot_exception);
+}
+
+void
+token_database_snapshot::read_delta_from_snapshot(snapshot_reader_ptr reader, token_database& db) {
+    using namespace __internal;
+
+    try {
+        FC_ASSERT(db.savepoints_size() == 0);
+
+        reader->read_section(delta_tokens_section, [&](auto& r) {
+            db.apply_changed_tokens(make_bulk_func(r, token_key_size));
+        });
+        reader->read_section(delta_assets_section, [&](auto& r) {
+            db.apply_changed_assets(make_bulk_func(r, asset_key_size));
+        });
     }
     EVT_CAPTURE_AND_RETHROW(token_database_snapshot_exception);
 }
@@ -3,6 +3,7 @@
  *  @copyright defined in evt/LICENSE.txt
  */
 #include <algorithm>
+#include <cstring>
 #include <fc/bitutil.hpp>
 #include <fc/io/raw.hpp>
 #include <fc/smart_ref_impl.hpp>
@@ -56,8 +57,19 @@ transaction::get_signature_keys(const signatures_base_type& signatures, const ch
     }
 
     try {
-        auto digest = sig_digest(chain_id);
+        return recover_signature_keys(signatures, sig_digest(chain_id), allow_duplicate_keys);
+    }
+    FC_CAPTURE_AND_RETHROW()
+}
 
+public_keys_set
+transaction::recover_signature_keys(const signatures_base_type& signatures, const digest_type& digest,
+                                    bool allow_duplicate_keys) {
+    if(signatures.empty()) {
+        return public_keys_set();
+    }
+
+    try {
         auto recovered_pub_keys = public_keys_set();
         for(auto& sig : signatures) {
             auto successful_insertion                   = false;
@@ -116,6 +128,30 @@ packed_transaction::get_prunable_size() const {
     return static_cast<uint32_t>(size);
 }
 
+digest_type
+packed_transaction::sig_digest(const chain_id_type& chain_id) const {
+    if(!canonical_packed) {
+        return unpacked_trx.sig_digest(chain_id);
+    }
+
+    digest_type::encoder enc;
+    fc::raw::pack(enc, chain_id);
+    enc.write(packed_trx.data(), packed_trx.size());
+    return enc.result();
+}
+
+public_keys_set
+packed_transaction::get_signature_keys(const chain_id_type& chain_id, bool allow_duplicate_keys) const {
+    if(signatures.empty()) {
+        return public_keys_set();
+    }
+
+    try {
+        return transaction::recover_signature_keys(signatures, sig_digest(chain_id), allow_duplicate_keys);
+    }
+    FC_CAPTURE_AND_RETHROW()
+}
+
 digest_type
 packed_transaction::packed_digest() const {
     digest_type::encoder prunable;
@@ -174,20 +210,13 @@ zlib_decompress(const bytes& data) {
     }
 }
 
-static transaction
-zlib_decompress_transaction(const bytes& data) {
-    bytes out = zlib_decompress(data);
-    return unpack_transaction(out);
-}
-
 static bytes
 pack_transaction(const transaction& t) {
     return fc::raw::pack(t);
 }
 
 static bytes
-zlib_compress_transaction(const transaction& t) {
-    auto in   = pack_transaction(t);
+zlib_compress(const bytes& in) {
     auto out  = bytes();
     auto comp = bio::filtering_ostream();
 
@@ -200,13 +229,26 @@ zlib_compress_transaction(const transaction& t) {
 
 void
 packed_transaction::local_unpack_transaction() {
+    // lenient encodings (ex. overlong varints) are accepted by unpack but not reproduced by pack,
+    // even with the same size, so packed bytes are only used when they're exactly the repacked ones
+    auto unpack_and_hash = [this](const bytes& data) {
+        auto trx       = unpack_transaction(data);
+        auto repacked  = pack_transaction(trx);
+        auto canonical = (repacked.size() == data.size() && memcmp(repacked.data(), data.data(), data.size()) == 0);
+
+        trx_id       = transaction_id_type::hash(repacked.data(), repacked.size());
+        unpacked_trx = signed_transaction(std::move(trx), signatures);
+        return canonical;
+    };
+
     try {
         switch(compression) {
         case none:
-            unpacked_trx = signed_transaction(unpack_transaction(packed_trx), signatures);
+            canonical_packed = unpack_and_hash(packed_trx);
             break;
         case zlib:
-            unpacked_trx = signed_transaction(zlib_decompress_transaction(packed_trx), signatures);
+            unpack_and_hash(zlib_decompress(packed_trx));
+            canonical_packed = false;
             break;
         default:
             EVT_THROW(unknown_transaction_compression, "Unknown transaction compression algorithm");
@@ -220,11 +262,17 @@ packed_transaction::local_pack_transaction() {
     try {
         switch(compression) {
         case none:
-            packed_trx = pack_transaction(unpacked_trx);
+            packed_trx       = pack_transaction(unpacked_trx);
+            trx_id           = transaction_id_type::hash(packed_trx.data(), packed_trx.size());
+            canonical_packed = true;
             break;
-        case zlib:
-            packed_trx = zlib_compress_transaction(unpacked_trx);
+        case zlib: {
+            auto in          = pack_transaction(unpacked_trx);
+            trx_id           = transaction_id_type::hash(in.data(), in.size());
+            packed_trx       = zlib_compress(in);
+            canonical_packed = false;
             break;
+        }
         default:
             EVT_THROW(unknown_transaction_compression, "Unknown transaction compression algorithm");
         }
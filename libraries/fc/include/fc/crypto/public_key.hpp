@@ -49,6 +49,21 @@ private:
     friend class private_key;
 };  // public_key
 
+/**
+ * Recovered keys are kept in a process-wide cache keyed by the hash of (signature, digest),
+ * so recovering the same pair again is a lookup.
+ */
+struct recovery_cache_metrics {
+    uint64_t hit;
+    uint64_t miss;
+    size_t   size;
+    size_t   capacity;
+};
+
+// zero disables the cache, existing entries are dropped
+void                   set_recovery_cache_capacity(size_t capacity);
+recovery_cache_metrics get_recovery_cache_metrics();
+
 }}  // namespace fc::crypto
 
 namespace fc {
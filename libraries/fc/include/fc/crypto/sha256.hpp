@@ -1,10 +1,12 @@
 #pragma once
 #include <functional>
+#include <vector>
 #include <boost/functional/hash.hpp>
 #include <fc/fwd.hpp>
 #include <fc/string.hpp>
 #include <fc/platform_independence.hpp>
 #include <fc/io/raw_fwd.hpp>
+#include <fc/io/datastream.hpp>
 
 namespace fc {
 
@@ -31,6 +33,27 @@ public:
         return e.result();
     }
 
+    /**
+     * Hashes `n` independent messages, `results[i]` is the hash of `datas[i]` with `lens[i]` bytes.
+     * Multi-lane SIMD implementations are used when the CPU supports them.
+     */
+    static void hash_many(const char* const datas[], const uint32_t lens[], size_t n, sha256 results[]);
+
+    /**
+     * Hashes `n` messages in a batch, `packer(ds, i)` writes the i-th message into `ds`.
+     */
+    template<typename Packer>
+    static std::vector<sha256> hash_many(size_t n, Packer&& packer);
+
+    /**
+     * Hashes the packed form of each element in `c`, same as packing each one into an `encoder`.
+     */
+    template<typename Container>
+    static std::vector<sha256>
+    hash_many(const Container& c) {
+        return hash_many(c.size(), [&c](auto& ds, size_t i) { fc::raw::pack(ds, c[i]); });
+    }
+
     class encoder {
     public:
         encoder();
@@ -92,6 +115,32 @@ public:
     uint64_t _hash[4];
 };
 
+template<typename Packer>
+std::vector<sha256>
+sha256::hash_many(size_t n, Packer&& packer) {
+    // packs all the messages into one buffer after a sizing pass
+    auto offsets = std::vector<size_t>(n + 1);
+    for(auto i = 0u; i < n; i++) {
+        auto ss = fc::datastream<size_t>();
+        packer(ss, i);
+        offsets[i + 1] = offsets[i] + ss.tellp();
+    }
+
+    auto buf   = std::vector<char>(offsets[n]);
+    auto ds    = fc::datastream<char*>(buf.data(), buf.size());
+    auto datas = std::vector<const char*>(n);
+    auto lens  = std::vector<uint32_t>(n);
+    for(auto i = 0u; i < n; i++) {
+        datas[i] = buf.data() + offsets[i];
+        lens[i]  = (uint32_t)(offsets[i + 1] - offsets[i]);
+        packer(ds, i);
+    }
+
+    auto results = std::vector<sha256>(n);
+    hash_many(datas.data(), lens.data(), n, results.data());
+    return results;
+}
+
 typedef sha256 uint256;
 
 class variant;
@@ -0,0 +1,36 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace fc { namespace detail {
+
+/**
+ * Compresses `blocks` 64-bytes blocks of `data` into `state`,
+ * padding is handled by the caller.
+ */
+using sha256_compress_func = void (*)(uint32_t state[8], const uint8_t* data, size_t blocks);
+
+/**
+ * Returns the accelerated compress function detected by CPUID at runtime,
+ * or nullptr if there's none and openssl should be used.
+ */
+sha256_compress_func get_sha256_compress();
+
+/**
+ * Compresses one 64-bytes block for each of `lanes` independent messages,
+ * `states[i]` is updated with `data[i]`.
+ */
+using sha256_compress_multi_func = void (*)(uint32_t* const states[], const uint8_t* const data[]);
+
+struct sha256_compress_multi {
+    size_t                     lanes;
+    sha256_compress_multi_func func;
+};
+
+/**
+ * Returns the widest multi-lane compress function available at runtime,
+ * `lanes` is zero if there's none.
+ */
+sha256_compress_multi get_sha256_compress_multi();
+
+}}  // namespace fc::detail
@@ -2,6 +2,14 @@
 #include <fc/crypto/common.hpp>
 #include <fc/exception/exception.hpp>
 
+#include <fc/io/raw.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 namespace fc { namespace crypto {
 
 struct recovery_visitor : fc::visitor<public_key::storage_type> {
@@ -18,11 +26,154 @@ struct recovery_visitor : fc::visitor<public_key::storage_type> {
     bool          _check_canonical;
 };
 
+namespace detail {
+
+/**
+ * Sharded CLOCK cache of recovered keys,
+ * key is the sha256 of (signature, digest, check_canonical) so it cannot be forged by collisions
+ */
+class recovery_cache {
+public:
+    static constexpr size_t shards_num       = 16;
+    static constexpr size_t default_capacity = 64 * 1024;
+
+    using value_type = public_key::storage_type;
+
+public:
+    recovery_cache(size_t capacity) : hit_(0), miss_(0) { set_capacity(capacity); }
+
+public:
+    bool
+    get(const sha256& key, value_type& value) {
+        auto& s    = shard_of(key);
+        auto  lock = std::lock_guard<std::mutex>(s.mutex);
+
+        auto it = s.index.find(key);
+        if(it == s.index.end()) {
+            miss_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        auto& e      = s.slots[it->second];
+        e.referenced = true;
+        value        = e.value;
+        hit_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void
+    put(const sha256& key, const value_type& value) {
+        auto& s    = shard_of(key);
+        auto  lock = std::lock_guard<std::mutex>(s.mutex);
+
+        if(s.capacity == 0 || s.index.find(key) != s.index.end()) {
+            return;
+        }
+
+        auto pos = s.slots.size();
+        if(pos < s.capacity) {
+            s.slots.emplace_back(entry { .key = key, .value = value, .referenced = false });
+        }
+        else {
+            // sweep the hand until an entry not used since last pass is found
+            while(s.slots[s.hand].referenced) {
+                s.slots[s.hand].referenced = false;
+                s.hand = (s.hand + 1) % s.capacity;
+            }
+            pos = s.hand;
+            s.hand = (s.hand + 1) % s.capacity;
+
+            s.index.erase(s.slots[pos].key);
+            s.slots[pos] = entry { .key = key, .value = value, .referenced = false };
+        }
+        s.index.emplace(key, pos);
+    }
+
+    void
+    set_capacity(size_t capacity) {
+        for(auto& s : shards_) {
+            auto lock = std::lock_guard<std::mutex>(s.mutex);
+
+            s.capacity = (capacity + shards_num - 1) / shards_num;
+            s.hand     = 0;
+            s.slots.clear();
+            s.slots.shrink_to_fit();
+            s.index.clear();
+        }
+    }
+
+    recovery_cache_metrics
+    get_metrics() {
+        auto m = recovery_cache_metrics {
+            .hit      = hit_.load(std::memory_order_relaxed),
+            .miss     = miss_.load(std::memory_order_relaxed),
+            .size     = 0,
+            .capacity = 0
+        };
+        for(auto& s : shards_) {
+            auto lock = std::lock_guard<std::mutex>(s.mutex);
+            m.size += s.slots.size();
+            m.capacity += s.capacity;
+        }
+        return m;
+    }
+
+private:
+    struct entry {
+        sha256     key;
+        value_type value;
+        bool       referenced;
+    };
+
+    struct shard {
+        std::mutex                         mutex;
+        std::unordered_map<sha256, size_t> index;
+        std::vector<entry>                 slots;
+        size_t                             capacity = 0;
+        size_t                             hand     = 0;
+    };
+
+    shard&
+    shard_of(const sha256& key) {
+        return shards_[key._hash[1] % shards_num];
+    }
+
+private:
+    shard                 shards_[shards_num];
+    std::atomic<uint64_t> hit_;
+    std::atomic<uint64_t> miss_;
+};
+
+recovery_cache&
+get_recovery_cache() {
+    static auto cache = recovery_cache(recovery_cache::default_capacity);
+    return cache;
+}
+
+sha256
+get_recovery_cache_key(const signature& c, const sha256& digest, bool check_canonical) {
+    auto enc = sha256::encoder();
+    fc::raw::pack(enc, c);
+    fc::raw::pack(enc, digest);
+    fc::raw::pack(enc, check_canonical);
+    return enc.result();
+}
+
+}  // namespace detail
+
 public_key::public_key(const ecc::public_key_shim& ecc_key)
     : _storage(ecc_key) {}
 
-public_key::public_key(const signature& c, const sha256& digest, bool check_canonical)
-    : _storage(c._storage.visit(recovery_visitor(digest, check_canonical))) {}
+public_key::public_key(const signature& c, const sha256& digest, bool check_canonical) {
+    auto& cache = detail::get_recovery_cache();
+    auto  key   = detail::get_recovery_cache_key(c, digest, check_canonical);
+    if(cache.get(key, _storage)) {
+        return;
+    }
+
+    _storage = c._storage.visit(recovery_visitor(digest, check_canonical));
+    cache.put(key, _storage);
+}
 
 static public_key::storage_type
 parse_base58(const std::string& base58str) {
@@ -86,6 +237,16 @@ operator<(const public_key& p1, const public_key& p2) {
     return less_comparator<public_key::storage_type>::apply(p1._storage, p2._storage);
 }
 
+void
+set_recovery_cache_capacity(size_t capacity) {
+    detail::get_recovery_cache().set_capacity(capacity);
+}
+
+recovery_cache_metrics
+get_recovery_cache_metrics() {
+    return detail::get_recovery_cache().get_metrics();
+}
+
 }}  // namespace fc::crypto
 
 namespace fc {
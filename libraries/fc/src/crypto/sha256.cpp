@@ -3,11 +3,13 @@
 #include <fc/fwd_impl.hpp>
 #include <openssl/sha.h>
 #include <string.h>
+#include <array>
 #include <cmath>
 #include <fc/crypto/sha256.hpp>
 #include <fc/variant.hpp>
 #include <fc/exception/exception.hpp>
 #include "_digest_common.hpp"
+#include "_sha256_accel.hpp"
 
 namespace fc {
 
@@ -41,8 +43,56 @@ sha256::data() const {
     return (char*)&_hash[0];
 }
 
+namespace {
+
+struct accel_ctx {
+    uint32_t state[8];
+    uint8_t  buf[64];
+    uint64_t total;
+};
+
+const uint32_t sha256_iv[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+/**
+ * Builds the padded final blocks of a message with `total` bytes
+ * whose trailing partial block is `tail`, returns the number of blocks (1 or 2)
+ */
+size_t
+make_final_blocks(const uint8_t* tail, size_t tail_len, uint64_t total, uint8_t out[128]) {
+    auto bits   = total * 8;
+    auto blocks = (tail_len < 56) ? 1u : 2u;
+    auto end    = out + blocks * 64;
+
+    memcpy(out, tail, tail_len);
+    out[tail_len] = 0x80;
+    memset(out + tail_len + 1, 0, blocks * 64 - tail_len - 1 - 8);
+    for(auto i = 0; i < 8; i++) {
+        end[-1 - i] = (uint8_t)(bits >> (i * 8));
+    }
+    return blocks;
+}
+
+void
+store_digest(const uint32_t state[8], sha256& h) {
+    auto out = (uint8_t*)h.data();
+    for(auto i = 0; i < 8; i++) {
+        out[i * 4]     = (uint8_t)(state[i] >> 24);
+        out[i * 4 + 1] = (uint8_t)(state[i] >> 16);
+        out[i * 4 + 2] = (uint8_t)(state[i] >> 8);
+        out[i * 4 + 3] = (uint8_t)(state[i]);
+    }
+}
+
+}  // namespace
+
+// which one is used depends on whether accelerated compress function is available
 struct sha256::encoder::impl {
-    SHA256_CTX ctx;
+    union {
+        SHA256_CTX ctx;
+        accel_ctx  actx;
+    };
 };
 
 sha256::encoder::~encoder() {}
@@ -69,18 +119,145 @@ sha256::hash(const sha256& s) {
 
 void
 sha256::encoder::write(const char* d, uint32_t dlen) {
-    SHA256_Update(&my->ctx, d, dlen);
+    auto compress = detail::get_sha256_compress();
+    if(compress == nullptr) {
+        SHA256_Update(&my->ctx, d, dlen);
+        return;
+    }
+
+    auto& c    = my->actx;
+    auto  data = (const uint8_t*)d;
+    auto  used = c.total % 64;
+    c.total += dlen;
+
+    if(used > 0) {
+        auto n = std::min<size_t>(64 - used, dlen);
+        memcpy(c.buf + used, data, n);
+        if(used + n < 64) {
+            return;
+        }
+        compress(c.state, c.buf, 1);
+        data += n;
+        dlen -= n;
+    }
+    if(dlen >= 64) {
+        compress(c.state, data, dlen / 64);
+        data += dlen & ~63u;
+        dlen &= 63u;
+    }
+    memcpy(c.buf, data, dlen);
 }
 
 sha256
 sha256::encoder::result() {
     sha256 h;
-    SHA256_Final((uint8_t*)h.data(), &my->ctx);
+
+    auto compress = detail::get_sha256_compress();
+    if(compress == nullptr) {
+        SHA256_Final((uint8_t*)h.data(), &my->ctx);
+        return h;
+    }
+
+    auto& c = my->actx;
+
+    uint8_t final[128];
+    auto    blocks = make_final_blocks(c.buf, c.total % 64, c.total, final);
+    compress(c.state, final, blocks);
+
+    store_digest(c.state, h);
     return h;
 }
+
 void
 sha256::encoder::reset() {
-    SHA256_Init(&my->ctx);
+    if(detail::get_sha256_compress() == nullptr) {
+        SHA256_Init(&my->ctx);
+        return;
+    }
+
+    auto& c = my->actx;
+    memcpy(c.state, sha256_iv, sizeof(sha256_iv));
+    c.total = 0;
+}
+
+void
+sha256::hash_many(const char* const datas[], const uint32_t lens[], size_t n, sha256 results[]) {
+    auto multi = detail::get_sha256_compress_multi();
+    if(multi.lanes == 0 || n < 2) {
+        for(auto i = 0u; i < n; i++) {
+            results[i] = hash(datas[i], lens[i]);
+        }
+        return;
+    }
+
+    // each lane streams through the blocks of one message and picks up
+    // the next message when it's done, so messages can have different lengths
+    struct lane {
+        size_t         index;  // index of current message, `n` when idle
+        const uint8_t* data;
+        size_t         full;    // number of full blocks in `data`
+        size_t         blocks;  // number of blocks including the padded final ones
+        size_t         next;
+        uint8_t        final[128];
+        uint32_t       state[8];
+    };
+
+    static const uint8_t idle_block[64] = {};
+
+    auto lanes  = std::array<lane, 8>();
+    auto next   = 0u;
+    auto active = 0u;
+
+    auto load = [&](auto& l) {
+        if(next >= n) {
+            l.index = n;
+            return false;
+        }
+        l.index  = next++;
+        l.data   = (const uint8_t*)datas[l.index];
+        l.full   = lens[l.index] / 64;
+        l.blocks = l.full + make_final_blocks(l.data + l.full * 64, lens[l.index] % 64, lens[l.index], l.final);
+        l.next   = 0;
+        memcpy(l.state, sha256_iv, sizeof(sha256_iv));
+        return true;
+    };
+
+    uint32_t*      states[8];
+    const uint8_t* blocks[8];
+    for(auto i = 0u; i < multi.lanes; i++) {
+        states[i] = lanes[i].state;
+        if(load(lanes[i])) {
+            active++;
+        }
+    }
+
+    while(active > 0) {
+        for(auto i = 0u; i < multi.lanes; i++) {
+            auto& l = lanes[i];
+            if(l.index == n) {
+                blocks[i] = idle_block;
+            }
+            else if(l.next < l.full) {
+                blocks[i] = l.data + l.next * 64;
+            }
+            else {
+                blocks[i] = l.final + (l.next - l.full) * 64;
+            }
+        }
+
+        multi.func(states, blocks);
+
+        for(auto i = 0u; i < multi.lanes; i++) {
+            auto& l = lanes[i];
+            if(l.index == n || ++l.next < l.blocks) {
+                continue;
+            }
+            store_digest(l.state, results[l.index]);
+            if(!load(l)) {
+                active--;
+            }
+        }
+    }
 }
 
 sha256
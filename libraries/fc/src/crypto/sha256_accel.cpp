@@ -0,0 +1,291 @@
+#include "_sha256_accel.hpp"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define FC_SHA256_X86
+#endif
+
+namespace fc { namespace detail {
+
+#ifdef FC_SHA256_X86
+
+namespace {
+
+alignas(16) const uint32_t K256[] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+// sha256rnds2 works on the state in ABEF and CDGH orders
+struct shani_state {
+    __m128i abef;
+    __m128i cdgh;
+};
+
+__attribute__((target("sha,sse4.1")))
+inline shani_state
+load_shani_state(const uint32_t state[8]) {
+    auto tmp  = _mm_loadu_si128((const __m128i*)&state[0]);  // DCBA
+    auto efgh = _mm_loadu_si128((const __m128i*)&state[4]);  // HGFE
+    tmp       = _mm_shuffle_epi32(tmp, 0xb1);                // CDAB
+    efgh      = _mm_shuffle_epi32(efgh, 0x1b);               // EFGH
+
+    return shani_state {
+        .abef = _mm_alignr_epi8(tmp, efgh, 8),     // ABEF
+        .cdgh = _mm_blend_epi16(efgh, tmp, 0xf0)  // CDGH
+    };
+}
+
+__attribute__((target("sha,sse4.1")))
+inline void
+store_shani_state(uint32_t state[8], const shani_state& s) {
+    auto tmp  = _mm_shuffle_epi32(s.abef, 0x1b);  // FEBA
+    auto dchg = _mm_shuffle_epi32(s.cdgh, 0xb1);  // DCHG
+
+    _mm_storeu_si128((__m128i*)&state[0], _mm_blend_epi16(tmp, dchg, 0xf0));  // DCBA
+    _mm_storeu_si128((__m128i*)&state[4], _mm_alignr_epi8(dchg, tmp, 8));     // HGFE
+}
+
+__attribute__((target("sha,sse4.1")))
+inline __m128i
+shani_load_message(const uint8_t* data) {
+    const auto mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    return _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)data), mask);
+}
+
+__attribute__((target("sha,sse4.1")))
+inline __m128i
+shani_schedule(const __m128i w[], int i) {
+    auto t = _mm_add_epi32(_mm_sha256msg1_epu32(w[i - 4], w[i - 3]), _mm_alignr_epi8(w[i - 1], w[i - 2], 4));
+    return _mm_sha256msg2_epu32(t, w[i - 1]);
+}
+
+__attribute__((target("sha,sse4.1")))
+void
+sha256_compress_shani(uint32_t state[8], const uint8_t* data, size_t blocks) {
+    auto s = load_shani_state(state);
+
+    __m128i w[16];
+    while(blocks--) {
+        auto prev = s;
+
+#pragma GCC unroll 16
+        for(auto i = 0; i < 16; i++) {
+            w[i] = (i < 4) ? shani_load_message(data + i * 16) : shani_schedule(w, i);
+
+            auto msg = _mm_add_epi32(w[i], _mm_load_si128((const __m128i*)&K256[i * 4]));
+            s.cdgh   = _mm_sha256rnds2_epu32(s.cdgh, s.abef, msg);
+            s.abef   = _mm_sha256rnds2_epu32(s.abef, s.cdgh, _mm_shuffle_epi32(msg, 0x0e));
+        }
+
+        s.abef = _mm_add_epi32(s.abef, prev.abef);
+        s.cdgh = _mm_add_epi32(s.cdgh, prev.cdgh);
+        data += 64;
+    }
+
+    store_shani_state(state, s);
+}
+
+// two messages interleaved to hide the latency of sha256rnds2
+__attribute__((target("sha,sse4.1")))
+void
+sha256_compress_x2_shani(uint32_t* const states[], const uint8_t* const data[]) {
+    auto x  = load_shani_state(states[0]);
+    auto y  = load_shani_state(states[1]);
+    auto px = x;
+    auto py = y;
+
+    __m128i wx[16], wy[16];
+
+#pragma GCC unroll 16
+    for(auto i = 0; i < 16; i++) {
+        wx[i] = (i < 4) ? shani_load_message(data[0] + i * 16) : shani_schedule(wx, i);
+        wy[i] = (i < 4) ? shani_load_message(data[1] + i * 16) : shani_schedule(wy, i);
+
+        auto k  = _mm_load_si128((const __m128i*)&K256[i * 4]);
+        auto mx = _mm_add_epi32(wx[i], k);
+        auto my = _mm_add_epi32(wy[i], k);
+
+        x.cdgh = _mm_sha256rnds2_epu32(x.cdgh, x.abef, mx);
+        y.cdgh = _mm_sha256rnds2_epu32(y.cdgh, y.abef, my);
+        x.abef = _mm_sha256rnds2_epu32(x.abef, x.cdgh, _mm_shuffle_epi32(mx, 0x0e));
+        y.abef = _mm_sha256rnds2_epu32(y.abef, y.cdgh, _mm_shuffle_epi32(my, 0x0e));
+    }
+
+    x.abef = _mm_add_epi32(x.abef, px.abef);
+    x.cdgh = _mm_add_epi32(x.cdgh, px.cdgh);
+    y.abef = _mm_add_epi32(y.abef, py.abef);
+    y.cdgh = _mm_add_epi32(y.cdgh, py.cdgh);
+
+    store_shani_state(states[0], x);
+    store_shani_state(states[1], y);
+}
+
+#define ROR32X8(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+
+// eight messages in the 32-bits lanes of ymm registers, one word of each message per register
+__attribute__((target("avx2")))
+void
+sha256_compress_x8_avx2(uint32_t* const states[], const uint8_t* const data[]) {
+    const auto bswap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                                       12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+    __m256i w[16];
+    for(auto i = 0; i < 16; i++) {
+        alignas(32) uint32_t t[8];
+        for(auto l = 0; l < 8; l++) {
+            memcpy(&t[l], data[l] + i * 4, 4);
+        }
+        w[i] = _mm256_shuffle_epi8(_mm256_load_si256((const __m256i*)t), bswap);
+    }
+
+    __m256i s[8];
+    for(auto i = 0; i < 8; i++) {
+        alignas(32) uint32_t t[8];
+        for(auto l = 0; l < 8; l++) {
+            t[l] = states[l][i];
+        }
+        s[i] = _mm256_load_si256((const __m256i*)t);
+    }
+
+    auto a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+
+#pragma GCC unroll 64
+    for(auto i = 0; i < 64; i++) {
+        if(i >= 16) {
+            auto w15 = w[(i - 15) & 15];
+            auto w2  = w[(i - 2) & 15];
+            auto s0  = _mm256_xor_si256(_mm256_xor_si256(ROR32X8(w15, 7), ROR32X8(w15, 18)), _mm256_srli_epi32(w15, 3));
+            auto s1  = _mm256_xor_si256(_mm256_xor_si256(ROR32X8(w2, 17), ROR32X8(w2, 19)), _mm256_srli_epi32(w2, 10));
+
+            w[i & 15] = _mm256_add_epi32(_mm256_add_epi32(w[i & 15], s0), _mm256_add_epi32(w[(i - 7) & 15], s1));
+        }
+
+        auto S1  = _mm256_xor_si256(_mm256_xor_si256(ROR32X8(e, 6), ROR32X8(e, 11)), ROR32X8(e, 25));
+        auto ch  = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        auto kw  = _mm256_add_epi32(_mm256_set1_epi32(K256[i]), w[i & 15]);
+        auto t1  = _mm256_add_epi32(_mm256_add_epi32(h, S1), _mm256_add_epi32(ch, kw));
+        auto S0  = _mm256_xor_si256(_mm256_xor_si256(ROR32X8(a, 2), ROR32X8(a, 13)), ROR32X8(a, 22));
+        auto maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(t1, _mm256_add_epi32(S0, maj));
+    }
+
+    s[0] = _mm256_add_epi32(s[0], a);
+    s[1] = _mm256_add_epi32(s[1], b);
+    s[2] = _mm256_add_epi32(s[2], c);
+    s[3] = _mm256_add_epi32(s[3], d);
+    s[4] = _mm256_add_epi32(s[4], e);
+    s[5] = _mm256_add_epi32(s[5], f);
+    s[6] = _mm256_add_epi32(s[6], g);
+    s[7] = _mm256_add_epi32(s[7], h);
+
+    for(auto i = 0; i < 8; i++) {
+        alignas(32) uint32_t t[8];
+        _mm256_store_si256((__m256i*)t, s[i]);
+        for(auto l = 0; l < 8; l++) {
+            states[l][i] = t[l];
+        }
+    }
+}
+
+#undef ROR32X8
+
+bool
+has_shani() {
+    unsigned int eax, ebx, ecx, edx;
+    if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    auto sse41 = (ecx & bit_SSE4_1) != 0;
+    auto ssse3 = (ecx & bit_SSSE3) != 0;
+
+    if(!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    auto sha = (ebx & (1u << 29)) != 0;
+
+    return sse41 && ssse3 && sha;
+}
+
+bool
+has_avx2() {
+    unsigned int eax, ebx, ecx, edx;
+    if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    // make sure the OS saves the ymm registers
+    auto osxsave = (ecx & bit_OSXSAVE) != 0;
+    if(!osxsave) {
+        return false;
+    }
+    uint32_t xcr0_lo, xcr0_hi;
+    __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    if((xcr0_lo & 0x6) != 0x6) {
+        return false;
+    }
+
+    if(!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return (ebx & bit_AVX2) != 0;
+}
+
+}  // namespace
+
+#endif  // FC_SHA256_X86
+
+sha256_compress_func
+get_sha256_compress() {
+    static auto func = []() -> sha256_compress_func {
+        // FC_SHA256_NO_ACCEL can be set to fallback to openssl for comparison
+        if(getenv("FC_SHA256_NO_ACCEL") != nullptr) {
+            return nullptr;
+        }
+#ifdef FC_SHA256_X86
+        if(has_shani()) {
+            return &sha256_compress_shani;
+        }
+#endif
+        return nullptr;
+    }();
+    return func;
+}
+
+sha256_compress_multi
+get_sha256_compress_multi() {
+    static auto multi = []() -> sha256_compress_multi {
+        if(getenv("FC_SHA256_NO_ACCEL") != nullptr) {
+            return { 0, nullptr };
+        }
+#ifdef FC_SHA256_X86
+        // dedicated sha instructions beat 8 lanes of avx2 when present
+        if(has_shani()) {
+            return { 2, &sha256_compress_x2_shani };
+        }
+        if(has_avx2()) {
+            return { 8, &sha256_compress_x8_avx2 };
+        }
+#endif
+        return { 0, nullptr };
+    }();
+    return multi;
+}
+
+}}  // namespace fc::detail
@@ -45,6 +45,41 @@ BOOST_AUTO_TEST_CASE(test_k1_recovery) try {
    BOOST_CHECK_EQUAL(std::string(recovered_pub), std::string(pub));
 } FC_LOG_AND_RETHROW();
 
+BOOST_AUTO_TEST_CASE(test_k1_recovery_cache) try {
+   set_recovery_cache_capacity(32);
+
+   auto key    = private_key::generate<ecc::private_key_shim>();
+   auto digest = sha256::hash(std::string("cache"));
+   auto sig    = key.sign(digest);
+
+   auto m0 = get_recovery_cache_metrics();
+   BOOST_CHECK_EQUAL(m0.capacity, 32u);
+
+   auto pub1 = public_key(sig, digest);
+   auto pub2 = public_key(sig, digest);
+   BOOST_CHECK(pub1 == key.get_public_key());
+   BOOST_CHECK(pub2 == key.get_public_key());
+
+   auto m1 = get_recovery_cache_metrics();
+   BOOST_CHECK_EQUAL(m1.miss - m0.miss, 1u);
+   BOOST_CHECK_EQUAL(m1.hit - m0.hit, 1u);
+
+   // same signature over other digest is a different entry
+   auto digest2 = sha256::hash(std::string("cache2"));
+   BOOST_CHECK(public_key(sig, digest2) != key.get_public_key());
+
+   // stays bounded and correct when entries are evicted
+   for(auto i = 0; i < 100; i++) {
+      auto k = private_key::generate<ecc::private_key_shim>();
+      auto d = sha256::hash(std::to_string(i));
+      BOOST_CHECK(public_key(k.sign(d), d) == k.get_public_key());
+   }
+   BOOST_CHECK_LE(get_recovery_cache_metrics().size, 32u);
+   BOOST_CHECK(public_key(sig, digest) == key.get_public_key());
+
+   set_recovery_cache_capacity(64 * 1024);
+} FC_LOG_AND_RETHROW();
+
 // BOOST_AUTO_TEST_CASE(test_r1_recovery) try {
 //    auto payload = "Test Cases";
 //    auto digest = sha256::hash(payload, const_strlen(payload));
@@ -0,0 +1,96 @@
+#define BOOST_TEST_MODULE sha256 test
+#define BOOST_TEST_DYN_LINK
+
+#include <random>
+#include <boost/test/unit_test.hpp>
+#include <openssl/sha.h>
+
+#include <fc/crypto/sha256.hpp>
+#include <fc/exception/exception.hpp>
+
+using namespace fc;
+
+namespace {
+
+sha256
+openssl_hash(const char* d, size_t len) {
+   sha256 h;
+   SHA256((const uint8_t*)d, len, (uint8_t*)h.data());
+   return h;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(sha256_suite)
+BOOST_AUTO_TEST_CASE(test_known_vectors) try {
+   BOOST_CHECK_EQUAL(sha256::hash("", 0).str(), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+   BOOST_CHECK_EQUAL(sha256::hash("abc", 3).str(), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+
+   auto str = std::string("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq");
+   BOOST_CHECK_EQUAL(sha256::hash(str).str(), "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+} FC_LOG_AND_RETHROW();
+
+BOOST_AUTO_TEST_CASE(test_against_openssl) try {
+   auto dre = std::default_random_engine(2019);
+   auto buf = std::string();
+   for(auto i = 0; i < 1024; i++) {
+      buf.push_back((char)dre());
+   }
+
+   for(auto len = 0u; len <= buf.size(); len++) {
+      auto expected = openssl_hash(buf.data(), len);
+      BOOST_CHECK_EQUAL(sha256::hash(buf.data(), len).str(), expected.str());
+
+      // feed in uneven chunks to exercise partial block buffering
+      for(auto chunk : { 1u, 7u, 63u, 64u, 65u }) {
+         auto enc = sha256::encoder();
+         for(auto off = 0u; off < len; off += chunk) {
+            enc.write(buf.data() + off, std::min(chunk, (uint32_t)(len - off)));
+         }
+         BOOST_CHECK_EQUAL(enc.result().str(), expected.str());
+      }
+   }
+} FC_LOG_AND_RETHROW();
+
+BOOST_AUTO_TEST_CASE(test_reset) try {
+   auto enc = sha256::encoder();
+   enc.write("garbage", 7);
+   enc.reset();
+   enc.write("abc", 3);
+   BOOST_CHECK_EQUAL(enc.result().str(), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+} FC_LOG_AND_RETHROW();
+
+BOOST_AUTO_TEST_CASE(test_hash_many) try {
+   auto dre  = std::default_random_engine(2019);
+   auto msgs = std::vector<std::string>();
+   for(auto i = 0; i < 300; i++) {
+      auto len = (i < 150) ? i : dre() % 1000;
+      auto str = std::string();
+      for(auto j = 0u; j < len; j++) {
+         str.push_back((char)dre());
+      }
+      msgs.emplace_back(std::move(str));
+   }
+
+   // every batch size to cover partially filled lanes
+   for(auto n = 0u; n <= 20; n++) {
+      auto datas = std::vector<const char*>();
+      auto lens  = std::vector<uint32_t>();
+      for(auto i = 0u; i < n; i++) {
+         datas.push_back(msgs[i].data());
+         lens.push_back(msgs[i].size());
+      }
+      auto results = std::vector<sha256>(n);
+      sha256::hash_many(datas.data(), lens.data(), n, results.data());
+      for(auto i = 0u; i < n; i++) {
+         BOOST_CHECK_EQUAL(results[i].str(), openssl_hash(msgs[i].data(), msgs[i].size()).str());
+      }
+   }
+
+   auto results = sha256::hash_many(msgs.size(), [&](auto& ds, size_t i) { ds.write(msgs[i].data(), msgs[i].size()); });
+   for(auto i = 0u; i < msgs.size(); i++) {
+      BOOST_CHECK_EQUAL(results[i].str(), openssl_hash(msgs[i].data(), msgs[i].size()).str());
+   }
+} FC_LOG_AND_RETHROW();
+
+BOOST_AUTO_TEST_SUITE_END()
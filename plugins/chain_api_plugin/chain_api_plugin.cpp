@@ -125,7 +125,8 @@ chain_api_plugin::plugin_startup() {
                           CHAIN_RW_CALL_ASYNC(push_block, chain_apis::read_write::push_block_results, 202),
                           CHAIN_RW_CALL_ASYNC(push_transaction, chain_apis::read_write::push_transaction_results, 202),
                           CHAIN_RW_CALL_ASYNC(push_transactions, chain_apis::read_write::push_transactions_results, 202)});
-    _http_plugin.add_api({CHAIN_RO_CALL(get_db_info, 200)}, true /* local only API */);
+    _http_plugin.add_api({CHAIN_RO_CALL(get_db_info, 200),
+                          CHAIN_RO_CALL(get_metrics, 200)}, true /* local only API */);
 }
 
 void
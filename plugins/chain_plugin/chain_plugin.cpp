@@ -6,6 +6,7 @@
 
 #include <signal.h>
 #include <stdlib.h>
+#include <sstream>
 
 #include <boost/signals2/connection.hpp>
 
@@ -20,6 +21,7 @@
 #include <evt/chain/types.hpp>
 #include <evt/chain/genesis_state.hpp>
 #include <evt/chain/snapshot.hpp>
+#include <evt/chain/token_database_cache.hpp>
 #include <evt/chain/contracts/evt_contract_abi.hpp>
 #include <evt/chain/contracts/evt_link.hpp>
 #include <evt/chain/contracts/evt_link_object.hpp>
@@ -153,6 +155,43 @@ validate(boost::any&                     v,
     }
 }
 
+std::ostream&
+operator<<(std::ostream& osm, evt::chain::compaction_style m) {
+    if(m == evt::chain::compaction_style::universal) {
+        osm << "universal";
+    }
+    else if(m == evt::chain::compaction_style::level) {
+        osm << "level";
+    }
+
+    return osm;
+}
+
+void
+validate(boost::any&                     v,
+         const std::vector<std::string>& values,
+         evt::chain::compaction_style* /* target_type */,
+         int) {
+    using namespace boost::program_options;
+
+    // Make sure no previous assignment to 'v' was made.
+    validators::check_first_occurrence(v);
+
+    // Extract the first string from 'values'. If there is more than
+    // one string, it's an error, and exception will be thrown.
+    std::string const& s = validators::get_single_string(values);
+
+    if(s == "universal") {
+        v = boost::any(evt::chain::compaction_style::universal);
+    }
+    else if(s == "level") {
+        v = boost::any(evt::chain::compaction_style::level);
+    }
+    else {
+        throw validation_error(validation_error::invalid_option_value);
+    }
+}
+
 }  // namespace chain
 
 using namespace evt;
@@ -206,6 +245,7 @@ public:
     std::optional<controller>         chain;
     std::optional<chain_id_type>      chain_id;
     std::optional<bfs::path>          snapshot_path;
+    std::vector<bfs::path>            snapshot_delta_paths;
 
     // retained references to channels for easy publication
     channels::pre_accepted_block::channel_type&    pre_accepted_block_channel;
@@ -240,6 +280,7 @@ chain_plugin::chain_plugin()
     app().register_config_type<evt::chain::db_read_mode>();
     app().register_config_type<evt::chain::validation_mode>();
     app().register_config_type<evt::chain::storage_profile>();
+    app().register_config_type<evt::chain::compaction_style>();
 }
 
 chain_plugin::~chain_plugin() {}
@@ -250,11 +291,28 @@ chain_plugin::set_program_options(options_description& cli, options_description&
         ("blocks-dir", bpo::value<bfs::path>()->default_value("blocks"), "the location of the blocks directory (absolute path or relative to application data dir)")
         ("token-db-dir", bpo::value<bfs::path>()->default_value("tokendb"), "the location of the token database directory (absolute path or relative to application data dir)")
         ("token-db-cache-size-mb", bpo::value<uint32_t>()->default_value(512), "the cache size of token database in MBytes")
+        ("signature-cache-size", bpo::value<uint32_t>()->default_value(64 * 1024), "the number of recovered public keys cached by (signature, digest), 0 to disable")
         ("token-db-profile", boost::program_options::value<evt::chain::storage_profile>()->default_value(evt::chain::storage_profile::disk),
             "Token database profile (\"disk\", or \"memory\").\n"
             "In \"disk\" profile database is optimized for the standard storage devices.\n"
             "In \"memory\" mode database is optimized for the usage in ultra-low latency devices like memory\n"
         )
+        ("token-db-preset", bpo::value<string>(),
+            "Preset of token database tuning for the role of node (\"producer\", \"api-node\", or \"archive\").\n"
+            "In \"producer\" preset writes are kept cheap and compaction io is throttled.\n"
+            "In \"api-node\" preset database is optimized for reads.\n"
+            "In \"archive\" preset memory is bounded for large database and page cache is bypassed.\n"
+            "Other token-db options override the preset.\n"
+        )
+        ("token-db-compaction", bpo::value<evt::chain::compaction_style>(), "Compaction style of token database (\"universal\" or \"level\"), default is \"universal\"")
+        ("token-db-partitioned-index", bpo::value<bool>(), "Use partitioned index and filters in token database to bound their memory, default is false, only for \"disk\" profile")
+        ("token-db-memtable-budget-mb", bpo::value<uint32_t>(), "Memtable budget of each column family in token database in MBytes, default is 512")
+        ("token-db-write-buffer-limit-mb", bpo::value<uint32_t>(), "Limit of memtables in all column families of token database in MBytes, default is 0 (no limit)")
+        ("token-db-rate-limit-mb", bpo::value<uint32_t>(), "Rate limit of flush and compaction in token database in MBytes per second, default is 0 (no limit)")
+        ("token-db-direct-io", bpo::value<bool>(), "Bypass page cache for reads, flush and compaction of token database, default is false, only for \"disk\" profile")
+        ("token-db-background-jobs", bpo::value<int>(), "Number of background flush and compaction jobs of token database, default is 2")
+        ("delta-snapshots", bpo::bool_switch()->default_value(false), "Track changes of token database since latest snapshot so that delta snapshots can be taken, implied by --snapshot-delta")
+        ("token-db-address-index", bpo::bool_switch()->default_value(false), "Maintain the index of assets by address in token database, which enables reading all the balances of one address")
         ("checkpoint", bpo::value<vector<string>>()->composing(), "Pairs of [BLOCK_NUM,BLOCK_ID] that should be enforced as checkpoints.")
         ("abi-serializer-max-time-ms", bpo::value<uint32_t>()->default_value(config::default_abi_serializer_max_time_ms), "Override default maximum ABI serialization time allowed in ms")
         ("chain-state-db-size-mb", bpo::value<uint64_t>()->default_value(config::default_state_size / (1024 * 1024)), "Maximum size (in MiB) of the chain state database")
@@ -262,6 +320,7 @@ chain_plugin::set_program_options(options_description& cli, options_description&
         ("reversible-blocks-db-size-mb", bpo::value<uint64_t>()->default_value(config::default_reversible_cache_size / (1024 * 1024)), "Maximum size (in MiB) of the reversible blocks database")
         ("reversible-blocks-db-guard-size-mb", bpo::value<uint64_t>()->default_value(config::default_reversible_guard_size / (1024 * 1024)), "Safely shut down node when free space remaining in the reverseible blocks database drops below this size (in MiB).")
         ("contracts-console", bpo::bool_switch()->default_value(false), "print contract's output to console")
+        ("chain-threads", bpo::value<uint16_t>()->default_value(config::default_controller_thread_pool_size), "Number of worker threads in controller thread pool")
         ("read-mode", boost::program_options::value<evt::chain::db_read_mode>()->default_value(evt::chain::db_read_mode::SPECULATIVE),
             "Database read mode (\"speculative\", \"head\", or \"read-only\").\n"// or \"irreversible\").\n"
             "In \"speculative\" mode database contains changes done up to the head block plus changes made by transactions not yet included to the blockchain.\n"
@@ -294,6 +353,7 @@ chain_plugin::set_program_options(options_description& cli, options_description&
         ("export-reversible-blocks", bpo::value<bfs::path>(), "export reversible block database in portable format into specified file and then exit")
         ("trusted-producer", bpo::value<vector<string>>()->composing(), "Indicate a producer whose blocks headers signed by it will be fully validated, but transactions in those validated blocks will be trusted.")
         ("snapshot", bpo::value<bfs::path>(), "File to read Snapshot State from")
+        ("snapshot-delta", bpo::value<vector<bfs::path>>()->composing(), "Delta snapshot files to apply upon the snapshot in order, requires --snapshot")
         ;
 }
 
@@ -304,6 +364,39 @@ chain_plugin::set_program_options(options_description& cli, options_description&
     }
 
 
+void
+apply_token_db_preset(token_database::config& cfg, const std::string& preset) {
+    const auto MB = 1024 * 1024ull;
+
+    if(preset == "producer") {
+        // writes are on the path of producing blocks, universal compaction has less write amplification
+        // and compaction io is throttled to not stall them
+        cfg.compaction          = compaction_style::universal;
+        cfg.memtable_budget     = 1024 * MB;
+        cfg.rate_limit          = 64 * MB;
+        cfg.max_background_jobs = 4;
+    }
+    else if(preset == "api-node") {
+        // reads dominate, level compaction keeps less sorted runs to look up
+        cfg.compaction          = compaction_style::level;
+        cfg.memtable_budget     = 512 * MB;
+        cfg.max_background_jobs = 4;
+    }
+    else if(preset == "archive") {
+        // database is much larger than memory, bound the memory of index, filters and memtables
+        cfg.compaction          = compaction_style::level;
+        cfg.partitioned_index   = true;
+        cfg.memtable_budget     = 256 * MB;
+        cfg.write_buffer_limit  = 512 * MB;
+        cfg.rate_limit          = 32 * MB;
+        cfg.use_direct_io       = true;
+        cfg.max_background_jobs = 2;
+    }
+    else {
+        EVT_THROW(plugin_config_exception, "Unknown token database preset: ${p}", ("p", preset));
+    }
+}
+
 fc::time_point
 calculate_genesis_timestamp(string tstr) {
     fc::time_point genesis_timestamp;
@@ -410,10 +503,43 @@ chain_plugin::plugin_initialize(const variables_map& options) {
             my->chain_config->db_config.object_cache_size = sz;
         }
 
+        if(options.count("signature-cache-size")) {
+            fc::crypto::set_recovery_cache_capacity(options.at("signature-cache-size").as<uint32_t>());
+        }
+
         if(options.count("token-db-profile")) {
             my->chain_config->db_config.profile = options.at("token-db-profile").as<storage_profile>();
         }
 
+        auto& db_config = my->chain_config->db_config;
+        if(options.count("token-db-preset")) {
+            apply_token_db_preset(db_config, options.at("token-db-preset").as<string>());
+        }
+        if(options.count("token-db-compaction")) {
+            db_config.compaction = options.at("token-db-compaction").as<compaction_style>();
+        }
+        if(options.count("token-db-partitioned-index")) {
+            db_config.partitioned_index = options.at("token-db-partitioned-index").as<bool>();
+        }
+        if(options.count("token-db-memtable-budget-mb")) {
+            db_config.memtable_budget = (uint64_t)options.at("token-db-memtable-budget-mb").as<uint32_t>() * 1024 * 1024;
+        }
+        if(options.count("token-db-write-buffer-limit-mb")) {
+            db_config.write_buffer_limit = (uint64_t)options.at("token-db-write-buffer-limit-mb").as<uint32_t>() * 1024 * 1024;
+        }
+        if(options.count("token-db-rate-limit-mb")) {
+            db_config.rate_limit = (uint64_t)options.at("token-db-rate-limit-mb").as<uint32_t>() * 1024 * 1024;
+        }
+        if(options.count("token-db-direct-io")) {
+            db_config.use_direct_io = options.at("token-db-direct-io").as<bool>();
+        }
+        if(options.count("token-db-background-jobs")) {
+            db_config.max_background_jobs = options.at("token-db-background-jobs").as<int>();
+            EVT_ASSERT(db_config.max_background_jobs > 0, plugin_config_exception,
+                       "token-db-background-jobs ${num} must be greater than 0", ("num", db_config.max_background_jobs));
+        }
+        db_config.address_index = options.at("token-db-address-index").as<bool>();
+
         if(options.count("chain-state-db-size-mb")) {
             my->chain_config->state_size = options.at("chain-state-db-size-mb").as<uint64_t>() * 1024 * 1024;
         }
@@ -435,6 +561,13 @@ chain_plugin::plugin_initialize(const variables_map& options) {
         my->chain_config->loadtest_mode       = options.at("loadtest-mode").as<bool>();
         my->chain_config->charge_free_mode    = options.at("charge-free-mode").as<bool>();
         my->chain_config->contracts_console   = options.at("contracts-console").as<bool>();
+        my->chain_config->delta_snapshots     = options.at("delta-snapshots").as<bool>() || options.count("snapshot-delta");
+
+        if(options.count("chain-threads")) {
+            my->chain_config->thread_pool_size = options.at("chain-threads").as<uint16_t>();
+            EVT_ASSERT(my->chain_config->thread_pool_size > 0, plugin_config_exception,
+                       "chain-threads ${num} must be greater than 0", ("num", my->chain_config->thread_pool_size));
+        }
 
         if(options.count("extract-genesis-json") || options.at("print-genesis-json").as<bool>()) {
             genesis_state gs;
@@ -559,7 +692,7 @@ chain_plugin::plugin_initialize(const variables_map& options) {
 
             // recover genesis information from the snapshot
             auto infile = std::ifstream(my->snapshot_path->generic_string(), (std::ios::in | std::ios::binary));
-            auto reader = std::make_shared<istream_snapshot_reader>(infile);
+            auto reader = make_snapshot_reader(infile);
             reader->validate();
             reader->read_section<genesis_state>([this](auto& section) {
                 section.read_row(my->chain_config->genesis);
@@ -581,8 +714,19 @@ chain_plugin::plugin_initialize(const variables_map& options) {
                            plugin_config_exception,
                            "Genesis information in blocks.log does not match genesis information in the snapshot");
             }
+
+            if(options.count("snapshot-delta")) {
+                my->snapshot_delta_paths = options.at("snapshot-delta").as<vector<bfs::path>>();
+                for(auto& path : my->snapshot_delta_paths) {
+                    EVT_ASSERT(fc::exists(path), plugin_config_exception,
+                               "Cannot load delta snapshot, ${name} does not exist", ("name", path.generic_string()));
+                }
+            }
         }
         else {
+            EVT_ASSERT(options.count("snapshot-delta") == 0, plugin_config_exception,
+                       "--snapshot-delta can only be used together with --snapshot");
+
             auto genesis_file                = bfs::path();
             bool genesis_timestamp_specified = false;
             auto existing_genesis            = std::optional<genesis_state>();
@@ -723,8 +867,17 @@ chain_plugin::plugin_startup() {
         try {
             if(my->snapshot_path) {
                 auto infile = std::ifstream(my->snapshot_path->generic_string(), (std::ios::in | std::ios::binary));
-                auto reader = std::make_shared<istream_snapshot_reader>(infile);
-                my->chain->startup(reader);
+                auto reader = make_snapshot_reader(infile);
+
+                auto delta_files = std::vector<std::ifstream>();
+                auto deltas      = std::vector<snapshot_reader_ptr>();
+                delta_files.reserve(my->snapshot_delta_paths.size());
+                for(auto& path : my->snapshot_delta_paths) {
+                    delta_files.emplace_back(path.generic_string(), (std::ios::in | std::ios::binary));
+                    deltas.emplace_back(make_snapshot_reader(delta_files.back()));
+                }
+
+                my->chain->startup(reader, deltas);
                 infile.close();
             }
             else {
@@ -1464,5 +1617,69 @@ read_only::get_db_info(const get_db_info_params&) const {
     return db.token_db().stats();
 }
 
+std::string
+read_only::get_metrics(const get_metrics_params&) const {
+    auto m  = db.token_db().get_metrics();
+    auto cm = db.token_db_cache().get_metrics();
+    auto os = std::ostringstream();
+
+    auto metric = [&](auto name, auto type, auto help, auto value) {
+        os << "# HELP evt_tokendb_" << name << " " << help << "\n";
+        os << "# TYPE evt_tokendb_" << name << " " << type << "\n";
+        os << "evt_tokendb_" << name << " " << value << "\n";
+    };
+    auto summary = [&](auto name, auto help, auto& h) {
+        os << "# HELP evt_tokendb_" << name << " " << help << "\n";
+        os << "# TYPE evt_tokendb_" << name << " summary\n";
+        os << "evt_tokendb_" << name << "{quantile=\"0.5\"} " << h.p50 << "\n";
+        os << "evt_tokendb_" << name << "{quantile=\"0.95\"} " << h.p95 << "\n";
+        os << "evt_tokendb_" << name << "{quantile=\"0.99\"} " << h.p99 << "\n";
+        os << "evt_tokendb_" << name << "{quantile=\"1\"} " << h.max << "\n";
+        os << "evt_tokendb_" << name << "_sum " << h.sum << "\n";
+        os << "evt_tokendb_" << name << "_count " << h.count << "\n";
+    };
+
+    metric("stats_enabled", "gauge", "Whether rocksdb statistics are enabled", (int)m.stats_enabled);
+    if(m.stats_enabled) {
+        metric("block_cache_hit_total", "counter", "Block cache hits", m.block_cache_hit);
+        metric("block_cache_miss_total", "counter", "Block cache misses", m.block_cache_miss);
+        metric("memtable_hit_total", "counter", "Memtable hits", m.memtable_hit);
+        metric("memtable_miss_total", "counter", "Memtable misses", m.memtable_miss);
+        metric("keys_read_total", "counter", "Keys read from rocksdb", m.keys_read);
+        metric("keys_written_total", "counter", "Keys written into rocksdb", m.keys_written);
+        metric("read_bytes_total", "counter", "Bytes read from rocksdb", m.bytes_read);
+        metric("written_bytes_total", "counter", "Bytes written into rocksdb", m.bytes_written);
+        metric("compact_read_bytes_total", "counter", "Bytes read by compaction", m.compact_read_bytes);
+        metric("compact_written_bytes_total", "counter", "Bytes written by compaction", m.compact_write_bytes);
+        metric("stall_micros_total", "counter", "Microseconds writes are stalled by compaction", m.stall_micros);
+        summary("get_micros", "Latency of get in microseconds", m.get_micros);
+        summary("write_micros", "Latency of write in microseconds", m.write_micros);
+        summary("seek_micros", "Latency of seek in microseconds", m.seek_micros);
+    }
+    metric("estimate_keys", "gauge", "Estimated number of keys", m.estimate_keys);
+    metric("memtables_bytes", "gauge", "Size of all memtables", m.memtables_size);
+    metric("pending_compaction_bytes", "gauge", "Estimated bytes to be rewritten by compaction", m.pending_compaction_bytes);
+    metric("savepoints", "gauge", "Number of savepoints", m.savepoints);
+    metric("write_cache_keys", "gauge", "Keys in write caches of savepoints", m.write_cache_keys);
+    metric("flushing_keys", "gauge", "Irreversible keys not durable yet", m.flushing_keys);
+    metric("object_cache_hit_total", "counter", "Object cache hits", cm.hit);
+    metric("object_cache_miss_total", "counter", "Object cache misses", cm.miss);
+    metric("object_cache_usage_bytes", "gauge", "Usage of object cache", cm.usage);
+    metric("object_cache_capacity_bytes", "gauge", "Capacity of object cache", cm.capacity);
+
+    auto rm = fc::crypto::get_recovery_cache_metrics();
+    auto sig_metric = [&](auto name, auto type, auto help, auto value) {
+        os << "# HELP evt_sigcache_" << name << " " << help << "\n";
+        os << "# TYPE evt_sigcache_" << name << " " << type << "\n";
+        os << "evt_sigcache_" << name << " " << value << "\n";
+    };
+    sig_metric("hit_total", "counter", "Recovered public key cache hits", rm.hit);
+    sig_metric("miss_total", "counter", "Recovered public key cache misses", rm.miss);
+    sig_metric("keys", "gauge", "Keys in recovered public key cache", rm.size);
+    sig_metric("capacity_keys", "gauge", "Capacity of recovered public key cache", rm.capacity);
+
+    return os.str();
+}
+
 }  // namespace chain_apis
 }  // namespace evt
@@ -168,6 +168,10 @@ public:
 
     using get_db_info_params = empty;
     std::string get_db_info(const get_db_info_params&) const;
+
+    // metrics of token database in prometheus text format
+    using get_metrics_params = empty;
+    std::string get_metrics(const get_metrics_params&) const;
 };
 
 class read_write {
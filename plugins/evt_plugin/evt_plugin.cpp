@@ -8,6 +8,7 @@
 #include <fc/container/flat.hpp>
 #include <fc/io/json.hpp>
 #include <fc/variant.hpp>
+#include <fc/crypto/sha256.hpp>
 
 #include <evt/chain/types.hpp>
 #include <evt/chain/asset.hpp>
@@ -102,7 +103,7 @@ namespace evt_apis {
     auto& tokendb = db_.token_db();            \
     auto& tokendb_cache = db_.token_db_cache();
 
-enum psvbonus_type { kPsvBonus = 0, kPsvBonusSlim };
+enum psvbonus_type { kPsvBonus = 0, kPsvBonusSlim, kPsvBonusHolders };
 
 name128
 get_psvbonus_db_key(symbol_id_type id, uint64_t nonce) {
@@ -111,6 +112,31 @@ get_psvbonus_db_key(symbol_id_type id, uint64_t nonce) {
     return v;
 }
 
+name128
+get_holder_bonus_db_key(symbol_id_type sym_id, const address& addr) {
+    char buf[sizeof(sym_id) + sizeof(fc::ecc::public_key_shim)];
+    memcpy(buf, &sym_id, sizeof(sym_id));
+    addr.to_bytes(buf + sizeof(sym_id), addr.get_bytes_size());
+
+    auto h = fc::sha256::hash(buf, sizeof(buf));
+    auto v = uint128_t();
+    memcpy(&v, h.data(), sizeof(v));
+
+    v |= ((uint128_t)1 << 127);
+    return v;
+}
+
+std::optional<asset>
+get_ftholders_threshold(const dist_rule_v2& rule) {
+    auto threshold = std::optional<asset>();
+    rule.visit([&threshold](auto& r) {
+        if(r.receiver.type() == dist_receiver_type::ftholders) {
+            threshold = r.receiver.template get<dist_stack_receiver>().threshold;
+        }
+    });
+    return threshold;
+}
+
 fc::variant
 read_only::get_domain(const read_only::get_domain_params& params) {
     DECLARE_TOKEN_DB();
@@ -224,7 +250,21 @@ read_only::get_fungible_balance(const get_fungible_balance_params& params) {
         vars.emplace_back(std::move(var));
         return vars;
     }
-    EVT_THROW(unsupported_feature, "Read all the balance of fungibles tokens within one address is not supported in evt_plugin anymore, please refer to the history_plugin");
+    if(!tokendb.has_address_index()) {
+        EVT_THROW(unsupported_feature, "Read all the balance of fungibles tokens within one address requires address index in token database, please enable it or refer to the history_plugin");
+    }
+
+    tokendb.read_address_assets(params.address, [&vars](auto& key, auto&& value) {
+        property prop;
+        extract_db_value(value, prop);
+
+        auto var = variant();
+        fc::to_variant(asset(prop.amount, prop.sym), var);
+
+        vars.emplace_back(std::move(var));
+        return true;
+    });
+    return vars;
 }
 
 fc::variant
@@ -246,6 +286,65 @@ read_only::get_fungible_psvbonus(const get_fungible_psvbonus_params& params) {
     return mvar;
 }
 
+fc::variant
+read_only::get_psvbonus_holder(const get_psvbonus_holder_params& params) {
+    DECLARE_TOKEN_DB();
+
+    auto pb = make_empty_cache_ptr<passive_bonus>();
+    READ_DB_TOKEN(token_type::psvbonus, std::nullopt, get_psvbonus_db_key(params.id, kPsvBonus), pb, unknown_bonus_exception,
+        "Cannot find passive bonus registered for fungible token with sym id: {}.", params.id);
+
+    auto vars = variants();
+    for(auto i = 0u; i < pb->rules.size(); i++) {
+        auto threshold = get_ftholders_threshold(pb->rules[i]);
+        if(!threshold.has_value()) {
+            continue;
+        }
+
+        auto sym_id = threshold->symbol_id();
+        auto fh     = tokendb_cache.read_token<fungible_holders>(token_type::psvbonus, std::nullopt, get_psvbonus_db_key(sym_id, kPsvBonusHolders), true);
+        if(fh == nullptr) {
+            EVT_THROW2(unsupported_feature, "Passive bonus with sym id: {} is not distributed lazily", params.id);
+        }
+
+        auto bit = std::find_if(fh->buckets.cbegin(), fh->buckets.cend(), [&](auto& b) { return b.threshold == threshold->amount(); });
+        EVT_ASSERT2(bit != fh->buckets.cend(), unsupported_feature, "Passive bonus with sym id: {} is not distributed lazily", params.id);
+
+        auto amount = int64_t(0);
+        auto rit    = std::find_if(bit->rewards.cbegin(), bit->rewards.cend(), [&](auto& r) { return r.bonus_sym_id == params.id; });
+        if(rit != bit->rewards.cend()) {
+            auto entry = holder_bonus_entry();
+            entry.acc  = 0;
+
+            // settled part
+            auto hb = tokendb_cache.read_token<holder_bonus>(token_type::psvbonus_dist, std::nullopt, get_holder_bonus_db_key(sym_id, params.address), true);
+            if(hb != nullptr && hb->addr == params.address) {
+                auto eit = std::find_if(hb->entries.cbegin(), hb->entries.cend(), [&](auto& e) {
+                    return e.threshold == bit->threshold && e.bonus_sym_id == params.id;
+                });
+                if(eit != hb->entries.cend()) {
+                    entry = *eit;
+                    amount += eit->pending;
+                }
+            }
+
+            // unsettled part, current balance is the one held since last settlement
+            property prop;
+            READ_DB_ASSET_NO_THROW(params.address, threshold->sym(), prop);
+            if(prop.amount > 0 && prop.amount >= bit->threshold) {
+                amount += (int64_t)((uint128_t)prop.amount * (rit->acc - entry.acc) / config::psvbonus_acc_scale);
+            }
+        }
+
+        auto var = fc::mutable_variant_object();
+        var["rule_index"] = i;
+        var["threshold"]  = *threshold;
+        var["amount"]     = asset(amount, pb->dist_threshold.sym());
+        vars.emplace_back(std::move(var));
+    }
+    return vars;
+}
+
 fc::variant
 read_only::get_suspend(const get_suspend_params& params) {
     DECLARE_TOKEN_DB();
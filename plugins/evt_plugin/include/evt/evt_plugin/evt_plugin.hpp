@@ -70,6 +70,12 @@ public:
     };
     fc::variant get_fungible_psvbonus(const get_fungible_psvbonus_params& params);
 
+    struct get_psvbonus_holder_params {
+        symbol_id_type id;
+        address_type   address;
+    };
+    fc::variant get_psvbonus_holder(const get_psvbonus_holder_params& params);
+
     struct get_suspend_params {
         proposal_name name;
     };
@@ -115,4 +121,5 @@ FC_REFLECT(evt::evt_apis::read_only::get_tokens_params, (domain)(skip)(take));
 FC_REFLECT(evt::evt_apis::read_only::get_fungible_params, (id));
 FC_REFLECT(evt::evt_apis::read_only::get_fungible_balance_params, (address)(sym_id));
 FC_REFLECT(evt::evt_apis::read_only::get_fungible_psvbonus_params, (id));
+FC_REFLECT(evt::evt_apis::read_only::get_psvbonus_holder_params, (id)(address));
 FC_REFLECT(evt::evt_apis::read_only::get_suspend_params, (name));
@@ -0,0 +1,156 @@
+/**
+ *  @file
+ *  @copyright defined in evt/LICENSE.txt
+ */
+#pragma once
+#include <evt/net_plugin/protocol.hpp>
+#include <evt/chain/multi_index_includes.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+
+namespace evt {
+
+/**
+ * Transactions in compact blocks are identified by signed ids, same as `transaction_metadata::signed_id`.
+ * Transaction with the same id but different signatures cannot be used to rebuild the block.
+ */
+inline transaction_id_type
+get_signed_id(const packed_transaction& trx) {
+    return digest_type::hash(trx);
+}
+
+/**
+ * Transactions are sent in full only when peer may not have them:
+ * suspend transactions are never relayed and others are unknown if `peer_has` returns false for their signed ids
+ */
+template<typename PeerHas>
+compact_block_message
+make_compact_block(const signed_block& sb, const vector<transaction_id_type>& signed_ids, PeerHas&& peer_has) {
+    auto cb = compact_block_message();
+    cb.header           = sb;
+    cb.block_extensions = sb.block_extensions;
+    cb.receipts.reserve(signed_ids.size());
+
+    for(auto i = 0u; i < signed_ids.size(); i++) {
+        auto& r = sb.transactions[i];
+        cb.receipts.emplace_back(r);
+        if(r.type == transaction_receipt::suspend || !peer_has(signed_ids[i])) {
+            cb.prefilled.emplace_back(prefilled_transaction{i, packed_transaction(r.trx)});
+        }
+    }
+    cb.ids = signed_ids;
+
+    return cb;
+}
+
+/**
+ * Compact block received which still waits for the missing transactions from peer
+ */
+struct pending_compact_block {
+    block_id_type    id;
+    signed_block_ptr block;
+    vector<uint32_t> missing;
+};
+
+/**
+ * Rebuilds block of `msg` with the transactions returned by `find` for the signed ids,
+ * indexes of the ones `find` returns null for are left in `missing` of `pending`.
+ * Returns false if `msg` is malformed.
+ */
+template<typename Find>
+bool
+rebuild_compact_block(const compact_block_message& msg, Find&& find, pending_compact_block& pending) {
+    if(msg.receipts.size() != msg.ids.size()) {
+        return false;
+    }
+
+    auto b = std::make_shared<signed_block>(msg.header);
+    b->block_extensions = msg.block_extensions;
+    b->transactions.resize(msg.ids.size());
+
+    auto filled = vector<bool>(msg.ids.size(), false);
+    for(auto& p : msg.prefilled) {
+        if(p.index >= msg.ids.size()) {
+            return false;
+        }
+        b->transactions[p.index].trx = packed_transaction(p.trx);
+        filled[p.index]              = true;
+    }
+
+    pending.id      = msg.header.id();
+    pending.block   = b;
+    pending.missing = vector<uint32_t>();
+    for(auto i = 0u; i < msg.ids.size(); i++) {
+        auto& r = b->transactions[i];
+        static_cast<transaction_receipt_header&>(r) = msg.receipts[i];
+        if(filled[i]) {
+            continue;
+        }
+
+        auto ptrx = find(msg.ids[i]);
+        if(!ptrx) {
+            pending.missing.emplace_back(i);
+            continue;
+        }
+        r.trx = packed_transaction(*ptrx);
+    }
+
+    return true;
+}
+
+/**
+ * Returns false if any of the requested indexes is invalid
+ */
+inline bool
+make_block_txns(const signed_block& sb, const get_block_txns_message& req, block_txns_message& resp) {
+    resp.id = req.id;
+    resp.trxs.reserve(req.indexes.size());
+    for(auto i : req.indexes) {
+        if(i >= sb.transactions.size()) {
+            return false;
+        }
+        resp.trxs.emplace_back(sb.transactions[i].trx);
+    }
+    return true;
+}
+
+/**
+ * Returns false if the number of transactions in `msg` is not the same as the missing ones
+ */
+inline bool
+fill_compact_block(pending_compact_block& pending, const block_txns_message& msg) {
+    if(msg.trxs.size() != pending.missing.size()) {
+        return false;
+    }
+
+    for(auto i = 0u; i < msg.trxs.size(); i++) {
+        pending.block->transactions[pending.missing[i]].trx = packed_transaction(msg.trxs[i]);
+    }
+    pending.missing.clear();
+    return true;
+}
+
+constexpr size_t max_pending_compact_blocks = 8;  // per peer
+
+/**
+ * Compact blocks waiting for the missing transactions from one peer, in the order they are received
+ */
+typedef boost::multi_index_container<
+    pending_compact_block,
+    indexed_by<
+        bmi::sequenced<>,
+        ordered_unique<tag<by_id>, member<pending_compact_block, block_id_type, &pending_compact_block::id>>>>
+    pending_compact_block_index;
+
+/**
+ * Oldest pending block is dropped when there're too many, the full block of it is fetched after timeout
+ */
+inline void
+add_pending_compact(pending_compact_block_index& index, pending_compact_block&& pending) {
+    index.get<by_id>().erase(pending.id);
+    if(index.size() >= max_pending_compact_blocks) {
+        index.pop_front();
+    }
+    index.emplace_back(std::move(pending));
+}
+
+}  // namespace evt
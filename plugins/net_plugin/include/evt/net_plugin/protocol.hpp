@@ -161,6 +161,33 @@ struct sync_request_message {
     uint32_t end_block;
 };
 
+struct prefilled_transaction {
+    uint32_t           index;  ///< index of transaction in block
+    packed_transaction trx;
+};
+
+/**
+ * Block without the bodies of transactions, receiver rebuilds the block from the transactions
+ * it already has and requests the missing ones by `get_block_txns_message`
+ */
+struct compact_block_message {
+    signed_block_header                header;
+    vector<transaction_receipt_header> receipts;   ///< receipt headers of all the transactions in block
+    vector<transaction_id_type>        ids;        ///< signed ids of all the transactions in block
+    vector<prefilled_transaction>      prefilled;  ///< transactions which peer may not have
+    extensions_type                    block_extensions;
+};
+
+struct get_block_txns_message {
+    block_id_type    id;
+    vector<uint32_t> indexes;
+};
+
+struct block_txns_message {
+    block_id_type              id;
+    vector<packed_transaction> trxs;  ///< in the same order of requested indexes
+};
+
 using net_message = static_variant<handshake_message,
                                    chain_size_message,
                                    go_away_message,
@@ -168,8 +195,11 @@ using net_message = static_variant<handshake_message,
                                    notice_message,
                                    request_message,
                                    sync_request_message,
-                                   signed_block,         // which = 7
-                                   packed_transaction>;  // which = 8
+                                   signed_block,            // which = 7
+                                   packed_transaction,      // which = 8
+                                   compact_block_message,   // which = 9
+                                   get_block_txns_message,  // which = 10
+                                   block_txns_message>;     // which = 11
 
 }  // namespace evt
 
@@ -183,6 +213,10 @@ FC_REFLECT(evt::time_message, (org)(rec)(xmt)(dst));
 FC_REFLECT(evt::notice_message, (known_trx)(known_blocks));
 FC_REFLECT(evt::request_message, (req_trx)(req_blocks));
 FC_REFLECT(evt::sync_request_message, (start_block)(end_block));
+FC_REFLECT(evt::prefilled_transaction, (index)(trx));
+FC_REFLECT(evt::compact_block_message, (header)(receipts)(ids)(prefilled)(block_extensions));
+FC_REFLECT(evt::get_block_txns_message, (id)(indexes));
+FC_REFLECT(evt::block_txns_message, (id)(trxs));
 
 /**
  *
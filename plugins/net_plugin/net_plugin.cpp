@@ -4,6 +4,7 @@
  */
 #include <evt/net_plugin/net_plugin.hpp>
 #include <evt/net_plugin/protocol.hpp>
+#include <evt/net_plugin/compact_block.hpp>
 
 #include <boost/asio/read.hpp>
 #include <boost/asio/write.hpp>
@@ -61,13 +62,16 @@ using io_work_t  = boost::asio::executor_work_guard<boost::asio::io_context::exe
 
 struct node_transaction_state {
     transaction_id_type           id;
+    transaction_id_type           signed_id;       /// used to match transactions in compact blocks
     time_point_sec                expires;         /// time after which this may be purged.
     uint32_t                      block_num = 0;   /// block transaction was included in
     std::shared_ptr<vector<char>> serialized_txn;  /// the received raw bundle
+    packed_transaction_ptr        packed_trx;      /// used to rebuild compact blocks
 };
 
 struct by_expiry;
 struct by_block_num;
+struct by_signed_id;
 
 struct sha256_less {
     bool operator()(const sha256& lhs, const sha256& rhs) const {
@@ -84,6 +88,12 @@ typedef multi_index_container<
                    transaction_id_type,
                    &node_transaction_state::id>,
             sha256_less>,
+        ordered_non_unique<
+            tag<by_signed_id>,
+            member<node_transaction_state,
+                   transaction_id_type,
+                   &node_transaction_state::signed_id>,
+            sha256_less>,
         ordered_non_unique<
             tag<by_expiry>,
             member<node_transaction_state,
@@ -152,6 +162,7 @@ public:
     shared_ptr<tcp::resolver> resolver;
 
     bool use_socket_read_watermark = false;
+    bool use_compact_blocks        = true;
 
     channels::transaction_ack::channel_type::handle incoming_transaction_ack_subscription;
 
@@ -211,6 +222,11 @@ public:
     void handle_message(const connection_ptr& c, const signed_block_ptr& msg);
     void handle_message(const connection_ptr& c, const packed_transaction& msg) = delete;  // packed_transaction_ptr overload used instead
     void handle_message(const connection_ptr& c, const packed_transaction_ptr& msg);
+    void handle_message(const connection_ptr& c, const compact_block_message& msg);
+    void handle_message(const connection_ptr& c, const get_block_txns_message& msg);
+    void handle_message(const connection_ptr& c, const block_txns_message& msg);
+    void handle_block(const connection_ptr& c, const signed_block_ptr& msg, bool rebuilt);
+    void request_full_block(const connection_ptr& c, const block_id_type& id);
 
     void start_conn_timer(boost::asio::steady_timer::duration du, std::weak_ptr<connection> from_connection);
     void start_txn_timer();
@@ -306,10 +322,14 @@ constexpr auto                              def_conn_retry_wait          = 30;
 constexpr auto                              def_txn_expire_wait          = std::chrono::seconds(3);
 constexpr auto                              def_resp_expected_wait       = std::chrono::seconds(5);
 constexpr auto                              def_sync_fetch_span          = 100;
+constexpr auto                              def_sync_fetch_window        = 8;
 
 constexpr auto     message_header_size = 4;
 constexpr uint32_t signed_block_which = 7;        // see protocol net_message
 constexpr uint32_t packed_transaction_which = 8;  // see protocol net_message
+constexpr uint32_t compact_block_which = 9;       // see protocol net_message
+constexpr uint32_t get_block_txns_which = 10;     // see protocol net_message
+constexpr uint32_t block_txns_which = 11;         // see protocol net_message
 
 /**
  *  For a while, network version was a 16 bit value equal to the second set of 16 bits
@@ -331,19 +351,22 @@ constexpr uint16_t net_version_range = 106;
  */
 constexpr uint16_t proto_base          = 0;
 constexpr uint16_t proto_explicit_sync = 1;
+constexpr uint16_t proto_compact_block = 2;  // compact block and its transactions messages
 
-constexpr uint16_t net_version = proto_explicit_sync;
+constexpr uint16_t net_version = proto_compact_block;
 
 struct transaction_state {
     transaction_id_type id;
     uint32_t            block_num = 0;  ///< the block number the transaction was included in
     time_point_sec      expires;
+    transaction_id_type signed_id;      ///< the signed id of the transaction peer has
 };
 
 typedef multi_index_container<
     transaction_state,
     indexed_by<
         ordered_unique<tag<by_id>, member<transaction_state, transaction_id_type, &transaction_state::id>, sha256_less>,
+        ordered_non_unique<tag<by_signed_id>, member<transaction_state, transaction_id_type, &transaction_state::signed_id>, sha256_less>,
         ordered_non_unique<tag<by_expiry>, member<transaction_state, fc::time_point_sec, &transaction_state::expires>>,
         ordered_non_unique<
             tag<by_block_num>,
@@ -517,6 +540,7 @@ public:
     block_id_type                         fork_head;
     uint32_t                              fork_head_num = 0;
     optional<request_message>             last_req;
+    pending_compact_block_index           pending_compacts;
 
     connection_status get_status() const {
         connection_status stat;
@@ -665,25 +689,47 @@ private:
         in_sync
     };
 
+    // range of blocks requested from one peer, several of them are in flight at the same time
+    struct sync_chunk {
+        uint32_t       start;
+        uint32_t       end;
+        connection_ptr source;     // empty when the chunk waits for a new peer
+        bool           delivered;  // source has sent the last block of the range
+        bool           hedged;     // chunk was requested again because it blocked the window
+    };
+
     uint32_t       sync_known_lib_num;
     uint32_t       sync_last_requested_num;
     uint32_t       sync_next_expected_num;
     uint32_t       sync_req_span;
-    connection_ptr source;
+    uint32_t       sync_req_window;
+    connection_ptr source;  // last peer a chunk was requested from, round-robin cursor
     stages         state;
 
+    std::map<uint32_t, sync_chunk>                                   sync_chunks;  // keyed by end block num
+    std::map<uint32_t, std::pair<connection_ptr, signed_block_ptr>> sync_buffer;  // blocks ahead of the next expected one
+    bool                                                             applying_buffer = false;
+
     chain_plugin* chain_plug = nullptr;
 
     constexpr auto stage_str(stages s);
 
+    bool           is_busy(const connection_ptr& c) const;
+    connection_ptr select_source(const connection_ptr& conn, uint32_t num);
+    void           request_chunk(sync_chunk& chunk, const connection_ptr& c);
+    void           reassign_chunks(const connection_ptr& c);
+    void           chunk_progress(const connection_ptr& c, uint32_t blk_num);
+
 public:
-    explicit sync_manager(uint32_t span);
+    sync_manager(uint32_t span, uint32_t window);
     void set_state(stages s);
     bool sync_required();
     void send_handshakes();
     bool is_active(const connection_ptr& conn);
     void reset_lib_num(const connection_ptr& conn);
     void request_next_chunk(const connection_ptr& conn = connection_ptr());
+    bool buffer_block(const connection_ptr& c, const signed_block_ptr& blk);
+    void apply_buffered_blocks();
     void start_sync(const connection_ptr& c, uint32_t target);
     void reassign_fetch(const connection_ptr& c, go_away_reason reason);
     void verify_catchup(const connection_ptr& c, uint32_t num, const block_id_type& id);
@@ -784,6 +830,7 @@ connection::current() {
 void
 connection::reset() {
     peer_requested.reset();
+    pending_compacts.clear();
     blk_state.clear();
     trx_state.clear();
 }
@@ -1122,6 +1169,28 @@ create_send_buffer(const packed_transaction& trx) {
     return create_send_buffer(packed_transaction_which, trx);
 }
 
+/**
+ * Transactions known by peer are the ones sent to or received from it
+ */
+static std::shared_ptr<std::vector<char>>
+create_compact_send_buffer(const signed_block_ptr& sb,
+                           const vector<transaction_id_type>& signed_ids,
+                           const connection_ptr& c,
+                           std::shared_ptr<std::vector<char>>& shared_buffer) {
+    auto& known = c->trx_state.get<by_signed_id>();
+    auto  cb    = make_compact_block(*sb, signed_ids, [&known](auto& sid) { return known.find(sid) != known.end(); });
+
+    // compact block without prefilled transactions is same for all the peers
+    if(cb.prefilled.empty()) {
+        if(!shared_buffer) {
+            shared_buffer = create_send_buffer(compact_block_which, cb);
+        }
+        return shared_buffer;
+    }
+
+    return create_send_buffer(compact_block_which, cb);
+}
+
 void
 connection::enqueue_block(const signed_block_ptr& sb, bool trigger_send, bool to_sync_queue) {
     enqueue_buffer(create_send_buffer(sb), trigger_send, priority::low, no_reason, to_sync_queue);
@@ -1252,11 +1321,12 @@ connection::peer_has_block(const block_id_type& blkid) {
 
 //-----------------------------------------------------------
 
-sync_manager::sync_manager(uint32_t req_span)
+sync_manager::sync_manager(uint32_t req_span, uint32_t req_window)
     : sync_known_lib_num(0)
     , sync_last_requested_num(0)
     , sync_next_expected_num(1)
     , sync_req_span(req_span)
+    , sync_req_window(std::max(req_window, 1u))
     , source()
     , state(in_sync) {
     chain_plug = app().find_plugin<chain_plugin>();
@@ -1284,6 +1354,10 @@ sync_manager::set_state(stages newstate) {
     }
     fc_dlog(logger, "old state ${os} becoming ${ns}", ("os", stage_str(state))("ns", stage_str(newstate)));
     state = newstate;
+    if(state == in_sync) {
+        sync_chunks.clear();
+        sync_buffer.clear();
+    }
 }
 
 bool
@@ -1307,9 +1381,8 @@ sync_manager::reset_lib_num(const connection_ptr& c) {
             sync_known_lib_num = c->last_handshake_recv.last_irreversible_block_num;
         }
     }
-    else if(c == source) {
-        sync_last_requested_num = 0;
-        request_next_chunk();
+    else {
+        reassign_chunks(c);
     }
 }
 
@@ -1321,70 +1394,98 @@ sync_manager::sync_required() {
     return (sync_last_requested_num < sync_known_lib_num || chain_plug->chain().fork_db_head_block_num() < sync_last_requested_num);
 }
 
-void
-sync_manager::request_next_chunk(const connection_ptr& conn) {
-    uint32_t head_block = chain_plug->chain().fork_db_head_block_num();
-
-    if(head_block < sync_last_requested_num && source && source->current()) {
-        fc_ilog(logger, "ignoring request, head is ${h} last req = ${r} source is ${p}",
-                ("h", head_block)("r", sync_last_requested_num)("p", source->peer_name()));
-        return;
+bool
+sync_manager::is_busy(const connection_ptr& c) const {
+    for(auto& it : sync_chunks) {
+        if(it.second.source == c && !it.second.delivered) {
+            return true;
+        }
     }
+    return false;
+}
+
+connection_ptr
+sync_manager::select_source(const connection_ptr& conn, uint32_t num) {
+    auto usable = [&](const connection_ptr& c) {
+        return c && c->current() && c->last_handshake_recv.last_irreversible_block_num >= num && !is_busy(c);
+    };
 
     /* ----------
      * next chunk provider selection criteria
      * a provider is supplied and able to be used, use it.
-     * otherwise select the next available from the list, round-robin style.
+     * otherwise select the next idle one from the list, round-robin style.
      */
+    if(usable(conn)) {
+        return conn;
+    }
 
-    if(conn && conn->current()) {
-        source = conn;
+    auto& conns = my_impl->connections;
+    if(conns.empty()) {
+        return connection_ptr();
     }
-    else {
-        if(my_impl->connections.size() == 1) {
-            if(!source) {
-                source = *my_impl->connections.begin();
-            }
+    auto cptr = source ? conns.upper_bound(source) : conns.begin();
+    for(auto i = 0u; i < conns.size(); i++) {
+        if(cptr == conns.end()) {
+            cptr = conns.begin();
         }
-        else {
-            // init to a linear array search
-            auto cptr = my_impl->connections.begin();
-            auto cend = my_impl->connections.end();
-            // do we remember the previous source?
-            if(source) {
-                //try to find it in the list
-                cptr = my_impl->connections.find(source);
-                cend = cptr;
-                if(cptr == my_impl->connections.end()) {
-                    //not there - must have been closed! cend is now connections.end, so just flatten the ring.
-                    source.reset();
-                    cptr = my_impl->connections.begin();
-                }
-                else {
-                    //was found - advance the start to the next. cend is the old source.
-                    if(++cptr == my_impl->connections.end() && cend != my_impl->connections.end()) {
-                        cptr = my_impl->connections.begin();
-                    }
-                }
-            }
+        if(usable(*cptr)) {
+            return *cptr;
+        }
+        ++cptr;
+    }
+    return connection_ptr();
+}
 
-            //scan the list of peers looking for another able to provide sync blocks.
-            auto cstart_it = cptr;
-            do {
-                //select the first one which is current and break out.
-                if((*cptr)->current()) {
-                    source = *cptr;
-                    break;
-                }
-                if(++cptr == my_impl->connections.end())
-                    cptr = my_impl->connections.begin();
-            } while(cptr != cstart_it);
-            // no need to check the result, either source advanced or the whole list was checked and the old source is reused.
+void
+sync_manager::request_chunk(sync_chunk& chunk, const connection_ptr& c) {
+    // blocks before the next expected one are applied already
+    uint32_t start = std::max(chunk.start, sync_next_expected_num);
+    fc_ilog(logger, "requesting range ${s} to ${e}, from ${n}",
+            ("n", c->peer_name())("s", start)("e", chunk.end));
+
+    chunk.source    = c;
+    chunk.delivered = false;
+    source          = c;
+    c->request_sync_blocks(start, chunk.end);
+}
+
+void
+sync_manager::request_next_chunk(const connection_ptr& conn) {
+    // chunks left by closed or slow peers go first
+    for(auto& it : sync_chunks) {
+        auto& chunk = it.second;
+        if(chunk.source) {
+            continue;
         }
+        auto c = select_source(conn, chunk.end);
+        if(!c) {
+            break;
+        }
+        request_chunk(chunk, c);
+    }
+
+    // keep up to window chunks in flight, each one from a different peer
+    while(sync_chunks.size() < sync_req_window && sync_last_requested_num < sync_known_lib_num) {
+        uint32_t start = std::max(sync_last_requested_num + 1, sync_next_expected_num);
+        auto     c     = select_source(conn, start);
+        if(!c) {
+            break;
+        }
+        uint32_t end = std::min(start + sync_req_span - 1, sync_known_lib_num);
+        end          = std::min(end, c->last_handshake_recv.last_irreversible_block_num);
+
+        auto& chunk = sync_chunks[end];
+        chunk       = sync_chunk { .start = start, .end = end, .source = connection_ptr(), .delivered = false, .hedged = false };
+        request_chunk(chunk, c);
+        sync_last_requested_num = end;
     }
 
     // verify there is an available source
-    if(!source || !source->current()) {
+    auto has_source = std::any_of(sync_chunks.begin(), sync_chunks.end(), [](auto& it) { return (bool)it.second.source; });
+    if(!has_source) {
+        if(sync_chunks.empty() && sync_last_requested_num >= sync_known_lib_num) {
+            return;
+        }
         fc_elog(logger, "Unable to continue syncing at this time");
         sync_known_lib_num      = chain_plug->chain().last_irreversible_block_num();
         sync_last_requested_num = 0;
@@ -1392,18 +1493,79 @@ sync_manager::request_next_chunk(const connection_ptr& conn) {
         return;
     }
 
-    if(sync_last_requested_num != sync_known_lib_num) {
-        uint32_t start = sync_next_expected_num;
-        uint32_t end   = start + sync_req_span - 1;
-        if(end > sync_known_lib_num)
-            end = sync_known_lib_num;
-        if(end > 0 && end >= start) {
-            fc_ilog(logger, "requesting range ${s} to ${e}, from ${n}",
-                    ("n", source->peer_name())("s", start)("e", end));
-            source->request_sync_blocks(start, end);
-            sync_last_requested_num = end;
+    // every later chunk has arrived and only the first one holds back the window,
+    // ask an idle peer for it as well, whichever copy comes first is applied
+    auto& head = sync_chunks.begin()->second;
+    if(head.delivered || head.hedged || sync_chunks.size() < 2) {
+        return;
+    }
+    auto blocked = std::all_of(std::next(sync_chunks.begin()), sync_chunks.end(), [](auto& it) { return it.second.delivered; });
+    if(blocked) {
+        auto c = select_source(connection_ptr(), head.end);
+        if(c) {
+            head.hedged = true;
+            request_chunk(head, c);
+        }
+    }
+}
+
+void
+sync_manager::reassign_chunks(const connection_ptr& c) {
+    auto found = false;
+    for(auto& it : sync_chunks) {
+        if(it.second.source == c && !it.second.delivered) {
+            it.second.source.reset();
+            found = true;
         }
     }
+    if(found) {
+        request_next_chunk();
+    }
+}
+
+void
+sync_manager::chunk_progress(const connection_ptr& c, uint32_t blk_num) {
+    auto it = sync_chunks.lower_bound(blk_num);
+    if(it == sync_chunks.end() || it->second.start > blk_num || it->second.source != c || it->second.delivered) {
+        return;
+    }
+    if(blk_num == it->second.end) {
+        it->second.delivered = true;
+        request_next_chunk();
+    }
+    else {
+        c->sync_wait();
+    }
+}
+
+bool
+sync_manager::buffer_block(const connection_ptr& c, const signed_block_ptr& blk) {
+    uint32_t blk_num = blk->block_num();
+    if(state != lib_catchup || blk_num <= sync_next_expected_num || blk_num > sync_last_requested_num) {
+        return false;
+    }
+    fc_dlog(logger, "buffering block ${bn} from ${p}, next expected ${ne}",
+            ("bn", blk_num)("p", c->peer_name())("ne", sync_next_expected_num));
+
+    // a copy from the peer of a re-requested chunk may be there already
+    sync_buffer.emplace(blk_num, std::make_pair(c, blk));
+    chunk_progress(c, blk_num);
+    return true;
+}
+
+void
+sync_manager::apply_buffered_blocks() {
+    // blocks applied from the buffer call back here, the outer loop takes care of them
+    if(applying_buffer) {
+        return;
+    }
+    applying_buffer = true;
+    while(state == lib_catchup && !sync_buffer.empty() && sync_buffer.begin()->first <= sync_next_expected_num) {
+        auto entry = std::move(sync_buffer.begin()->second);
+        sync_buffer.erase(sync_buffer.begin());
+        my_impl->handle_message(entry.first, entry.second);
+    }
+    applying_buffer = false;
 }
 
 void
@@ -1445,10 +1607,9 @@ sync_manager::reassign_fetch(const connection_ptr& c, go_away_reason reason) {
     fc_ilog(logger, "reassign_fetch, our last req is ${cc}, next expected is ${ne} peer ${p}",
             ("cc", sync_last_requested_num)("ne", sync_next_expected_num)("p", c->peer_name()));
 
-    if(c == source) {
+    if(is_busy(c)) {
         c->cancel_sync(reason);
-        sync_last_requested_num = 0;
-        request_next_chunk();
+        reassign_chunks(c);
     }
 }
 
@@ -1583,8 +1744,8 @@ sync_manager::rejected_block(const connection_ptr& c, uint32_t blk_num) {
         fc_ilog(logger, "block ${bn} not accepted from ${p}", ("bn", blk_num)("p", c->peer_name()));
         sync_last_requested_num = 0;
         source.reset();
-        my_impl->close(c);
         set_state(in_sync);
+        my_impl->close(c);
         send_handshakes();
     }
 }
@@ -1592,6 +1753,11 @@ void
 sync_manager::recv_block(const connection_ptr& c, const block_id_type& blk_id, uint32_t blk_num) {
     fc_dlog(logger, "got block ${bn} from ${p}", ("bn", blk_num)("p", c->peer_name()));
     if(state == lib_catchup) {
+        if(blk_num < sync_next_expected_num) {
+            // late copy of a chunk which was requested again from another peer
+            fc_dlog(logger, "block ${bn} already applied, next expected ${ne}", ("bn", blk_num)("ne", sync_next_expected_num));
+            return;
+        }
         if(blk_num != sync_next_expected_num) {
             fc_ilog(logger, "expected block ${ne} but got ${bn}", ("ne", sync_next_expected_num)("bn", blk_num));
             my_impl->close(c);
@@ -1628,12 +1794,15 @@ sync_manager::recv_block(const connection_ptr& c, const block_id_type& blk_id, u
             set_state(in_sync);
             send_handshakes();
         }
-        else if(blk_num == sync_last_requested_num) {
-            request_next_chunk();
-        }
         else {
-            fc_dlog(logger, "calling sync_wait on connection ${p}", ("p", c->peer_name()));
-            c->sync_wait();
+            auto it = sync_chunks.lower_bound(blk_num);
+            if(it != sync_chunks.end() && it->second.start <= blk_num && blk_num == it->first) {
+                sync_chunks.erase(it);
+                request_next_chunk();
+            }
+            else {
+                chunk_progress(c, blk_num);
+            }
         }
     }
 }
@@ -1653,6 +1822,8 @@ dispatch_manager::bcast_block(const block_state_ptr& bs) {
     peer_block_state pbstate = {bs->id, bnum};
 
     std::shared_ptr<std::vector<char>> send_buffer;
+    std::shared_ptr<std::vector<char>> compact_buffer;
+    std::optional<vector<transaction_id_type>> ids;
     for(auto& cp : my_impl->connections) {
         if(skips.find(cp) != skips.end() || !cp->current()) {
             continue;
@@ -1662,6 +1833,18 @@ dispatch_manager::bcast_block(const block_state_ptr& bs) {
             if(!cp->add_peer_block(pbstate)) {
                 continue;
             }
+            if(my_impl->use_compact_blocks && cp->protocol_version >= proto_compact_block) {
+                if(!ids.has_value()) {
+                    ids.emplace();
+                    ids->reserve(bs->block->transactions.size());
+                    for(auto& r : bs->block->transactions) {
+                        ids->emplace_back(get_signed_id(r.trx));
+                    }
+                }
+                fc_dlog(logger, "bcast compact block ${b} to ${p}", ("b", bnum)("p", cp->peer_name()));
+                cp->enqueue_buffer(create_compact_send_buffer(bs->block, *ids, cp, compact_buffer), true, priority::high, no_reason);
+                continue;
+            }
             if(!send_buffer) {
                 send_buffer = create_send_buffer(bs->block);
             }
@@ -1724,17 +1907,17 @@ dispatch_manager::bcast_transaction(const transaction_metadata_ptr& ptrx) {
 
     auto buff = create_send_buffer(trx);
 
-    node_transaction_state nts = {id, trx_expiration, 0, buff};
+    node_transaction_state nts = {id, ptrx->signed_id, trx_expiration, 0, buff, ptrx->packed_trx};
     my_impl->local_txns.insert(std::move(nts));
 
-    my_impl->send_transaction_to_all(buff, [&id, &skips, trx_expiration](const connection_ptr& c) -> bool {
+    my_impl->send_transaction_to_all(buff, [&id, &ptrx, &skips, trx_expiration](const connection_ptr& c) -> bool {
         if(skips.find(c) != skips.end() || c->syncing) {
             return false;
         }
         const auto& bs      = c->trx_state.find(id);
         bool        unknown = bs == c->trx_state.end();
         if(unknown) {
-            c->trx_state.insert(transaction_state({id, 0, trx_expiration}));
+            c->trx_state.insert(transaction_state({id, 0, trx_expiration, ptrx->signed_id}));
             fc_dlog(logger, "sending trx to ${n}", ("n", c->peer_name()));
         }
         return unknown;
@@ -2193,7 +2376,7 @@ net_plugin_impl::process_next_message(const connection_ptr& conn, uint32_t messa
         auto peek_ds = conn->pending_message_buffer.create_peek_datastream();
         unsigned_int which{};
         fc::raw::unpack(peek_ds, which);
-        if(which == signed_block_which) {
+        if(which == signed_block_which || which == compact_block_which) {
             block_header bh;
             fc::raw::unpack(peek_ds, bh);
 
@@ -2573,6 +2756,15 @@ net_plugin_impl::handle_message(const connection_ptr& c, const packed_transactio
     auto        ptrx = std::make_shared<transaction_metadata>(trx);
     const auto& tid  = ptrx->id;
 
+    // peer has this signed transaction, so it doesn't need to be sent in compact blocks
+    auto pts = c->trx_state.get<by_id>().find(tid);
+    if(pts == c->trx_state.end()) {
+        c->trx_state.insert(transaction_state({tid, 0, ptrx->packed_trx->expiration(), ptrx->signed_id}));
+    }
+    else if(pts->signed_id != ptrx->signed_id) {
+        c->trx_state.modify(pts, [&ptrx](auto& ts) { ts.signed_id = ptrx->signed_id; });
+    }
+
     if(local_txns.get<by_id>().find(tid) != local_txns.end()) {
         fc_dlog(logger, "got a duplicate transaction - dropping");
         return;
@@ -2601,6 +2793,15 @@ net_plugin_impl::handle_message(const connection_ptr& c, const packed_transactio
 
 void
 net_plugin_impl::handle_message(const connection_ptr& c, const signed_block_ptr& msg) {
+    handle_block(c, msg, false /* rebuilt */);
+}
+
+/**
+ * Block rebuilt from compact block may be invalid if a transaction from other peers differs from the one producer has,
+ * it's discarded without penalizing peer and the full block is requested instead
+ */
+void
+net_plugin_impl::handle_block(const connection_ptr& c, const signed_block_ptr& msg, bool rebuilt) {
     controller&   cc      = chain_plug->chain();
     block_id_type blk_id  = msg->id();
     uint32_t      blk_num = msg->block_num();
@@ -2618,15 +2819,24 @@ net_plugin_impl::handle_message(const connection_ptr& c, const signed_block_ptr&
         fc_elog(logger, "Caught an unknown exception trying to recall blockID");
     }
 
+    // full block makes the pending compact one useless
+    c->pending_compacts.get<by_id>().erase(blk_id);
+
+    if(sync_master->buffer_block(c, msg)) {
+        return;
+    }
+
     dispatcher->recv_block(c, blk_id, blk_num);
     fc::microseconds age(fc::time_point::now() - msg->timestamp);
     peer_ilog(c, "received signed_block : #${n} block age in secs = ${age}",
               ("n", blk_num)("age", age.to_seconds()));
 
-    go_away_reason reason = fatal_other;
+    go_away_reason reason   = fatal_other;
+    bool           accepted = false;
     try {
         chain_plug->accept_block(msg);  //, sync_master->is_active(c));
-        reason = no_reason;
+        reason   = no_reason;
+        accepted = true;
     }
     catch(const unlinkable_block_exception& ex) {
         peer_elog(c, "bad signed_block : ${m}", ("m", ex.what()));
@@ -2651,6 +2861,12 @@ net_plugin_impl::handle_message(const connection_ptr& c, const signed_block_ptr&
         fc_elog(logger, "handle sync block caught something else from ${p}", ("num", blk_num)("p", c->peer_name()));
     }
 
+    if(rebuilt && !accepted) {
+        peer_wlog(c, "rebuilt block #${n} is not accepted, requesting the full block", ("n", blk_num));
+        request_full_block(c, blk_id);
+        return;
+    }
+
     update_block_num ubn(blk_num);
     if(reason == no_reason) {
         for(const auto& recpt : msg->transactions) {
@@ -2665,6 +2881,7 @@ net_plugin_impl::handle_message(const connection_ptr& c, const signed_block_ptr&
             }
         }
         sync_master->recv_block(c, blk_id, blk_num);
+        sync_master->apply_buffered_blocks();
     }
     else {
         sync_master->rejected_block(c, blk_num);
@@ -2672,6 +2889,119 @@ net_plugin_impl::handle_message(const connection_ptr& c, const signed_block_ptr&
     }
 }
 
+void
+net_plugin_impl::handle_message(const connection_ptr& c, const compact_block_message& msg) {
+    controller&   cc      = chain_plug->chain();
+    block_id_type blk_id  = msg.header.id();
+    uint32_t      blk_num = msg.header.block_num();
+    c->cancel_wait();
+
+    try {
+        if(cc.fetch_block_by_id(blk_id)) {
+            sync_master->recv_block(c, blk_id, blk_num);
+            return;
+        }
+    }
+    catch(...) {
+        fc_elog(logger, "Caught an unknown exception trying to recall blockID");
+    }
+
+    auto& ltxs    = local_txns.get<by_signed_id>();
+    auto  pending = pending_compact_block();
+    auto  find    = [&ltxs](auto& sid) {
+        auto ltx = ltxs.find(sid);
+        return ltx != ltxs.end() ? ltx->packed_trx : packed_transaction_ptr();
+    };
+    if(!rebuild_compact_block(msg, find, pending)) {
+        peer_elog(c, "bad compact_block : invalid receipts or prefilled transactions");
+        close(c);
+        return;
+    }
+
+    peer_ilog(c, "received compact_block : #${n} missing ${m} of ${t} transactions",
+              ("n", blk_num)("m", pending.missing.size())("t", msg.ids.size()));
+    if(pending.missing.empty()) {
+        handle_block(c, pending.block, true /* rebuilt */);
+        return;
+    }
+
+    auto req = get_block_txns_message();
+    req.id      = blk_id;
+    req.indexes = pending.missing;
+    c->enqueue_buffer(create_send_buffer(get_block_txns_which, req), true, priority::high, no_reason);
+
+    add_pending_compact(c->pending_compacts, std::move(pending));
+
+    // fall back to fetch the full block when peer doesn't respond in time
+    auto full_req = request_message();
+    full_req.req_trx.mode    = none;
+    full_req.req_blocks.mode = normal;
+    full_req.req_blocks.ids.push_back(blk_id);
+
+    c->last_req = std::move(full_req);
+    c->fetch_wait();
+}
+
+void
+net_plugin_impl::handle_message(const connection_ptr& c, const get_block_txns_message& msg) {
+    controller& cc = chain_plug->chain();
+
+    auto b = signed_block_ptr();
+    try {
+        b = cc.fetch_block_by_id(msg.id);
+    }
+    catch(...) {
+        fc_elog(logger, "Caught an unknown exception trying to fetch block ${id}", ("id", msg.id));
+    }
+    if(!b) {
+        // peer will request the full block from others after timeout
+        peer_wlog(c, "cannot find block ${id} for requested transactions", ("id", msg.id));
+        return;
+    }
+
+    auto resp = block_txns_message();
+    if(!make_block_txns(*b, msg, resp)) {
+        peer_elog(c, "bad get_block_txns : invalid indexes");
+        close(c);
+        return;
+    }
+
+    c->enqueue_buffer(create_send_buffer(block_txns_which, resp), true, priority::high, no_reason);
+}
+
+void
+net_plugin_impl::handle_message(const connection_ptr& c, const block_txns_message& msg) {
+    auto& pendings = c->pending_compacts.get<by_id>();
+    auto  it       = pendings.find(msg.id);
+    if(it == pendings.end()) {
+        peer_dlog(c, "received unexpected block_txns for ${id} - dropping", ("id", msg.id));
+        return;
+    }
+
+    auto pending = *it;
+    pendings.erase(it);
+
+    if(!fill_compact_block(pending, msg)) {
+        peer_elog(c, "bad block_txns : expected ${e} transactions but got ${n}", ("e", pending.missing.size())("n", msg.trxs.size()));
+        close(c);
+        return;
+    }
+
+    handle_block(c, pending.block, true /* rebuilt */);
+}
+
+void
+net_plugin_impl::request_full_block(const connection_ptr& c, const block_id_type& id) {
+    auto req = request_message();
+    req.req_trx.mode    = none;
+    req.req_blocks.mode = normal;
+    req.req_blocks.ids.push_back(id);
+
+    c->enqueue(req);
+    c->last_req = std::move(req);
+    c->fetch_wait();
+}
+
 void
 net_plugin_impl::start_conn_timer(boost::asio::steady_timer::duration du, std::weak_ptr<connection> from_connection) {
     connector_check->expires_from_now(du);
@@ -2979,7 +3309,9 @@ net_plugin::set_program_options(options_description& /*cli*/, options_descriptio
         ("max-cleanup-time-msec", bpo::value<int>()->default_value(10), "max connection cleanup time per cleanup call in millisec")
         ("network-version-match", bpo::value<bool>()->default_value(false), "True to require exact match of peer network version.")
         ("sync-fetch-span", bpo::value<uint32_t>()->default_value(def_sync_fetch_span), "number of blocks to retrieve in a chunk from any individual peer during synchronization")
+        ("sync-fetch-window", bpo::value<uint32_t>()->default_value(def_sync_fetch_window), "maximum number of chunks requested in parallel from different peers during synchronization")
         ("use-socket-read-watermark", bpo::value<bool>()->default_value(false), "Enable expirimental socket read watermark optimization")
+        ("p2p-compact-blocks", bpo::value<bool>()->default_value(true), "Relay blocks to the peers which support it with transaction ids only, peers rebuild blocks from the transactions they have")
         ("peer-log-format", bpo::value<string>()->default_value("[\"${_name}\" ${_ip}:${_port}]"),
             "The string used to format peers when logging messages about them.  Variables are escaped with ${<variable name>}.\n"
             "Available Variables:\n"
@@ -3007,7 +3339,8 @@ net_plugin::plugin_initialize(const variables_map& options) {
 
         my->network_version_match = options.at("network-version-match").as<bool>();
 
-        my->sync_master.reset(new sync_manager(options.at("sync-fetch-span").as<uint32_t>()));
+        my->sync_master.reset(new sync_manager(options.at("sync-fetch-span").as<uint32_t>(),
+                                               options.at("sync-fetch-window").as<uint32_t>()));
         my->dispatcher.reset(new dispatch_manager);
 
         my->connector_period     = std::chrono::seconds(options.at("connection-cleanup-period").as<int>());
@@ -3020,6 +3353,7 @@ net_plugin::plugin_initialize(const variables_map& options) {
         my->started_sessions     = 0;
 
         my->use_socket_read_watermark = options.at("use-socket-read-watermark").as<bool>();
+        my->use_compact_blocks        = options.at("p2p-compact-blocks").as<bool>();
 
         if(options.count("p2p-listen-endpoint") && options.at("p2p-listen-endpoint").as<string>().length()) {
             my->p2p_address = options.at("p2p-listen-endpoint").as<string>();
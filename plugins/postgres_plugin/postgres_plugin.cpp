@@ -608,7 +608,7 @@ postgres_plugin::plugin_initialize(const variables_map& options) {
 
             // recover genesis information from the snapshot
             auto infile = std::ifstream(snapshot_path.generic_string(), (std::ios::in | std::ios::binary));
-            auto reader = std::make_shared<istream_snapshot_reader>(infile);
+            auto reader = make_snapshot_reader(infile);
             reader->validate();
 
             if(reader->has_section("pg-blocks")) {
@@ -37,10 +37,12 @@ public:
         fc::time_point       head_block_time;
         std::string          snapshot_name;
         bool                 postgres;
+        bool                 delta;
     };
 
     struct create_snapshot_options {
         bool postgres = false;
+        bool delta    = false;  // only changes of token database since the latest snapshot
     };
 
     producer_plugin();
@@ -76,5 +78,5 @@ private:
 
 FC_REFLECT(evt::producer_plugin::runtime_options, (max_transaction_time)(max_irreversible_block_age)(produce_time_offset_us)(last_block_time_offset_us));
 FC_REFLECT(evt::producer_plugin::integrity_hash_information, (head_block_num)(head_block_id)(head_block_time)(integrity_hash));
-FC_REFLECT(evt::producer_plugin::snapshot_information, (head_block_num)(head_block_id)(head_block_time)(snapshot_name)(postgres));
-FC_REFLECT(evt::producer_plugin::create_snapshot_options, (postgres));
+FC_REFLECT(evt::producer_plugin::snapshot_information, (head_block_num)(head_block_id)(head_block_time)(snapshot_name)(postgres)(delta));
+FC_REFLECT(evt::producer_plugin::create_snapshot_options, (postgres)(delta));
@@ -360,6 +360,10 @@ public:
         chain::controller& chain = chain_plug->chain();
         const auto&        cfg   = chain.get_global_properties().configuration;
 
+        // recover signing keys ahead in background so that the transactions queued between slots
+        // only need to execute the actions once the pending block is started
+        start_recover_keys(trx, chain.get_thread_pool(), chain.get_chain_id());
+
         app().get_io_service().post([self = this, trx, persist_until_expired, next]() {
             self->process_incoming_transaction_async(trx, persist_until_expired, next);
         });
@@ -884,18 +888,27 @@ producer_plugin::create_snapshot(const create_snapshot_options& options) const {
     }
 
     auto head_id       = chain.head_block_id();
-    auto snapshot_path = (my->_snapshots_dir / fc::format_string("snapshot-${id}.bin", fc::mutable_variant_object()("id", head_id))).generic_string();
+    auto snapshot_name = options.delta ? "snapshot-delta-${id}.bin" : "snapshot-${id}.bin";
+    auto snapshot_path = (my->_snapshots_dir / fc::format_string(snapshot_name, fc::mutable_variant_object()("id", head_id))).generic_string();
 
     EVT_ASSERT(!fc::is_regular_file(snapshot_path), snapshot_exists_exception,
                "snapshot named ${name} already exists", ("name", snapshot_path));
 
     auto snap_out = std::ofstream(snapshot_path, (std::ios::out | std::ios::binary));
-    auto writer   = std::make_shared<ostream_snapshot_writer>(snap_out);
+    auto writer   = std::make_shared<chunked_snapshot_writer>(snap_out);
 
     bool postgres = false;
 
-    chain.write_snapshot(writer);
-    if(options.postgres) {
+    if(options.delta) {
+        chain.write_delta_snapshot(writer);
+    }
+    else {
+        chain.write_snapshot(writer);
+    }
+    if(options.postgres && options.delta) {
+        wlog("Postgres cannot be written into delta snapshot");
+    }
+    else if(options.postgres) {
 #ifdef POSTGRES_SUPPORT
         if(app().find_plugin("evt::postgres_plugin") == nullptr) {
             wlog("Cannot find postgres plugin, don't write postgres into snapshot");
@@ -919,7 +932,7 @@ producer_plugin::create_snapshot(const create_snapshot_options& options) const {
     snap_out.flush();
     snap_out.close();
 
-    return {chain.head_block_num(), head_id, chain.head_block_time(), snapshot_path, postgres};
+    return {chain.head_block_num(), head_id, chain.head_block_time(), snapshot_path, postgres, options.delta};
 }
 
 optional<fc::time_point>
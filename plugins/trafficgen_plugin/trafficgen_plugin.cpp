@@ -5,10 +5,17 @@
 #include <evt/trafficgen_plugin/trafficgen_plugin.hpp>
 
 #include <signal.h>
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <boost/algorithm/string.hpp>
 #include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/thread_pool.hpp>
 
 #include <evt/chain/exceptions.hpp>
 #include <evt/chain/transaction.hpp>
+#include <evt/chain/transaction_metadata.hpp>
 #include <evt/chain/token_database.hpp>
 
 #include <fc/io/json.hpp>
@@ -30,36 +37,87 @@ using evt::chain::block_state_ptr;
 using evt::chain::packed_transaction_ptr;
 using evt::chain::private_key_type;
 using evt::chain::transaction_metadata;
+using evt::chain::transaction_metadata_ptr;
 
 class trafficgen_plugin_impl : public std::enable_shared_from_this<trafficgen_plugin_impl> {
+public:
+    enum class trx_kind { ft = 0, nft };
+
+    // one slot per unit of weight in the mix, the transaction at seq `i` uses slot `i % mix.size()`
+    struct mix_slot {
+        trx_kind kind;
+        uint32_t offset;  // number of the same kind before this slot
+    };
+
+    enum class gen_state { idle = 0, generating, pushing, done };
+
+    static constexpr auto kChunkSize    = 256u;
+    static constexpr auto kTickInterval = std::chrono::milliseconds(10);
+
 public:
     trafficgen_plugin_impl(controller& db)
-        : db_(db) {}
+        : db_(db)
+        , timer_(app().get_io_service()) {}
 
 public:
     void init();
+    void shutdown();
+    void parse_mix(const std::string& type);
 
 private:
+    size_t count_kind(trx_kind kind, size_t n) const;
+
     int  pre_nft_setup(const block_id_type& id);
-    void pre_ft_generate(const block_id_type& id);
-    void pre_nft_generate(const block_id_type& id);
+    void start_generate();
+    void schedule_generate();
+    void start_push();
+    void tick();
+    void report(bool final);
+
+    std::vector<transaction_metadata_ptr> generate(size_t begin, size_t end, const block_id_type& id);
+    action make_ft_action(size_t index);
+    action make_nft_action(size_t index);
+
     void applied_block(const block_state_ptr& bs);
-    void push_once(int index);
+    void push_once(const transaction_metadata_ptr& trx);
     void push_trx(const action& act, const block_id_type& id);
 
 public:
     controller& db_;
 
-    uint32_t start_num_  = 0;
-    size_t   total_num_  = 0;
-    bool     pushed_     = false;
+    uint32_t start_num_       = 0;
+    size_t   total_num_       = 0;
+    uint32_t rate_            = 0;  // target transactions per second, zero for unlimited
+    uint32_t threads_         = 0;
+    uint32_t report_interval_ = 0;  // seconds
 
     address          from_addr_;
     private_key_type from_priv_;
 
-    std::string type_;
-
-    std::vector<packed_transaction_ptr> packed_trxs_;
+    std::vector<mix_slot> mix_;
+    uint32_t              weights_[2] = {0, 0};
+
+    gen_state     state_ = gen_state::idle;
+    block_id_type ref_block_id_;
+
+    // generated transactions are buffered ahead of pushing, at most `window_` ones
+    std::optional<boost::asio::thread_pool> workers_;
+    std::mutex                              queue_mutex_;
+    std::deque<transaction_metadata_ptr>    queue_;
+    size_t                                  window_     = 0;
+    size_t                                  next_seq_   = 0;
+    size_t                                  generating_ = 0;
+    size_t                                  gen_failed_ = 0;
+
+    // below are only accessed on app io_service
+    boost::asio::steady_timer timer_;
+    fc::time_point            push_start_;
+    fc::time_point            last_report_;
+    size_t                    last_report_acks_ = 0;
+    size_t                    sent_             = 0;
+    size_t                    failed_           = 0;
+    size_t                    push_failed_      = 0;  // failed when pushing, they never respond
+    std::vector<uint32_t>     latencies_;  // microseconds from pushing to response, in order of responses
 
     std::optional<boost::signals2::scoped_connection> accepted_block_connection_;
 };
@@ -74,6 +132,76 @@ trafficgen_plugin_impl::init() {
     }));
 }
 
+void
+trafficgen_plugin_impl::shutdown() {
+    accepted_block_connection_.reset();
+    timer_.cancel();
+    if(workers_) {
+        workers_->stop();
+        workers_->join();
+    }
+}
+
+void
+trafficgen_plugin_impl::parse_mix(const std::string& type) {
+    auto parts = std::vector<std::string>();
+    boost::split(parts, type, boost::is_any_of(","));
+
+    auto weights = std::vector<std::pair<trx_kind, uint32_t>>();
+    for(auto& p : parts) {
+        auto kv = std::vector<std::string>();
+        boost::split(kv, p, boost::is_any_of(":"));
+        EVT_ASSERT(kv.size() <= 2, chain::plugin_config_exception, "Not valid value for --traffic-type option: ${t}", ("t",type));
+
+        auto kind = trx_kind::ft;
+        if(kv[0] == "ft") {
+            kind = trx_kind::ft;
+        }
+        else if(kv[0] == "nft") {
+            kind = trx_kind::nft;
+        }
+        else {
+            EVT_THROW(chain::plugin_config_exception, "Not valid type of transactions: ${t}", ("t",kv[0]));
+        }
+
+        auto weight = 1u;
+        if(kv.size() == 2) {
+            try {
+                weight = (uint32_t)std::stoul(kv[1]);
+            }
+            catch(...) {
+                EVT_THROW(chain::plugin_config_exception, "Not valid weight of transactions: ${w}", ("w",kv[1]));
+            }
+        }
+        EVT_ASSERT(weight > 0 && weight <= 100, chain::plugin_config_exception, "Weight of transactions should be in [1, 100]");
+        weights.emplace_back(kind, weight);
+    }
+
+    // interleaves the kinds so that the mix is even in a short range as well
+    auto remains = true;
+    while(remains) {
+        remains = false;
+        for(auto& w : weights) {
+            if(w.second == 0) {
+                continue;
+            }
+            mix_.emplace_back(mix_slot { .kind = w.first, .offset = weights_[(int)w.first] });
+            weights_[(int)w.first]++;
+            w.second--;
+            remains = true;
+        }
+    }
+}
+
+size_t
+trafficgen_plugin_impl::count_kind(trx_kind kind, size_t n) const {
+    auto count = (n / mix_.size()) * weights_[(int)kind];
+    for(auto i = 0u; i < n % mix_.size(); i++) {
+        count += (mix_[i].kind == kind);
+    }
+    return count;
+}
+
 void
 trafficgen_plugin_impl::push_trx(const action& act, const block_id_type& id) {
     using namespace evt::chain;
@@ -145,11 +273,13 @@ trafficgen_plugin_impl::pre_nft_setup(const block_id_type& id) {
     auto ndact = action(N128(tttesttt), N128(.create), nd);
     push_trx(ndact, id);
 
-    for(auto i = 0; i < 20; i++) {
+    // only issues the tokens going to be transferred
+    auto total = count_kind(trx_kind::nft, total_num_);
+    for(auto i = 0u; i < total; i += 10'000) {
         auto it   = issuetoken();
         it.domain = "tttesttt";
         it.owner.emplace_back(from_addr_);
-        for(auto j = i * 10'000; j < 10'000 * (i + 1); j++) {
+        for(auto j = i; j < std::min(total, (size_t)i + 10'000); j++) {
             it.names.emplace_back(name128::from_number(j));
         }
 
@@ -161,116 +291,228 @@ trafficgen_plugin_impl::pre_nft_setup(const block_id_type& id) {
     return 1;
 }
 
-void
-trafficgen_plugin_impl::pre_ft_generate(const block_id_type& id) {
+action
+trafficgen_plugin_impl::make_ft_action(size_t index) {
     using namespace evt::chain;
     using namespace evt::chain::contracts;
 
-    ilog("Generating ft ptrxs...");
-
-    packed_trxs_.reserve(total_num_);
-
     auto tt   = transferft();
     tt.from   = from_addr_;
+    tt.to     = private_key_type::generate().get_public_key();
     tt.number = asset(10, evt_sym());
     tt.memo   = "FROM THE NEW WORLD";
 
-    auto ttact = action(N128(.fungible), N128(1), tt);
+    return action(N128(.fungible), N128(1), tt);
+}
 
-    auto now = fc::time_point::now();
-    for(auto i = 0u; i < total_num_; i++) {
-        auto priv = private_key_type::generate();
-        auto pub  = priv.get_public_key();
+action
+trafficgen_plugin_impl::make_nft_action(size_t index) {
+    using namespace evt::chain;
+    using namespace evt::chain::contracts;
 
-        tt.to = pub;
-        ttact.set_data(tt);
+    auto tt   = transfer();
+    tt.domain = "tttesttt";
+    tt.name   = name128::from_number(index);
+    tt.to.emplace_back(private_key_type::generate().get_public_key());
+    tt.memo   = "FROM THE NEW WORLD";
+
+    return action(N128(tttesttt), tt.name, tt);
+}
+
+std::vector<transaction_metadata_ptr>
+trafficgen_plugin_impl::generate(size_t begin, size_t end, const block_id_type& id) {
+    using namespace evt::chain;
+
+    auto trxs = std::vector<transaction_metadata_ptr>();
+    trxs.reserve(end - begin);
+
+    auto now = fc::time_point::now();
+    for(auto i = begin; i < end; i++) {
+        auto& slot  = mix_[i % mix_.size()];
+        auto  index = (i / mix_.size()) * weights_[(int)slot.kind] + slot.offset;
 
         auto trx = signed_transaction();
         trx.set_reference_block(id);
-        trx.actions.emplace_back(ttact);
+        trx.actions.emplace_back(slot.kind == trx_kind::ft ? make_ft_action(index) : make_nft_action(index));
         trx.expiration = now + fc::minutes(10);
         trx.payer = from_addr_;
         trx.max_charge = 10000;
         trx.sign(from_priv_, db_.get_chain_id());
 
-        packed_trxs_.emplace_back(std::make_shared<packed_transaction>(trx));
+        trxs.emplace_back(std::make_shared<transaction_metadata>(std::make_shared<packed_transaction>(trx)));
     }
+    return trxs;
+}
+
+void
+trafficgen_plugin_impl::start_generate() {
+    ilog("Generating trxs with ${n} threads...", ("n",threads_));
+
+    // keeps about two seconds of transactions ahead when rate is limited
+    window_ = std::max((size_t)rate_ * 2, (size_t)kChunkSize * threads_ * 4);
+    workers_.emplace(threads_);
+    state_ = gen_state::generating;
 
-    ilog("Generating ft ptrxs... Done");
+    schedule_generate();
 }
 
 void
-trafficgen_plugin_impl::pre_nft_generate(const block_id_type& id) {
-    using namespace evt::chain;
-    using namespace evt::chain::contracts;
+trafficgen_plugin_impl::schedule_generate() {
+    auto lock = std::lock_guard(queue_mutex_);
+    while(next_seq_ < total_num_ && queue_.size() + generating_ < window_) {
+        auto begin = next_seq_;
+        auto end   = std::min(begin + kChunkSize, total_num_);
+
+        next_seq_ = end;
+        generating_ += end - begin;
+
+        boost::asio::post(*workers_, [self = shared_from_this(), begin, end, id = ref_block_id_] {
+            auto trxs = std::vector<transaction_metadata_ptr>();
+            try {
+                trxs = self->generate(begin, end, id);
+            }
+            catch(fc::exception& e) {
+                elog("Generating trxs failed, e: ${e}", ("e",e.to_detail_string()));
+            }
 
-    ilog("Generating nft ptrxs...");
+            auto lock = std::lock_guard(self->queue_mutex_);
+            for(auto& trx : trxs) {
+                self->queue_.emplace_back(std::move(trx));
+            }
+            self->generating_ -= end - begin;
+            self->gen_failed_ += (end - begin) - trxs.size();
+        });
+    }
+}
 
-    packed_trxs_.reserve(total_num_);
+void
+trafficgen_plugin_impl::start_push() {
+    ilog("Pushing ${n} trxs at rate: ${r}", ("n",total_num_)("r",rate_ ? std::to_string(rate_) + "/s" : std::string("unlimited")));
 
-    auto tt   = transfer();
-    tt.domain = "tttesttt";
-    tt.memo   = "FROM THE NEW WORLD";
+    state_       = gen_state::pushing;
+    push_start_  = fc::time_point::now();
+    last_report_ = push_start_;
+    latencies_.reserve(total_num_);
 
-    auto ttact = action(N128(tttesttt), N128(0), tt);
+    tick();
+}
 
+void
+trafficgen_plugin_impl::tick() {
     auto now = fc::time_point::now();
-    for(auto i = 0u; i < total_num_; i++) {
-        auto priv = private_key_type::generate();
-        auto pub  = priv.get_public_key();
 
-        tt.name = name128::from_number(i);
-        tt.to.emplace_back(pub);
-        ttact.set_data(tt);
-        ttact.key = name128::from_number(i);
+    // open-loop: the number to be sent only depends on the elapsed time, not on the responses
+    auto target = total_num_;
+    if(rate_ > 0) {
+        target = std::min(total_num_, (size_t)((now - push_start_).count() * rate_ / 1'000'000));
+    }
 
-        auto trx = signed_transaction();
-        trx.set_reference_block(id);
-        trx.actions.emplace_back(ttact);
-        trx.expiration = now + fc::minutes(10);
-        trx.payer = from_addr_;
-        trx.max_charge = 10000;
-        trx.sign(from_priv_, db_.get_chain_id());
+    auto trxs       = std::vector<transaction_metadata_ptr>();
+    auto gen_failed = size_t(0);
+    {
+        auto lock = std::lock_guard(queue_mutex_);
+        while(sent_ + trxs.size() < target && !queue_.empty()) {
+            trxs.emplace_back(std::move(queue_.front()));
+            queue_.pop_front();
+        }
+        gen_failed = gen_failed_;
+    }
+    for(auto& trx : trxs) {
+        push_once(trx);
+    }
+    schedule_generate();
 
-        packed_trxs_.emplace_back(std::make_shared<packed_transaction>(trx));
+    if(report_interval_ > 0 && now - last_report_ >= fc::seconds(report_interval_)) {
+        report(false);
+    }
+    if(sent_ + gen_failed == total_num_ && latencies_.size() + push_failed_ == sent_) {
+        report(true);
+        state_ = gen_state::done;
+        return;
     }
 
-    ilog("Generating nft ptrxs... Done");
+    timer_.expires_after(kTickInterval);
+    timer_.async_wait([self = shared_from_this()](auto& ec) {
+        if(ec) {
+            return;
+        }
+        self->tick();
+    });
+}
+
+void
+trafficgen_plugin_impl::report(bool final) {
+    auto now   = fc::time_point::now();
+    auto begin = final ? 0 : last_report_acks_;
+    auto since = final ? push_start_ : last_report_;
+    auto secs  = std::max((now - since).count(), (int64_t)1) / 1'000'000.0;
+
+    auto lats = std::vector<uint32_t>(latencies_.begin() + begin, latencies_.end());
+    auto percentile = [&lats](double p) -> double {
+        if(lats.empty()) {
+            return 0;
+        }
+        auto it = lats.begin() + (size_t)(p * (lats.size() - 1));
+        std::nth_element(lats.begin(), it, lats.end());
+        return *it / 1000.0;
+    };
+
+    auto behind = size_t(0);
+    if(rate_ > 0) {
+        auto target = std::min(total_num_, (size_t)((now - push_start_).count() * rate_ / 1'000'000));
+        behind = target > sent_ ? target - sent_ : 0;
+    }
+
+    ilog("${w} trafficgen: sent: ${s}, responded: ${r}, failed: ${f}, behind: ${b}, tps: ${t}, latency(ms) p50: ${p50}, p90: ${p90}, p99: ${p99}, max: ${max}",
+         ("w",final ? "Total" : "Interval")("s",sent_)("r",latencies_.size())("f",failed_)("b",behind)
+         ("t",(uint64_t)(lats.size() / secs))("p50",percentile(0.5))("p90",percentile(0.9))("p99",percentile(0.99))("max",percentile(1)));
+
+    last_report_      = now;
+    last_report_acks_ = latencies_.size();
 }
 
 void
 trafficgen_plugin_impl::applied_block(const block_state_ptr& bs) {
-    if(bs->block_num >= start_num_) {
-        if(packed_trxs_.empty()) {
-            if(type_ == "ft") {
-                pre_ft_generate(bs->id);
-            }
-            else if(type_ == "nft") {
-                if(pre_nft_setup(bs->id)) {
-                    pre_nft_generate(bs->id);
-                }
-            }
+    ref_block_id_ = bs->id;
+    if(bs->block_num < start_num_ || total_num_ == 0) {
+        return;
+    }
+
+    switch(state_) {
+    case gen_state::idle: {
+        if(weights_[(int)trx_kind::nft] > 0 && !pre_nft_setup(bs->id)) {
+            state_ = gen_state::done;
+            break;
+        }
+        start_generate();
+        break;
+    }
+    case gen_state::generating: {
+        // push after setup trxs are applied and node is synced
+        auto now = fc::time_point::now();
+        if(std::abs((db_.head_block_time() - now).to_seconds()) < 1) {
+            start_push();
         }
         else {
-            auto now = fc::time_point::now();
-            if(!pushed_ && std::abs((db_.head_block_time() - now).to_seconds()) < 1) {
-                const auto& exec = app().get_io_service().get_executor();
-                for(auto i = 0u; i < total_num_; i++) {
-                    boost::asio::post(exec, std::bind(&trafficgen_plugin_impl::push_once, this, (int)i));
-                }
-                pushed_ = true;
-            }
+            schedule_generate();
         }
+        break;
+    }
+    default: {
+        break;
     }
+    }  // switch
 }
 
 void
-trafficgen_plugin_impl::push_once(int index) {
+trafficgen_plugin_impl::push_once(const transaction_metadata_ptr& trx) {
+    sent_++;
     try {
-        auto ptrx = packed_trxs_[index];
-        app().get_method<chain::plugin_interface::incoming::methods::transaction_async>()(std::make_shared<transaction_metadata>(ptrx), true, [index](const auto& result) -> void {
+        app().get_method<chain::plugin_interface::incoming::methods::transaction_async>()(trx, true, [self = shared_from_this(), trx, start = fc::time_point::now()](const auto& result) -> void {
+            self->latencies_.emplace_back((uint32_t)(fc::time_point::now() - start).count());
             if(result.template contains<fc::exception_ptr>()) {
-                wlog("Push failed at index: ${i}, e: ${e}", ("i",index)("e",*result.template get<fc::exception_ptr>()));
+                self->failed_++;
+                dlog("Push failed for trx: ${id}, e: ${e}", ("id",trx->id)("e",*result.template get<fc::exception_ptr>()));
             }
         });
     }
@@ -281,7 +523,9 @@ trafficgen_plugin_impl::push_once(int index) {
         raise(SIGUSR1);
     }
     catch(...) {
-        wlog("Push failed at index: ${i}", ("i",index));
+        failed_++;
+        push_failed_++;
+        wlog("Push failed for trx: ${id}", ("id",trx->id));
     }
 }
 
@@ -292,28 +536,32 @@ trafficgen_plugin::set_program_options(options_description&, options_description
         ("traffic-total", bpo::value<size_t>()->default_value(0), "Total transactions to be generated")
         ("traffic-from", bpo::value<std::string>(), "Address of sender when generating")
         ("traffic-from-priv", bpo::value<std::string>(), "Private key of sender when generating")
-        ("traffic-type", bpo::value<std::string>()->default_value("ft"), "Type of transactions, can be 'nft' or 'ft'")
+        ("traffic-type", bpo::value<std::string>()->default_value("ft"), "Type of transactions, can be 'nft', 'ft' or a weighted mix like 'ft:3,nft:1'")
+        ("traffic-rate", bpo::value<uint32_t>()->default_value(0), "Target transactions pushed per second regardless of responses, 0 for as fast as possible")
+        ("traffic-threads", bpo::value<uint32_t>()->default_value(2), "Number of threads generating and signing transactions")
+        ("traffic-report-interval", bpo::value<uint32_t>()->default_value(5), "Seconds between reports of tps and latencies, 0 to only report at the end")
     ;
 }
 
 void
 trafficgen_plugin::plugin_initialize(const variables_map& options) {
     my_ = std::make_shared<trafficgen_plugin_impl>(app().get_plugin<chain_plugin>().chain());
-    my_->start_num_ = options.at("traffic-start-num").as<uint32_t>();
-    my_->total_num_ = options.at("traffic-total").as<size_t>();
+    my_->start_num_       = options.at("traffic-start-num").as<uint32_t>();
+    my_->total_num_       = options.at("traffic-total").as<size_t>();
+    my_->rate_            = options.at("traffic-rate").as<uint32_t>();
+    my_->threads_         = options.at("traffic-threads").as<uint32_t>();
+    my_->report_interval_ = options.at("traffic-report-interval").as<uint32_t>();
 
-    EVT_ASSERT(my_->total_num_ <= 200'000, chain::plugin_config_exception, "Total number of generating transactions cannot be large than 200'000");
+    EVT_ASSERT(my_->threads_ > 0, chain::plugin_config_exception, "Number of trafficgen threads should be greater than 0");
+
+    if(options.count("traffic-type")) {
+        my_->parse_mix(options.at("traffic-type").as<std::string>());
+    }
 
     if(options.count("traffic-from") && options.count("traffic-from-priv")) {
         my_->from_addr_ = address(options.at("traffic-from").as<std::string>());
         my_->from_priv_ = private_key_type(options.at("traffic-from-priv").as<std::string>());
-        my_->init(); 
-    }
-
-    if(options.count("traffic-type")) {
-        auto type = options.at("traffic-type").as<std::string>();
-        EVT_ASSERT(type == "ft" || type == "nft", chain::plugin_config_exception, "Not valid value for --traffic-type option");
-        my_->type_ = type;
+        my_->init();
     }
 }
 
@@ -324,7 +572,7 @@ trafficgen_plugin::plugin_startup() {
 
 void
 trafficgen_plugin::plugin_shutdown() {
-    my_->accepted_block_connection_.reset();
+    my_->shutdown();
     my_.reset();
 }
 
@@ -1640,3 +1640,24 @@ TEST_CASE("setpsvbonus_v2_abi_test", "[abis]") {
     verify_byte_round_trip_conversion(abis, "setpsvbonus", var);
     verify_type_round_trip_conversion<setpsvbonus>(abis, "setpsvbonus", var);
 }
+
+TEST_CASE("setpsvbonus_v3_abi_test", "[abis]") {
+    auto& abis = get_evt_abi();
+
+    auto var = fc::json::from_string(setpsvbonus_test_data);
+    auto mv  = fc::mutable_variant_object(var);
+    mv["sym_id"] = 5;
+    var = mv;
+
+    auto psb = var.as<setpsvbonus_v3>();
+
+    CHECK(psb.sym_id == 5);
+    CHECK(psb.rate.to_string() == "0.15");
+    CHECK(psb.dist_threshold == asset(50'00000, symbol(5,3)));
+    CHECK(psb.rules.size() == 3);
+    CHECK(psb.methods.size() == 2);
+
+    get_exec_ctx().set_version("setpsvbonus", 3);
+    verify_byte_round_trip_conversion(abis, "setpsvbonus", var);
+    verify_type_round_trip_conversion<setpsvbonus_v3>(abis, "setpsvbonus", var);
+}
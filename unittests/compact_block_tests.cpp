@@ -0,0 +1,154 @@
+#include <catch/catch.hpp>
+
+#include <evt/net_plugin/compact_block.hpp>
+
+using namespace evt;
+using namespace evt::chain;
+
+namespace {
+
+chain_id_type
+get_chain_id() {
+    auto hash = fc::sha256::hash(std::string("test"));
+    return *(chain_id_type*)&hash;
+}
+
+packed_transaction
+make_trx(uint32_t max_charge, const std::string& seed) {
+    auto strx = signed_transaction();
+    strx.max_charge = max_charge;
+    strx.actions.emplace_back(action(".test", ".test", ".test", bytes(100, 'a')));
+    strx.sign(private_key_type::regenerate<fc::ecc::private_key_shim>(fc::sha256::hash(seed)), get_chain_id());
+
+    return packed_transaction(strx);
+}
+
+}  // namespace
+
+TEST_CASE("test_compact_block_rebuild", "[net]") {
+    auto trxs = std::vector<packed_transaction>();
+    for(auto i = 0u; i < 4; i++) {
+        trxs.emplace_back(make_trx(1000 + i, "key"));
+    }
+
+    auto sb = signed_block();
+    sb.producer = N(evt);
+    for(auto& trx : trxs) {
+        sb.transactions.emplace_back(transaction_receipt(trx));
+    }
+    sb.transactions[3].type = transaction_receipt::suspend;
+
+    auto sids = std::vector<transaction_id_type>();
+    for(auto& r : sb.transactions) {
+        sids.emplace_back(get_signed_id(r.trx));
+    }
+
+    // peer is known to have #0, #1 and #2, suspend transaction #3 is always sent
+    auto cb = make_compact_block(sb, sids, [&](auto& sid) { return sid != sids[3]; });
+    REQUIRE(cb.prefilled.size() == 1);
+    CHECK(cb.prefilled[0].index == 3);
+    CHECK(cb.header.id() == sb.id());
+
+    auto cb2 = fc::raw::unpack<compact_block_message>(fc::raw::pack(cb));
+
+    // peer has #0 and #1, and #2 with different signatures which cannot be used
+    auto trx2 = make_trx(1002, "key2");
+    CHECK(trx2.id() == trxs[2].id());
+    CHECK(get_signed_id(trx2) != sids[2]);
+
+    auto local = std::map<transaction_id_type, packed_transaction_ptr>();
+    for(auto trx : { &trxs[0], &trxs[1], &trx2 }) {
+        local.emplace(get_signed_id(*trx), std::make_shared<packed_transaction>(*trx));
+    }
+    auto find = [&](auto& sid) {
+        auto it = local.find(sid);
+        return it != local.end() ? it->second : packed_transaction_ptr();
+    };
+
+    auto pending = pending_compact_block();
+    REQUIRE(rebuild_compact_block(cb2, find, pending));
+    CHECK(pending.id == sb.id());
+    REQUIRE(pending.missing == std::vector<uint32_t>{ 2 });
+
+    // missing transactions are requested from and sent by peer
+    auto req = get_block_txns_message();
+    req.id      = pending.id;
+    req.indexes = pending.missing;
+
+    auto resp = block_txns_message();
+    REQUIRE(make_block_txns(sb, fc::raw::unpack<get_block_txns_message>(fc::raw::pack(req)), resp));
+    REQUIRE(resp.trxs.size() == 1);
+
+    REQUIRE(fill_compact_block(pending, fc::raw::unpack<block_txns_message>(fc::raw::pack(resp))));
+    CHECK(pending.missing.empty());
+    CHECK(pending.block->id() == sb.id());
+    CHECK(fc::raw::pack(*pending.block) == fc::raw::pack(sb));
+    for(auto i = 0u; i < sb.transactions.size(); i++) {
+        CHECK(pending.block->transactions[i].digest() == sb.transactions[i].digest());
+    }
+}
+
+TEST_CASE("test_compact_block_invalid", "[net]") {
+    auto sb = signed_block();
+    sb.transactions.emplace_back(transaction_receipt(make_trx(1000, "key")));
+
+    auto sids = std::vector<transaction_id_type>{ get_signed_id(sb.transactions[0].trx) };
+    auto all  = [](auto&) { return true; };
+    auto none = [](auto&) { return packed_transaction_ptr(); };
+
+    auto pending = pending_compact_block();
+    {
+        auto cb = make_compact_block(sb, sids, all);
+        cb.ids.emplace_back(sids[0]);
+        CHECK(!rebuild_compact_block(cb, none, pending));
+    }
+    {
+        auto cb = make_compact_block(sb, sids, all);
+        cb.prefilled.emplace_back(prefilled_transaction{1, packed_transaction(sb.transactions[0].trx)});
+        CHECK(!rebuild_compact_block(cb, none, pending));
+    }
+
+    auto cb = make_compact_block(sb, sids, all);
+    CHECK(cb.prefilled.empty());
+    REQUIRE(rebuild_compact_block(cb, none, pending));
+    CHECK(pending.missing.size() == 1);
+
+    auto req    = get_block_txns_message();
+    req.id      = pending.id;
+    req.indexes = { 1 };
+
+    auto resp = block_txns_message();
+    CHECK(!make_block_txns(sb, req, resp));
+
+    resp.id = pending.id;
+    CHECK(!fill_compact_block(pending, resp));
+    CHECK(pending.missing.size() == 1);
+}
+
+TEST_CASE("test_pending_compact_blocks", "[net]") {
+    auto index = pending_compact_block_index();
+    auto ids   = std::vector<block_id_type>();
+    for(auto i = 0u; i <= max_pending_compact_blocks; i++) {
+        ids.emplace_back(fc::sha256::hash(std::to_string(i)));
+    }
+
+    for(auto i = 0u; i < max_pending_compact_blocks; i++) {
+        add_pending_compact(index, pending_compact_block{ids[i], nullptr, { i }});
+    }
+    CHECK(index.size() == max_pending_compact_blocks);
+
+    // same block replaces the pending one
+    add_pending_compact(index, pending_compact_block{ids[1], nullptr, { 100 }});
+    CHECK(index.size() == max_pending_compact_blocks);
+    CHECK(index.get<by_id>().find(ids[1])->missing == std::vector<uint32_t>{ 100 });
+
+    // oldest one is dropped
+    add_pending_compact(index, pending_compact_block{ids.back(), nullptr, {}});
+    CHECK(index.size() == max_pending_compact_blocks);
+    CHECK(index.get<by_id>().count(ids[0]) == 0);
+    CHECK(index.get<by_id>().count(ids[1]) == 1);
+    CHECK(index.get<by_id>().count(ids.back()) == 1);
+
+    index.get<by_id>().erase(ids[2]);
+    CHECK(index.get<by_id>().count(ids[2]) == 0);
+}
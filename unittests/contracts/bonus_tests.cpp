@@ -1,7 +1,9 @@
 #include "contracts_tests.hpp"
+#include <fc/crypto/sha256.hpp>
 #include <evt/chain/address.hpp>
+#include <evt/evt_plugin/evt_plugin.hpp>
 
-enum psvbonus_type { kPsvBonus = 0, kPsvBonusSlim };
+enum psvbonus_type { kPsvBonus = 0, kPsvBonusSlim, kPsvBonusHolders };
 
 name128
 get_psvbonus_db_key(symbol_id_type id, uint64_t nonce) {
@@ -10,6 +12,36 @@ get_psvbonus_db_key(symbol_id_type id, uint64_t nonce) {
     return v;
 }
 
+// upgrades `setpsvbonus` to v3 and `distpsvbonus` to v2 by the votes of the only producer
+void
+upgrade_psvbonus(tester& t, const std::vector<name>& seeds, const address& payer) {
+    auto pv     = prodvote();
+    pv.producer = N(evt);
+    pv.key      = N128(action-setpsvbonus);
+    pv.value    = 3;
+    t.push_action(action(N128(.prodvote), pv.key, pv), seeds, payer);
+
+    pv.key   = N128(action-distpsvbonus);
+    pv.value = 2;
+    t.push_action(action(N128(.prodvote), pv.key, pv), seeds, payer);
+}
+
+// rounds distributed since `distpsvbonus` v2 are led by zero and followed by the index of their kind
+std::pair<uint32_t, uint32_t>
+read_round_tag(const token_database& tokendb, symbol_id_type sym_id, uint64_t round) {
+    auto str = std::string();
+    tokendb.read_token(token_type::psvbonus_dist, std::nullopt, get_psvbonus_db_key(sym_id, round), str);
+
+    auto ds   = fc::datastream<const char*>(str.data(), str.size());
+    auto lead = uint32_t(0);
+    auto idx  = fc::unsigned_int();
+    fc::raw::unpack(ds, lead);
+    if(lead == 0) {
+        fc::raw::unpack(ds, idx);
+    }
+    return std::make_pair(lead, idx.value);
+}
+
 auto CHECK_EQUAL = [](auto& lhs, auto& rhs) {
     auto b1 = fc::raw::pack(lhs);
     auto b2 = fc::raw::pack(rhs);
@@ -201,6 +233,10 @@ TEST_CASE_METHOD(contracts_test, "passive_bonus_test", "[contracts]") {
     CHECK(pb.deadline == pb2->deadline);
 
     CHECK(pb.rate.value() == evt::chain::percent_type("0.15"));
+
+    // holders aggregate is not maintained by `setpsvbonus` v1
+    CHECK(!tokendb.exists_token(token_type::psvbonus, std::nullopt, get_psvbonus_db_key(get_sym_id(), kPsvBonusHolders)));
+    CHECK(!tokendb.exists_token(token_type::psvbonus, std::nullopt, get_psvbonus_db_key(EVT_SYM_ID, kPsvBonusHolders)));
 }
 
 TEST_CASE_METHOD(contracts_test, "passive_bonus_fees_test", "[contracts]") {
@@ -335,7 +371,7 @@ TEST_CASE_METHOD(contracts_test, "passive_bonus_fees_test", "[contracts]") {
 
 TEST_CASE_METHOD(contracts_test, "passive_bonus_dist_test", "[contracts]") {
     auto& tokendb = my_tester->control->token_db();
-    auto cache = my_tester->control->token_db_cache();
+    auto& cache = my_tester->control->token_db_cache();
     CHECK(tokendb.exists_token(token_type::psvbonus, std::nullopt, get_psvbonus_db_key(get_sym_id(), kPsvBonus)));
 
     auto actkey     = name128::from_number(get_sym_id());
@@ -389,6 +425,8 @@ TEST_CASE_METHOD(contracts_test, "passive_bonus_dist_test", "[contracts]") {
     }
 
     CHECK(tokendb.exists_token(token_type::psvbonus_dist, std::nullopt, get_psvbonus_db_key(get_sym_id(), 1)));
+    // round distributed by `distpsvbonus` v1 is untagged
+    CHECK(read_round_tag(tokendb, get_sym_id(), 1).first != 0);
 
     my_tester->produce_block();
 
@@ -407,4 +445,411 @@ TEST_CASE_METHOD(contracts_test, "passive_bonus_dist_test", "[contracts]") {
     CHECK(pb.methods.size() == pb2->methods.size());
     CHECK(pb.round == pb2->round);
     CHECK(pb.deadline == pb2->deadline);
-}
\ No newline at end of file
+}
+
+TEST_CASE_METHOD(contracts_test, "passive_bonus_holders_test", "[contracts]") {
+    auto& tokendb = my_tester->control->token_db();
+    auto& cache   = my_tester->control->token_db_cache();
+
+    // holders aggregate should always be the same as the one built by scanning all the holders
+    auto check_holders = [&](auto sym_id) {
+        auto fh = cache.read_token<fungible_holders>(token_type::psvbonus, std::nullopt, get_psvbonus_db_key(sym_id, kPsvBonusHolders));
+        CHECK(fh != nullptr);
+        CHECK(fh->sym_id == sym_id);
+
+        auto total = 0l;
+        auto count = 0u;
+        auto buckets = holder_buckets(fh->buckets.size());
+        tokendb.read_assets_range(sym_id, 0, [&](auto& k, auto&& v) {
+            property prop;
+            extract_db_value(v, prop);
+
+            total += prop.amount;
+            count += (prop.amount > 0);
+            for(auto i = 0u; i < buckets.size(); i++) {
+                if(prop.amount > 0 && prop.amount >= fh->buckets[i].threshold) {
+                    buckets[i].total += prop.amount;
+                    buckets[i].count++;
+                }
+            }
+            return true;
+        });
+
+        CHECK(fh->total == total);
+        CHECK(fh->count == count);
+        for(auto i = 0u; i < buckets.size(); i++) {
+            CHECK(fh->buckets[i].total == buckets[i].total);
+            CHECK(fh->buckets[i].count == buckets[i].count);
+        }
+        return fh->buckets.size();
+    };
+
+    upgrade_psvbonus(*my_tester, key_seeds, payer);
+    CHECK(my_tester->control->get_execution_context().get_current_version(N(setpsvbonus)) == 3);
+    CHECK(my_tester->control->get_execution_context().get_current_version(N(distpsvbonus)) == 2);
+
+    // S#12 pays the bonus to the holders of S#3 and EVT
+    auto bsym = symbol(5, get_sym_id(9));
+
+    auto perm = permission_def();
+    perm.threshold = 1;
+    perm.authorizers.emplace_back(authorizer_weight(authorizer_ref(key), 1));
+
+    auto nf         = newfungible();
+    nf.name         = get_symbol_name();
+    nf.sym_name     = get_symbol_name();
+    nf.sym          = bsym;
+    nf.creator      = key;
+    nf.issue        = perm;
+    nf.issue.name   = N(issue);
+    nf.manage       = perm;
+    nf.manage.name  = N(manage);
+    nf.total_supply = asset(1'000'00000, bsym);
+    my_tester->push_action(action(N128(.fungible), name128::from_number(bsym.id()), nf), key_seeds, payer);
+
+    auto rule1     = dist_percent_rule_v2();
+    rule1.receiver = dist_stack_receiver(asset(1'00000, get_sym()));
+    rule1.percent  = percent_type("0.5");
+
+    auto rule2     = dist_rpercent_rule_v2();
+    rule2.receiver = dist_stack_receiver(asset(1'00000, evt_sym()));
+    rule2.percent  = percent_type("1");
+
+    auto spb           = setpsvbonus_v3();
+    spb.sym_id         = bsym.id();
+    spb.rate           = percent_type("0.1");
+    spb.base_charge    = asset(0, bsym);
+    spb.dist_threshold = asset(100, bsym);
+    spb.rules.emplace_back(rule1);
+    spb.rules.emplace_back(rule2);
+
+    // aggregates are built by `setpsvbonus` v3
+    my_tester->push_action(action(N128(.psvbonus), name128::from_number(bsym.id()), spb), key_seeds, payer);
+    my_tester->produce_block();
+
+    // aggregate of EVT is not checked here because `add_money` of tester writes balances directly
+    CHECK(check_holders(get_sym_id()) == 1);
+    CHECK(tokendb.exists_token(token_type::psvbonus, std::nullopt, get_psvbonus_db_key(EVT_SYM_ID, kPsvBonusHolders)));
+
+    auto tf   = transferft();
+    tf.from   = key;
+    tf.to     = tester::get_public_key(N(to5));
+    tf.number = asset(3'00000, get_sym());
+
+    my_tester->push_action(action(N128(.fungible), name128::from_number(get_sym_id()), tf), key_seeds, payer);
+    my_tester->produce_block();
+
+    check_holders(get_sym_id());
+}
+
+name128
+get_holder_bonus_db_key(symbol_id_type sym_id, const address& addr) {
+    char buf[sizeof(sym_id) + sizeof(fc::ecc::public_key_shim)];
+    memcpy(buf, &sym_id, sizeof(sym_id));
+    addr.to_bytes(buf + sizeof(sym_id), addr.get_bytes_size());
+
+    auto h = fc::sha256::hash(buf, sizeof(buf));
+    auto v = uint128_t();
+    memcpy(&v, h.data(), sizeof(v));
+
+    v |= ((uint128_t)1 << 127);
+    return v;
+}
+
+TEST_CASE_METHOD(contracts_test, "passive_bonus_lazy_dist_test", "[contracts]") {
+    auto& tokendb = my_tester->control->token_db();
+    auto& cache   = my_tester->control->token_db_cache();
+
+    // S#8 pays the bonus to the holders of S#9, S#10 pays to the holders no one reaches
+    auto bsym  = symbol(5, get_sym_id(5));
+    auto hsym  = symbol(5, get_sym_id(6));
+    auto bsym2 = symbol(5, get_sym_id(7));
+
+    auto new_fungible = [&](auto sym, auto supply) {
+        auto perm = permission_def();
+        perm.threshold = 1;
+        perm.authorizers.emplace_back(authorizer_weight(authorizer_ref(key), 1));
+
+        auto nf         = newfungible();
+        nf.name         = get_symbol_name();
+        nf.sym_name     = get_symbol_name();
+        nf.sym          = sym;
+        nf.creator      = key;
+        nf.issue        = perm;
+        nf.issue.name   = N(issue);
+        nf.manage       = perm;
+        nf.manage.name  = N(manage);
+        nf.total_supply = asset(supply, sym);
+
+        my_tester->push_action(action(N128(.fungible), name128::from_number(sym.id()), nf), key_seeds, payer);
+    };
+    auto issue = [&](const address& addr, const asset& number) {
+        auto isf    = issuefungible();
+        isf.address = addr;
+        isf.number  = number;
+
+        my_tester->push_action(action(N128(.fungible), name128::from_number(number.symbol_id()), isf), key_seeds, payer);
+    };
+    auto transfer = [&](auto from, const address& to, const asset& number) {
+        auto tf   = transferft();
+        tf.from   = tester::get_public_key(from);
+        tf.to     = to;
+        tf.number = number;
+
+        auto seeds = std::vector<name>{ from, N(payer) };
+        my_tester->push_action(action(N128(.fungible), name128::from_number(number.symbol_id()), tf), seeds, payer);
+    };
+    auto set_bonus = [&](auto sym, const asset& threshold) {
+        auto rule     = dist_percent_rule_v2();
+        rule.receiver = dist_stack_receiver(threshold);
+        rule.percent  = percent_type("1");
+
+        auto spb           = setpsvbonus_v3();
+        spb.sym_id         = sym.id();
+        spb.rate           = percent_type("0.1");
+        spb.base_charge    = asset(0, sym);
+        spb.dist_threshold = asset(100, sym);
+        spb.rules.emplace_back(rule);
+
+        my_tester->push_action(action(N128(.psvbonus), name128::from_number(sym.id()), spb), key_seeds, payer);
+    };
+    auto dist_bonus = [&](auto sym, const optional<address>& final_receiver = {}) {
+        auto dpb           = distpsvbonus_v2();
+        dpb.sym_id         = sym.id();
+        dpb.deadline       = my_tester->control->head_block_time();
+        dpb.final_receiver = final_receiver;
+
+        my_tester->push_action(action(N128(.psvbonus), name128::from_number(sym.id()), dpb), key_seeds, payer);
+    };
+    // amount of bonus from the api, it's the pending amount plus the unsettled one
+    auto get_bonus = [&](auto seed) {
+        auto params    = evt_apis::read_only::get_psvbonus_holder_params();
+        params.id      = bsym.id();
+        params.address = tester::get_public_key(seed);
+
+        auto vars = evt_apis::read_only(*my_tester->control).get_psvbonus_holder(params).get_array();
+        CHECK(vars.size() == 1);
+        CHECK(vars[0]["rule_index"].as<uint32_t>() == 0);
+        CHECK(vars[0]["threshold"].as<asset>() == asset(2'00000, hsym));
+        return vars[0]["amount"].as<asset>();
+    };
+
+    auto a = tester::get_public_key(N(holdera));
+    auto b = tester::get_public_key(N(holderb));
+    auto c = tester::get_public_key(N(holderc));
+    auto d = tester::get_public_key(N(holderd));
+    auto x = tester::get_public_key(N(holderx));
+
+    upgrade_psvbonus(*my_tester, key_seeds, payer);
+
+    new_fungible(bsym, 1'000'00000);
+    new_fungible(hsym, 10'50000);
+    new_fungible(bsym2, 1'000'00000);
+
+    issue(key, asset(1'000'00000, bsym));
+    issue(key, asset(1'000'00000, bsym2));
+    issue(a, asset(6'00000, hsym));
+    issue(b, asset(3'00000, hsym));
+    issue(c, asset(1'00000, hsym));
+    issue(d, asset(50000, hsym));
+
+    // threshold: 2.00000, c and d are below it
+    set_bonus(bsym, asset(2'00000, hsym));
+    my_tester->produce_block();
+
+    // round 1: fees 0.1 * 10000 = 1000, eligible total: 9'00000
+    transfer(N(key), x, asset(10000, bsym));
+    dist_bonus(bsym);
+    my_tester->produce_block();
+
+    CHECK(get_bonus(N(holdera)) == asset(666, bsym));  // 1000 * 6 / 9
+    CHECK(get_bonus(N(holderb)) == asset(333, bsym));  // 1000 * 3 / 9
+    CHECK(get_bonus(N(holderc)) == asset(0, bsym));
+    CHECK(get_bonus(N(holderd)) == asset(0, bsym));
+
+    // a: 2.00000 still reaches threshold, c: 5.00000 reaches it now
+    transfer(N(holdera), c, asset(4'00000, hsym));
+    my_tester->produce_block();
+
+    {
+        // a and c are settled with the balances held in round 1
+        auto acc = (uint128_t)1000 * evt::chain::config::psvbonus_acc_scale / 9'00000;
+
+        auto hba = cache.read_token<holder_bonus>(token_type::psvbonus_dist, std::nullopt, get_holder_bonus_db_key(hsym.id(), a));
+        REQUIRE(hba != nullptr);
+        REQUIRE(hba->entries.size() == 1);
+        CHECK(hba->entries[0].pending == 666);
+        CHECK(hba->entries[0].acc == acc);
+
+        auto hbc = cache.read_token<holder_bonus>(token_type::psvbonus_dist, std::nullopt, get_holder_bonus_db_key(hsym.id(), c));
+        REQUIRE(hbc != nullptr);
+        REQUIRE(hbc->entries.size() == 1);
+        CHECK(hbc->entries[0].pending == 0);
+        CHECK(hbc->entries[0].acc == acc);
+
+        // b and d are never settled
+        CHECK(!tokendb.exists_token(token_type::psvbonus_dist, std::nullopt, get_holder_bonus_db_key(hsym.id(), b)));
+        CHECK(!tokendb.exists_token(token_type::psvbonus_dist, std::nullopt, get_holder_bonus_db_key(hsym.id(), d)));
+    }
+
+    CHECK(get_bonus(N(holdera)) == asset(666, bsym));
+    CHECK(get_bonus(N(holderc)) == asset(0, bsym));
+
+    // round 2: fees 0.1 * 20000 = 2000, eligible total: 10'00000
+    transfer(N(key), x, asset(20000, bsym));
+    dist_bonus(bsym);
+    my_tester->produce_block();
+
+    auto bonus_a = get_bonus(N(holdera));
+    auto bonus_b = get_bonus(N(holderb));
+    auto bonus_c = get_bonus(N(holderc));
+    auto bonus_d = get_bonus(N(holderd));
+    CHECK(bonus_a == asset(666 + 400, bsym));   // 2000 * 2 / 10
+    CHECK(bonus_b == asset(333 + 600, bsym));   // 2000 * 3 / 10
+    CHECK(bonus_c == asset(1000, bsym));        // 2000 * 5 / 10
+    CHECK(bonus_d == asset(0, bsym));
+
+    // the same as distributing each round by the balances at that time
+    auto eager = [](int64_t amount, int64_t balance, int64_t total) { return amount * balance / total; };
+    CHECK(bonus_a.amount() == eager(1000, 6'00000, 9'00000) + eager(2000, 2'00000, 10'00000));
+    CHECK(bonus_b.amount() == eager(1000, 3'00000, 9'00000) + eager(2000, 3'00000, 10'00000));
+    CHECK(bonus_c.amount() == eager(2000, 5'00000, 10'00000));
+
+    // never exceeds the amounts of both rounds
+    auto sum = bonus_a.amount() + bonus_b.amount() + bonus_c.amount() + bonus_d.amount();
+    CHECK(sum <= 1000 + 2000);
+    CHECK(sum == 2999);
+
+    {
+        property round1, round2;
+        READ_DB_ASSET(address(N(.psvbonus), name128::from_number(bsym.id()), 1), bsym, round1);
+        READ_DB_ASSET(address(N(.psvbonus), name128::from_number(bsym.id()), 2), bsym, round2);
+        CHECK(round1.amount == 1000);
+        CHECK(round2.amount == 2000);
+    }
+
+    // rounds distributed lazily are tagged as `bonusdist_lazy`
+    CHECK(read_round_tag(tokendb, bsym.id(), 1) == std::make_pair(0u, 1u));
+    CHECK(read_round_tag(tokendb, bsym.id(), 2) == std::make_pair(0u, 1u));
+
+    // threshold: 7.00000, no holder reaches it
+    set_bonus(bsym2, asset(7'00000, hsym));
+    transfer(N(key), x, asset(10000, bsym2));
+    my_tester->produce_block();
+
+    auto final_receiver = address(tester::get_public_key(N(final)));
+    CHECK_THROWS_AS(dist_bonus(bsym2), bonus_receiver_exception);
+    dist_bonus(bsym2, final_receiver);
+    my_tester->produce_block();
+
+    {
+        property round1, receiver;
+        READ_DB_ASSET(address(N(.psvbonus), name128::from_number(bsym2.id()), 1), bsym2, round1);
+        READ_DB_ASSET(final_receiver, bsym2, receiver);
+        CHECK(round1.amount == 0);
+        CHECK(receiver.amount == 1000);
+    }
+}
+
+TEST_CASE_METHOD(contracts_test, "passive_bonus_many_holders_test", "[contracts]") {
+    auto& cache = my_tester->control->token_db_cache();
+
+    // holder #i holds i * 0.01000 of S#11, all the supply is issued
+    auto sym = symbol(5, get_sym_id(8));
+    auto n   = 500u;
+
+    auto perm = permission_def();
+    perm.threshold = 1;
+    perm.authorizers.emplace_back(authorizer_weight(authorizer_ref(key), 1));
+
+    auto nf         = newfungible();
+    nf.name         = get_symbol_name();
+    nf.sym_name     = get_symbol_name();
+    nf.sym          = sym;
+    nf.creator      = key;
+    nf.issue        = perm;
+    nf.issue.name   = N(issue);
+    nf.manage       = perm;
+    nf.manage.name  = N(manage);
+    nf.total_supply = asset(1000l * n * (n + 1) / 2, sym);
+    my_tester->push_action(action(N128(.fungible), name128::from_number(sym.id()), nf), key_seeds, payer);
+
+    for(auto i = 1u; i <= n; i++) {
+        auto isf    = issuefungible();
+        isf.address = private_key_type::regenerate<fc::ecc::private_key_shim>(fc::sha256::hash("holder" + std::to_string(i))).get_public_key();
+        isf.number  = asset(1000l * i, sym);
+        my_tester->push_action(action(N128(.fungible), name128::from_number(sym.id()), isf), key_seeds, payer);
+
+        if(i % 100 == 0) {
+            my_tester->produce_block();
+        }
+    }
+
+    auto rule     = dist_percent_rule_v2();
+    rule.receiver = dist_stack_receiver(asset(1000l * 400, sym));
+    rule.percent  = percent_type("1");
+
+    auto spb           = setpsvbonus_v3();
+    spb.sym_id         = sym.id();
+    spb.rate           = percent_type("0.1");
+    spb.base_charge    = asset(0, sym);
+    spb.dist_threshold = asset(100, sym);
+    spb.rules.emplace_back(rule);
+
+    // aggregate is built from all the existing holders at once
+    upgrade_psvbonus(*my_tester, key_seeds, payer);
+    my_tester->push_action(action(N128(.psvbonus), name128::from_number(sym.id()), spb), key_seeds, payer);
+    my_tester->produce_block();
+
+    auto fh = cache.read_token<fungible_holders>(token_type::psvbonus, std::nullopt, get_psvbonus_db_key(sym.id(), kPsvBonusHolders));
+    REQUIRE(fh != nullptr);
+    CHECK(fh->total == 1000l * n * (n + 1) / 2);
+    CHECK(fh->count == n);
+    REQUIRE(fh->buckets.size() == 1);
+    CHECK(fh->buckets[0].threshold == 1000l * 400);
+    CHECK(fh->buckets[0].count == n - 400 + 1);
+    CHECK(fh->buckets[0].total == 1000l * (400 + n) * (n - 400 + 1) / 2);
+}
+
+TEST_CASE_METHOD(contracts_test, "passive_bonus_holders_producer_payer_test", "[contracts]") {
+    auto& tokendb = my_tester->control->token_db();
+    auto& cache   = my_tester->control->token_db_cache();
+
+    // producer of tester signs with the key of `evt`
+    auto prod = address(tester::get_public_key("evt"));
+
+    auto tf   = transferft();
+    tf.from   = payer;
+    tf.to     = prod;
+    tf.number = asset(100'00000, evt_sym());
+    my_tester->push_action(action(N128(.fungible), name128::from_number(EVT_SYM_ID), tf), key_seeds, payer);
+    my_tester->produce_block();
+
+    // EVT is used by `ftholders` receiver in `passive_bonus_holders_test`
+    auto fh1 = *cache.read_token<fungible_holders>(token_type::psvbonus, std::nullopt, get_psvbonus_db_key(EVT_SYM_ID, kPsvBonusHolders));
+    REQUIRE(fh1.buckets.size() > 0);
+
+    property bp1;
+    READ_DB_ASSET(prod, evt_sym(), bp1);
+
+    // charge is paid by producer and given to producer
+    tf.from   = key;
+    tf.to     = tester::get_public_key(N(to6));
+    tf.number = asset(1, get_sym());
+    auto seeds = std::vector<name>{ N(key), "evt" };
+    my_tester->push_action(action(N128(.fungible), name128::from_number(get_sym_id()), tf), seeds, prod);
+    my_tester->produce_block();
+
+    property bp2;
+    READ_DB_ASSET(prod, evt_sym(), bp2);
+    CHECK(bp2.amount == bp1.amount);
+
+    auto fh2 = *cache.read_token<fungible_holders>(token_type::psvbonus, std::nullopt, get_psvbonus_db_key(EVT_SYM_ID, kPsvBonusHolders));
+    CHECK(fh2.total == fh1.total);
+    CHECK(fh2.count == fh1.count);
+    REQUIRE(fh2.buckets.size() == fh1.buckets.size());
+    for(auto i = 0u; i < fh1.buckets.size(); i++) {
+        CHECK(fh2.buckets[i].total == fh1.buckets[i].total);
+        CHECK(fh2.buckets[i].count == fh1.buckets[i].count);
+    }
+}
@@ -3,6 +3,7 @@
 #include <catch/catch.hpp>
 #include <fc/filesystem.hpp>
 
+#include <evt/chain/thread_utils.hpp>
 #include <evt/chain/token_database.hpp>
 #include <evt/chain/token_database_snapshot.hpp>
 #include <evt/chain/contracts/types.hpp>
@@ -14,6 +15,7 @@ using namespace contracts;
 extern std::string evt_unittests_dir;
 
 string token_db_snapshot_;
+string token_db_chunked_snapshot_;
 
 #define EXISTS_TOKEN(TYPE, NAME) \
     tokendb.exists_token(evt::chain::token_type::TYPE, std::nullopt, NAME)
@@ -113,3 +115,255 @@ TEST_CASE("snapshot_load_test", "[snapshot]") {
     CHECK(EXISTS_ASSET(addr, 3));
     CHECK(EXISTS_TOKEN(domain, "snapshot-domain"));
 }
+
+TEST_CASE("snapshot_chunked_format_test", "[snapshot]") {
+    auto ss     = std::stringstream();
+    auto writer = std::make_shared<chunked_snapshot_writer>(ss, 64);
+    auto pool   = boost::asio::thread_pool(4);
+
+    auto names   = std::vector<std::string>{ "section-a", "section-b", "section-c", "section-d", "section-empty" };
+    auto futures = std::vector<std::future<void>>();
+    for(auto& n : names) {
+        futures.emplace_back(async_thread_pool(pool, [&writer, &n] {
+            writer->write_section(n, [&n](auto& w) {
+                if(n == "section-empty") {
+                    return;
+                }
+                for(auto i = 0; i < 100; i++) {
+                    w.add_row(n + "-" + std::to_string(i));
+                }
+            });
+        }));
+    }
+    wait_all_futures(futures);
+    writer->finalize();
+
+    auto data = ss.str();
+    {
+        auto ss2 = std::stringstream(data);
+        REQUIRE(chunked_snapshot_reader::is_chunked_snapshot(ss2));
+
+        auto reader = make_snapshot_reader(ss2);
+        REQUIRE(reader->concurrent());
+        CHECK_NOTHROW(reader->validate());
+        CHECK(reader->get_section_names("section-").size() == names.size());
+
+        // assertions of catch are not thread-safe, collect the rows and check them in main thread
+        auto rows = std::vector<std::future<std::vector<std::string>>>();
+        for(auto& n : names) {
+            rows.emplace_back(async_thread_pool(pool, [&reader, &n] {
+                auto vs = std::vector<std::string>();
+                reader->read_section(n, [&vs](auto& r) {
+                    while(!r.eof()) {
+                        auto v = std::string();
+                        r.read_row(v);
+                        vs.emplace_back(std::move(v));
+                    }
+                });
+                return vs;
+            }));
+        }
+        for(auto& r : rows) {
+            r.wait();
+        }
+
+        for(auto i = 0u; i < names.size(); i++) {
+            auto vs = rows[i].get();
+            if(names[i] == "section-empty") {
+                CHECK(vs.empty());
+                continue;
+            }
+            REQUIRE(vs.size() == 100);
+            for(auto j = 0u; j < vs.size(); j++) {
+                CHECK(vs[j] == names[i] + "-" + std::to_string(j));
+            }
+        }
+    }
+
+    // corrupt one byte in the data of chunks
+    data[sizeof(uint32_t) * 2 + 1] ^= 0xff;
+    {
+        auto ss2    = std::stringstream(data);
+        auto reader = make_snapshot_reader(ss2);
+
+        auto read_all = [&] {
+            for(auto& n : names) {
+                reader->read_section(n, [](auto& r) {
+                    while(!r.eof()) {
+                        auto v = std::string();
+                        r.read_row(v);
+                    }
+                });
+            }
+        };
+        CHECK_THROWS_AS(read_all(), snapshot_validation_exception);
+    }
+}
+
+TEST_CASE("snapshot_chunked_save_test", "[snapshot]") {
+    auto tokendb = token_database(get_db_config());
+    tokendb.open();
+
+    auto ss     = std::stringstream();
+    auto writer = std::make_shared<chunked_snapshot_writer>(ss, 128);
+    auto pool   = boost::asio::thread_pool(4);
+
+    token_database_snapshot::add_to_snapshot(writer, tokendb, &pool);
+    writer->finalize();
+
+    token_db_chunked_snapshot_ = ss.str();
+}
+
+TEST_CASE("snapshot_chunked_load_test", "[snapshot]") {
+    auto tokendb = token_database(get_db_config());
+    tokendb.open();
+
+    auto ss     = std::stringstream(token_db_chunked_snapshot_);
+    auto reader = make_snapshot_reader(ss);
+    auto pool   = boost::asio::thread_pool(4);
+
+    reader->validate();
+    token_database_snapshot::read_from_snapshot(reader, tokendb, &pool);
+
+    REQUIRE(tokendb.savepoints_size() == 0);
+    CHECK(EXISTS_TOKEN(domain, "dm-tkdb-test"));
+    CHECK(EXISTS_TOKEN2(token, "dm-tkdb-test", "basic-1"));
+    CHECK(EXISTS_TOKEN2(token, "dm-tkdb-test", "basic-2"));
+
+    auto addr = public_key_type(std::string("EVT8MGU4aKiVzqMtWi9zLpu8KuTHZWjQQrX475ycSxEkLd6aBpraX"));
+    CHECK(EXISTS_ASSET(addr, 3));
+    CHECK(EXISTS_TOKEN(domain, "snapshot-domain"));
+}
+
+TEST_CASE("snapshot_delta_test", "[snapshot]") {
+    auto tokendb = token_database(get_db_config());
+    tokendb.open();
+
+    REQUIRE(tokendb.savepoints_size() == 0);
+
+    // domain in savepoint when taking base snapshot, will be rolled back later
+    tokendb.add_savepoint(1);
+
+    auto d1 = domain_def();
+    d1.name = "delta-domain-rb";
+    PUT_DB_TOKEN(domain, std::nullopt, d1.name, d1);
+
+    auto base_ss     = std::stringstream();
+    auto base_writer = std::make_shared<chunked_snapshot_writer>(base_ss);
+    token_database_snapshot::add_to_snapshot(base_writer, tokendb);
+    base_writer->finalize();
+    tokendb.reset_changes();
+
+    tokendb.rollback_to_latest_savepoint();
+    CHECK(!EXISTS_TOKEN(domain, "delta-domain-rb"));
+
+    tokendb.add_savepoint(1);
+
+    auto d2 = domain_def();
+    d2.name = "delta-domain";
+    PUT_DB_TOKEN(domain, std::nullopt, d2.name, d2);
+
+    auto addr = public_key_type(std::string("EVT8MGU4aKiVzqMtWi9zLpu8KuTHZWjQQrX475ycSxEkLd6aBpraX"));
+    auto prop = property();
+    READ_DB_ASSET(addr, 3, prop);
+    prop.amount += 12345;
+
+    auto dv = make_db_value(prop);
+    tokendb.put_asset(addr, 3, dv.as_string_view());
+
+    auto changed_tokens = tokendb.read_changed_tokens([](auto&, auto&&) { return true; });
+    auto changed_assets = tokendb.read_changed_assets([](auto&, auto&&) { return true; });
+    CHECK(changed_tokens == 2);
+    CHECK(changed_assets == 1);
+
+    auto delta_ss     = std::stringstream();
+    auto delta_writer = std::make_shared<chunked_snapshot_writer>(delta_ss);
+    token_database_snapshot::add_delta_to_snapshot(delta_writer, tokendb);
+    delta_writer->finalize();
+
+    CHECK(delta_ss.str().size() < base_ss.str().size());
+
+    // restore base snapshot and apply the delta
+    auto base_reader = make_snapshot_reader(base_ss);
+    base_reader->validate();
+    token_database_snapshot::read_from_snapshot(base_reader, tokendb);
+
+    CHECK(EXISTS_TOKEN(domain, "delta-domain-rb"));
+    CHECK(!EXISTS_TOKEN(domain, "delta-domain"));
+
+    auto delta_reader = make_snapshot_reader(delta_ss);
+    delta_reader->validate();
+    token_database_snapshot::read_delta_from_snapshot(delta_reader, tokendb);
+
+    REQUIRE(tokendb.savepoints_size() == 0);
+    CHECK(!EXISTS_TOKEN(domain, "delta-domain-rb"));
+    CHECK(EXISTS_TOKEN(domain, "delta-domain"));
+    CHECK(EXISTS_TOKEN(domain, "dm-tkdb-test"));
+    CHECK(EXISTS_TOKEN2(token, "dm-tkdb-test", "basic-1"));
+
+    auto prop2 = property();
+    READ_DB_ASSET(addr, 3, prop2);
+    CHECK(prop2.amount == prop.amount);
+}
+
+TEST_CASE("snapshot_delta_overflow_test", "[snapshot]") {
+    auto cfg = get_db_config();
+    cfg.max_tracked_changes = 2;
+
+    auto tokendb = token_database(cfg);
+    tokendb.open();
+
+    CHECK(!tokendb.is_tracking_changes());
+    tokendb.reset_changes();
+    CHECK(tokendb.is_tracking_changes());
+
+    auto s = tokendb.new_savepoint_session();
+    for(auto i = 0; i < 3; i++) {
+        auto d = domain_def();
+        d.name = name128(std::string("delta-overflow-") + std::to_string(i));
+        PUT_DB_TOKEN(domain, std::nullopt, d.name, d);
+    }
+
+    // tracking stops beyond the limit and a full snapshot is required
+    CHECK(!tokendb.is_tracking_changes());
+    CHECK_THROWS_AS(tokendb.read_changed_tokens([](auto&, auto&&) { return true; }), token_database_exception);
+
+    s.undo();
+    tokendb.reset_changes();
+    CHECK(tokendb.is_tracking_changes());
+}
+
+TEST_CASE("snapshot_merkle_hash_test", "[snapshot]") {
+    auto tokendb = token_database(get_db_config());
+    tokendb.open();
+
+    auto writer1 = std::make_shared<merkle_hash_snapshot_writer>();
+    token_database_snapshot::add_to_snapshot(writer1, tokendb);
+    auto hash1 = writer1->finalize();
+
+    auto writer2 = std::make_shared<merkle_hash_snapshot_writer>();
+    auto pool    = boost::asio::thread_pool(4);
+    token_database_snapshot::add_to_snapshot(writer2, tokendb, &pool);
+    auto hash2 = writer2->finalize();
+
+    // hash doesn't depend on the order sections are written
+    CHECK(hash1 == hash2);
+    CHECK(writer1->section_digests() == writer2->section_digests());
+    CHECK(writer1->section_digests().count("dm-tkdb-test") == 1);
+
+    tokendb.add_savepoint(1);
+
+    auto d = domain_def();
+    d.name = "merkle-domain";
+    PUT_DB_TOKEN(domain, std::nullopt, d.name, d);
+
+    auto writer3 = std::make_shared<merkle_hash_snapshot_writer>();
+    token_database_snapshot::add_to_snapshot(writer3, tokendb, &pool);
+    auto hash3 = writer3->finalize();
+
+    CHECK(hash3 != hash1);
+    CHECK(writer3->section_digests().at(".domain") != writer1->section_digests().at(".domain"));
+    CHECK(writer3->section_digests().at("dm-tkdb-test") == writer1->section_digests().at("dm-tkdb-test"));
+
+    tokendb.rollback_to_latest_savepoint();
+}
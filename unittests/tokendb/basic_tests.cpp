@@ -235,3 +235,65 @@ TEST_CASE_METHOD(tokendb_test, "put_tokens_test", "[tokendb]") {
     CHECK(EXISTS_TOKEN2(token, "dm-tkdb-test", "basic-1"));
     CHECK(EXISTS_TOKEN2(token, "dm-tkdb-test", "basic-2"));
 }
+
+TEST_CASE_METHOD(tokendb_test, "address_index_test", "[tokendb]") {
+    auto cfg          = token_database::config();
+    cfg.db_path       = evt_unittests_dir + "/tokendb_tests/tokendb_address_index";
+    cfg.address_index = true;
+    fc::remove_all(cfg.db_path);
+
+    auto tokendb = token_database(cfg);
+    tokendb.open();
+
+    auto addr  = public_key_type(std::string("EVT8MGU4aKiVzqMtWi9zLpu8KuTHZWjQQrX475ycSxEkLd6aBpraX"));
+    auto addr2 = public_key_type(std::string("EVT6Qz3wuRjyN6gaU3P3XRxpnEZnM4oPxortemaWDwFRvsv2FxgND"));
+    auto read_ids = [&](auto& addr) {
+        auto ids = std::vector<symbol_id_type>();
+        tokendb.read_address_assets(addr, [&](auto& key, auto&& value) {
+            auto id = symbol_id_type();
+            memcpy(&id, key.data(), sizeof(id));
+            ids.emplace_back(id);
+            return true;
+        });
+        return ids;
+    };
+
+    CHECK(tokendb.has_address_index());
+
+    // written into db directly
+    PUT_ASSET(addr, 3, asset::from_string("1.00000 S#3"));
+    PUT_ASSET(addr2, 3, asset::from_string("1.00000 S#3"));
+
+    // written in savepoints
+    tokendb.add_savepoint(1);
+    PUT_ASSET(addr, 1, asset::from_string("1.00000 S#1"));
+    tokendb.add_savepoint(2);
+    PUT_ASSET(addr, 5, asset::from_string("1.00000 S#5"));
+
+    CHECK(read_ids(addr) == std::vector<symbol_id_type>({ 1, 3, 5 }));
+    CHECK(read_ids(addr2) == std::vector<symbol_id_type>({ 3 }));
+
+    tokendb.rollback_to_latest_savepoint();
+    CHECK(read_ids(addr) == std::vector<symbol_id_type>({ 1, 3 }));
+
+    tokendb.pop_savepoints(2);
+    CHECK(read_ids(addr) == std::vector<symbol_id_type>({ 1, 3 }));
+
+    // index is rebuilt when it's enabled again
+    tokendb.close();
+    cfg.address_index = false;
+    {
+        auto tokendb2 = token_database(cfg);
+        tokendb2.open();
+        CHECK(!tokendb2.has_address_index());
+    }
+    cfg.address_index = true;
+    {
+        auto tokendb2 = token_database(cfg);
+        tokendb2.open();
+        CHECK(tokendb2.has_address_index());
+
+        auto n = tokendb2.read_address_assets(addr, [](auto& key, auto&& value) { return true; });
+        CHECK(n == 2);
+    }
+}
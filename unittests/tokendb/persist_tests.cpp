@@ -1,4 +1,25 @@
 #include "tokendb_tests.hpp"
+#include <fstream>
+
+// layouts of savepoints log in version 0
+namespace __legacy {
+
+struct pd_action {
+    uint16_t    op;
+    uint16_t    type;
+    std::string key;
+    std::string value;
+};
+
+struct pd_group {
+    int64_t                seq;
+    std::vector<pd_action> actions;
+};
+
+}  // namespace __legacy
+
+FC_REFLECT(__legacy::pd_action, (op)(type)(key)(value));
+FC_REFLECT(__legacy::pd_group, (seq)(actions));
 
 /*
  * Persist Tests: add token
@@ -296,3 +317,134 @@ TEST_CASE_METHOD(tokendb_test, "squash_prst_rlbk", "[tokendb]") {
     CHECK(!EXISTS_TOKEN(domain, "domain-prst-sq"));
 }
 
+
+/*
+ * Persist Tests: restore from journal after unclean shutdown
+ */
+TEST_CASE_METHOD(tokendb_test, "journal_prst_test", "[tokendb]") {
+    auto basedir = fc::path(evt_unittests_dir + "/tokendb_tests");
+    auto crashed = basedir / "tokendb_crashed";
+    auto cfg     = token_database::config();
+    cfg.db_path  = basedir / "tokendb_journal";
+    fc::remove_all(cfg.db_path);
+    fc::remove_all(crashed);
+
+    auto var = fc::json::from_string(domain_data);
+    auto dom = var.as<domain_def>();
+    dom.creator = key;
+    dom.name = "domain-journal";
+
+    {
+        auto tokendb = token_database(cfg);
+        tokendb.open();
+
+        tokendb.add_savepoint(1);
+        ADD_TOKEN(domain, "domain-jn1", dom);
+        tokendb.add_savepoint(2);
+        ADD_TOKEN(domain, "domain-jn2", dom);
+        tokendb.add_savepoint(3);
+        ADD_TOKEN(domain, "domain-jn3", dom);
+        tokendb.rollback_to_latest_savepoint();
+        tokendb.pop_savepoints(2);
+
+        // copy files while database is still opened, just like the process is killed
+        fc::create_directories(crashed);
+        for(auto it = fc::directory_iterator(cfg.db_path); it != fc::directory_iterator(); it++) {
+            fc::copy(*it, crashed / (*it).filename());
+        }
+    }
+
+    cfg.db_path  = crashed;
+    auto tokendb = token_database(cfg);
+    tokendb.open();
+
+    CHECK(tokendb.savepoints_size() == 1);
+    CHECK(tokendb.latest_savepoint_seq() == 2);
+    CHECK(EXISTS_TOKEN(domain, "domain-jn1"));
+    CHECK(EXISTS_TOKEN(domain, "domain-jn2"));
+    CHECK(!EXISTS_TOKEN(domain, "domain-jn3"));
+
+    tokendb.rollback_to_latest_savepoint();
+    CHECK(EXISTS_TOKEN(domain, "domain-jn1"));
+    CHECK(!EXISTS_TOKEN(domain, "domain-jn2"));
+}
+
+/*
+ * Persist Tests: savepoints log written by version 0, whose values are in db already
+ */
+TEST_CASE_METHOD(tokendb_test, "legacy_prst_test", "[tokendb]") {
+    auto basedir = fc::path(evt_unittests_dir + "/tokendb_tests");
+    auto cfg     = token_database::config();
+    cfg.db_path  = basedir / "tokendb_legacy";
+    fc::remove_all(cfg.db_path);
+
+    auto dom  = name128("legacy-domain");
+    auto t1   = name128("legacy-t1");
+    auto t2   = name128("legacy-t2");
+    auto addr = public_key_type(std::string("EVT8MGU4aKiVzqMtWi9zLpu8KuTHZWjQQrX475ycSxEkLd6aBpraX"));
+
+    auto tk1  = token_def(dom, t1, { address(addr) });
+    auto tk2  = token_def(dom, t2, { address(addr) });
+    auto tk2b = token_def(dom, t2, { address() });
+
+    // token keys in db are domain followed by name
+    auto db_key = [&](const name128& name) {
+        auto k = std::string((const char*)&dom, sizeof(dom));
+        k.append((const char*)&name, sizeof(name));
+        return k;
+    };
+    auto put = [&](auto& tokendb, auto& tk) {
+        auto dv = make_db_value(tk);
+        tokendb.put_token(token_type::token, action_op::put, dom, tk.name, dv.as_string_view());
+    };
+    auto owner_of_t2 = [&](auto& tokendb) {
+        auto tk = token_def();
+        READ_TOKEN2(token, dom, t2, tk);
+        return tk.owner[0];
+    };
+
+    {
+        // writes without savepoints go into db directly, like version 0 did within savepoints
+        auto tokendb = token_database(cfg);
+        tokendb.open();
+        put(tokendb, tk2);
+        put(tokendb, tk1);
+        put(tokendb, tk2b);
+        tokendb.close(false);
+    }
+
+    {
+        auto pds = std::vector<__legacy::pd_group>(1);
+        pds[0].seq = 10;
+        pds[0].actions.emplace_back(__legacy::pd_action { (uint16_t)action_op::add, (uint16_t)token_type::token, db_key(t1), "" });
+
+        auto dv = make_db_value(tk2);
+        pds[0].actions.emplace_back(__legacy::pd_action { (uint16_t)action_op::update, (uint16_t)token_type::token, db_key(t2), std::string(dv.as_string_view()) });
+
+        auto fs = std::ofstream((cfg.db_path / evt::chain::config::token_database_persisit_filename).to_native_ansi_path(), std::ios::binary);
+        fc::raw::pack(fs, int(0));  // dirty flag
+        fc::raw::pack(fs, pds);
+    }
+
+    auto tokendb = token_database(cfg);
+    tokendb.open();
+    REQUIRE(tokendb.savepoints_size() == 1);
+    CHECK(EXISTS_TOKEN2(token, dom, t1));
+    CHECK(owner_of_t2(tokendb) == address());
+
+    // legacy savepoint is kept when persisted again in current version
+    tokendb.close();
+    tokendb.open();
+    REQUIRE(tokendb.savepoints_size() == 1);
+    CHECK(tokendb.latest_savepoint_seq() == 10);
+
+    tokendb.add_savepoint(11);
+    put(tokendb, tk2);
+    tokendb.rollback_to_latest_savepoint();
+    CHECK(owner_of_t2(tokendb) == address());
+
+    // values before legacy savepoint are restored into db
+    tokendb.rollback_to_latest_savepoint();
+    CHECK(!EXISTS_TOKEN2(token, dom, t1));
+    CHECK(owner_of_t2(tokendb) == address(addr));
+}
@@ -236,3 +236,60 @@ TEST_CASE_METHOD(tokendb_test, "squansh_test", "[tokendb]") {
 
     my_tester->produce_block();
 }
+
+TEST_CASE_METHOD(tokendb_test, "write_cache_svpt_test", "[tokendb]") {
+    auto& tokendb = my_tester->control->token_db();
+    my_tester->produce_block();
+
+    auto range_metas = [&] {
+        auto metas = std::vector<std::string>();
+        tokendb.read_tokens_range(token_type::token, name128("domain-wc"), 0, [&](auto& key, auto&& value) {
+            auto tk = token_def();
+            extract_db_value(value, tk);
+            metas.emplace_back((std::string)tk.metas[0].key);
+            return true;
+        });
+        return metas;
+    };
+
+    ADD_SAVEPOINT();
+
+    auto var = fc::json::from_string(token_data);
+    auto tk  = var.as<token_def>();
+    tk.domain = "domain-wc";
+    tk.name   = "wc1";
+    tk.metas[0].key = "v1";
+    PUT_TOKEN2(token, tk.domain, tk.name, tk);
+    tk.name = "wc2";
+    PUT_TOKEN2(token, tk.domain, tk.name, tk);
+    CHECK(range_metas() == std::vector<std::string>({ "v1", "v1" }));
+
+    ADD_SAVEPOINT();
+
+    tk.name = "wc1";
+    tk.metas[0].key = "v2";
+    PUT_TOKEN2(token, tk.domain, tk.name, tk);
+    CHECK(range_metas() == std::vector<std::string>({ "v2", "v1" }));
+
+    ADD_SAVEPOINT();
+
+    tk.metas[0].key = "v3";
+    PUT_TOKEN2(token, tk.domain, tk.name, tk);
+    tokendb.squash();
+
+    auto _tk = token_def();
+    READ_TOKEN2(token, tk.domain, "wc1", _tk);
+    CHECK((std::string)_tk.metas[0].key == "v3");
+
+    // squashed savepoint is rolled back to the version of the first savepoint
+    ROLLBACK();
+    READ_TOKEN2(token, tk.domain, "wc1", _tk);
+    CHECK((std::string)_tk.metas[0].key == "v1");
+    CHECK(range_metas() == std::vector<std::string>({ "v1", "v1" }));
+
+    ROLLBACK();
+    CHECK(!EXISTS_TOKEN2(token, tk.domain, "wc1"));
+    CHECK(range_metas().empty());
+
+    my_tester->produce_block();
+}
@@ -1,6 +1,9 @@
+#include <random>
 #include <catch/catch.hpp>
 
 #include <evt/chain/address.hpp>
+#include <evt/chain/action_receipt.hpp>
+#include <evt/chain/merkle.hpp>
 #include <evt/chain/types.hpp>
 #include <evt/chain/token_database.hpp>
 #include <evt/chain/contracts/authorizer_ref.hpp>
@@ -285,6 +288,70 @@ TEST_CASE("test_name128", "[types]") {
     }
 }
 
+TEST_CASE("test_name_codec", "[types]") {
+    auto name_chars    = std::string(".abcdefghijklmnopqrstuvwxyz12345");
+    auto name128_chars = std::string(".-0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ");
+
+    auto is_valid = [](auto& chars, auto& str) {
+        return str.find_first_not_of(chars) == std::string::npos && str.back() != '.';
+    };
+
+    auto CHECK_NAME = [&](auto& str) {
+        INFO(str);
+        if(is_valid(name_chars, str)) {
+            auto n = name(str);
+            CHECK(n.value == string_to_name(str.c_str()));
+            CHECK(n.to_string() == str);
+        }
+        else {
+            CHECK_THROWS_AS(name(str), name_type_exception);
+        }
+    };
+
+    auto CHECK_NAME128 = [&](auto& str) {
+        INFO(str);
+        if(is_valid(name128_chars, str)) {
+            auto n = name128(str);
+            CHECK(n.value == string_to_name128(str.c_str()));
+            CHECK(n.to_string() == str);
+        }
+        else {
+            CHECK_THROWS_AS(name128(str), name128_type_exception);
+        }
+    };
+
+    // all the one and two bytes strings
+    for(auto i = 1; i < 256; i++) {
+        auto s1 = std::string(1, (char)i);
+        CHECK_NAME(s1);
+        CHECK_NAME128(s1);
+        for(auto j = 1; j < 256; j++) {
+            auto s2 = s1 + (char)j;
+            CHECK_NAME(s2);
+            CHECK_NAME128(s2);
+        }
+    }
+
+    // 13th char of name only has 4 bits
+    CHECK(name("abcdefghijklo").to_string() == "abcdefghijklo");
+    CHECK_THROWS_AS(name("abcdefghijklp"), name_type_exception);
+
+    auto rng = std::mt19937(42);
+    for(auto i = 0; i < 10000; i++) {
+        auto str = std::string(rng() % 12 + 1, '.');
+        for(auto& c : str) {
+            c = name_chars[rng() % name_chars.size()];
+        }
+        CHECK_NAME(str);
+
+        auto str128 = std::string(rng() % 21 + 1, '.');
+        for(auto& c : str128) {
+            c = name128_chars[rng() % name128_chars.size()];
+        }
+        CHECK_NAME128(str128);
+    }
+}
+
 TEST_CASE("test_symbol", "[types]") {
     auto s = symbol(3, 123);
     CHECK((std::string)s == "3,S#123");
@@ -445,3 +512,87 @@ TEST_CASE("test_reflector_init", "[types]") {
     CHECK(trx2.max_charge == 1000);
     CHECK(trx2.actions.size() == 1);
 }
+
+TEST_CASE("test_packed_trx_digests", "[types]") {
+    auto strx = signed_transaction();
+    strx.max_charge = 1000;
+    strx.actions.emplace_back(action(".test", ".test", ".test", bytes(100, 'a')));
+
+    auto hash     = fc::sha256::hash(std::string("test"));
+    auto chain_id = *(chain_id_type*)&hash;
+    strx.sign(private_key_type(std::string("5KQwrPbwdL6PhXujxW37FSSQZ1JiwsST4cqQzDeyXtP79zkvFD3")), chain_id);
+
+    for(auto c : { packed_transaction::none, packed_transaction::zlib }) {
+        auto ptrx  = packed_transaction(strx, c);
+        auto ptrx2 = fc::raw::unpack<packed_transaction>(fc::raw::pack(ptrx));
+
+        for(auto p : { &ptrx, &ptrx2 }) {
+            CHECK(p->id() == strx.id());
+            CHECK(p->sig_digest(chain_id) == strx.sig_digest(chain_id));
+            CHECK(p->get_signature_keys(chain_id) == strx.get_signature_keys(chain_id));
+        }
+    }
+}
+
+TEST_CASE("test_packed_trx_padded_varint", "[types]") {
+    auto strx = signed_transaction();
+    strx.max_charge = 1000;
+    strx.actions.emplace_back(action(".test", ".test", ".test", bytes(100, 'a')));
+
+    auto hash     = fc::sha256::hash(std::string("test"));
+    auto chain_id = *(chain_id_type*)&hash;
+    strx.sign(private_key_type(std::string("5KQwrPbwdL6PhXujxW37FSSQZ1JiwsST4cqQzDeyXtP79zkvFD3")), chain_id);
+
+    // count of actions is right after the header: expiration(4), ref_block_num(2), ref_block_prefix(4), max_charge(4)
+    auto data = fc::raw::pack(static_cast<const transaction&>(strx));
+    REQUIRE(data[14] == 1);
+
+    // overlong encodings of the same count, the last one has high bits dropped by unpack
+    auto paddings = { bytes{ '\x81', '\x00' }, bytes{ '\x81', '\x80', '\x80', '\x80', '\x00' }, bytes{ '\x81', '\x80', '\x80', '\x80', '\x70' } };
+    for(auto& padding : paddings) {
+        auto padded = bytes(data.begin(), data.begin() + 14);
+        padded.insert(padded.end(), padding.begin(), padding.end());
+        padded.insert(padded.end(), data.begin() + 15, data.end());
+
+        auto sigs = strx.signatures;
+        auto ptrx = packed_transaction(std::move(padded), std::move(sigs));
+        CHECK(ptrx.get_transaction().actions.size() == 1);
+        CHECK(ptrx.id() == strx.id());
+        CHECK(ptrx.sig_digest(chain_id) == strx.sig_digest(chain_id));
+        CHECK(ptrx.get_signature_keys(chain_id) == strx.get_signature_keys(chain_id));
+    }
+}
+
+TEST_CASE("test_merkle", "[types]") {
+    // reference of merkle with pairs hashed one by one
+    auto serial_merkle = [](auto ids) {
+        if(ids.empty()) {
+            return digest_type();
+        }
+        while(ids.size() > 1) {
+            if(ids.size() % 2) {
+                ids.push_back(ids.back());
+            }
+            for(auto i = 0u; i < ids.size() / 2; i++) {
+                ids[i] = digest_type::hash(make_canonical_pair(ids[2 * i], ids[2 * i + 1]));
+            }
+            ids.resize(ids.size() / 2);
+        }
+        return ids.front();
+    };
+
+    auto ids = std::vector<digest_type>();
+    for(auto i = 0; i < 70; i++) {
+        CHECK(merkle(ids) == serial_merkle(ids));
+        ids.emplace_back(digest_type::hash(std::to_string(i)));
+    }
+
+    auto receipts = std::vector<action_receipt>();
+    for(auto i = 0u; i < 20; i++) {
+        receipts.emplace_back(action_receipt{ .act_digest = ids[i], .global_sequence = i });
+    }
+    auto digests = digest_type::hash_many(receipts);
+    for(auto i = 0u; i < receipts.size(); i++) {
+        CHECK(digests[i] == receipts[i].digest());
+    }
+}